@@ -1,346 +1,215 @@
 #include <stdio.h>
 #include <stdlib.h>
-#include <pthread.h>
 #include <time.h>
 #include <string.h>
 #include <errno.h>
 #include <limits.h>
 #include <math.h>
-
-#define THREADS 4   //each run the same fn on different parts of array
-// barriers: all threads need to reach it before any can proceed - sync point
-// race cond: to avoid them, e used shared variables using mutexes or barriers (mutexes used inside barriers) 
-    // within barrier, mutexes and conitiional variables(for thread wait/signal) used)
-#define DIGITS  10  //we use 0-9 digits to sort for radix sort
+#include <stdint.h>
+#include <unistd.h>
+#include "../common/radix_core.h"
+#include "../common/radix_ctx.h"
+#include "../common/radix_io.h"
+#include "../common/radix_report.h"
+#include "../common/radix_trace.h"
+#include "../common/radix_topo.h"
+#include "../common/radix_tune.h"
+
+static int threads = RADIX_CTX_DEFAULT_THREADS; //each run the same fn on different parts of array (-t option, 0 = every usable CPU)
+static radix_pin_kind pin_kind = RADIX_PIN_NONE; // -P compact|spread: pin pool thread t to a CPU from /sys/devices/system/cpu
+// the worker pool, its barrier and scratch buffers live in a radix_ctx (common/radix_ctx.c):
+// created once in main, reused by every dataset, so repeated sorts pay no thread startup
+// digits: decimal 0-9 by default, or 8/11/16-bit fields from the shared core (-b option)
 #define ADAPT_THRESHOLD 2000   /* <= n triggers fast sequential path in "parallel" function */
-
-typedef struct {
-    int *arr;   // pointer to the shared data array
-    int start;  
-    int end;    // start and end of indexes for this thread
-    int local_count[DIGITS]; // checks count of how many times 0-9 appear in thread slice (from ones to higher digits)
-    // ex: [123,243,344,456], to check ones: we check last digsit of each number: 3,3,4,6 -> local_count[3]=2, local_count[4]=1, local_count[6]=1
-} ThreadData;
-
-// Shared globals / barrier - used to build custom barrier
-pthread_mutex_t lock;   //mutex for barrier
-pthread_cond_t  cond;   //condition variable for barrier (wait/signal threads)
-int thread_done = 0;    // # of threads that reached the barrier
-int total_threads;      // total # of threads participating in barrier
-
-static int current_exp = 0;   // digit position currently being sorted (1,10,100,...)
-static int done = 0;          // flag telling when to stop workers, so they exit safely
-
-//Barrier (main + workers) - makes sure all threads stay in sync at certain points
-static void barrier_init(int n) {   //initialize barrier for n threads
-    pthread_mutex_init(&lock, NULL); 
-    pthread_cond_init(&cond, NULL);
-    total_threads = n; // sets # of threads that must meet total_threads=n 
-    thread_done = 0; // resets thread_done count
-}
-static void barrier_wait(void){    // purpose: makes sure all the threads reach the same point before continuing
-    // each thread locks the mutex and increments thread_done count
-    pthread_mutex_lock(&lock);
-    thread_done++;
-    if (thread_done >= total_threads) { // if thread is last to arive, reset count and wake all waiting threads
-        thread_done = 0;
-        pthread_cond_broadcast(&cond);
-    } else {
-        pthread_cond_wait(&cond, &lock); // otherwise, wait on the cond variable until last thread wakes everyone
-    }
-    pthread_mutex_unlock(&lock); // ADDED: always unlock (fixes potential deadlock)
-}
-
-// Worker thread 
-static void *worker(void *arg) { // this fn runs with everytime pthread_create is called (making the worker threads)
-    ThreadData *data = (ThreadData *)arg;
-
-    /* Initial handshake so all participants start aligned */
-    barrier_wait();
-
-    for (;;) { // like while(true) - runs until 'done' flag is set
-        /* Phase 1: start-of-pass */
-        barrier_wait(); // wait for main to start the pass (dig position)
-        if (done) break; // exit if flag is set
-        // main thread sets current_exp (dig position) and signals thread to start
-
-        /* Reset local histogram (local_count) */
-        for (int d = 0; d < DIGITS; d++) data->local_count[d] = 0;
-
-        /* Count my slice for this digit */
-        int exp = current_exp;// all threads work on the same digit till they all finish
-        for (int i = data->start; i < data->end; i++) {
-            // start and end is where that specific thread starts (0) and ends (2) as ex
-            // next thread start where the prev ends+1 so 3-6 as ex
-            int digit = (data->arr[i] / exp) % 10; // get the specific digit at curr position
-            data->local_count[digit]++; // specific digit appears local_count[digit] times in this thread slice
-        }
-
-        /* Phase 2: counting complete */
-        barrier_wait(); // wait for all threads to finish counting before next pass (dig position)
-    }
-    return NULL;
-}
+static size_t seq_cutoff = ADAPT_THRESHOLD; // ADAPT_THRESHOLD, or the calibrated one with -u
+
+static int digit_bits = RADIX_DECIMAL; // digit width for every sort (-b option), decimal by default
+static radix_barrier_kind barrier_kind = RADIX_BARRIER_SPIN; // pool barrier (-B option): spin/futex or mutex+condvar
+static radix_scatter_kind scatter_kind = RADIX_SCATTER_DIRECT; // -S wc: scatter through cache-line buffers (sequential and LSD sorts)
+static int use_msd = 0; // -m msd: top-digit partition + work-stealing buckets instead of LSD passes
+static int use_auto = 0; // -m auto: key range + sample pick direct counting, LSD or MSD per dataset
+static int use_inplace = 0; // -m inplace: American flag MSD in the array itself, no n-element scratch buffer
+static int inplace_baseline = 0; // -s: with -m inplace, time the sequential in-place sort on a copy (n more ints)
+static radix_path auto_path = RADIX_PATH_LSD; // current dataset: what -m auto ran
+static radix_tune_profile tune; // -u: profile from tools/radix_tune (threads, cutoff, per-dataset digits and engine)
+static const char *tune_path = NULL;
+static int bits_given = 0, threads_given = 0; // -b / -t win over the profile
+static int tuned_seq = 0; // current dataset: the profile picked the sequential core over the pool
+static radix_bin_mode bin_mode = RADIX_BIN_PRIVATE; // -w: binary datasets are sorted in place in the file
+static radix_report_format log_format = RADIX_REPORT_CSV; // -f: rows appended to the results log
+static const char *log_path = "performance_results_pthread.csv"; // -o
+#ifdef RADIX_TRACE
+static const char *trace_path = NULL; // -T: Chrome trace of the parallel sort of the last dataset
+#endif
 
 // Sequential radix helpers (shared)
-static void seq_counting_sort(int *arr, int n, int exp) {
-    int count[DIGITS] = {0}; // like the local_count but for whole array (global)
-    int *out = (int *)malloc((n > 0 ? n : 1) * sizeof(int)); //temp array to hold sorted values
-    if (!out) { perror("malloc"); exit(1); }
-
-    //Let’s say arr = [329, 457, 657, 839, 436] and exp = 1 (ones place).
-    for (int i = 0; i < n; i++) { 
-        int digit = (arr[i] / exp) % 10; //
-        count[digit]++;
-    } 
-    for (int d = 1; d < DIGITS; d++) count[d] += count[d - 1];
-
-    for (int i = n - 1; i >= 0; i--) {
-        int digit = (arr[i] / exp) % 10;
-        out[--count[digit]] = arr[i];
-    }
-    for (int i = 0; i < n; i++) arr[i] = out[i];
-    free(out);
+// One pass from arr into out; count already holds this digit's histogram of the whole array
+// (like the local_count but global), taken for every pass in one read before the first one
+// wc: staging lines of the write-combining scatter (-S wc), NULL writes every key directly
+static void seq_counting_sort(const int *arr, int *out, int n, const radix_plan *p, int pass, size_t *count, void *wc) {
+    //Let’s say arr = [329, 457, 657, 839, 436] and pass = 0 (ones place): prefix sum, stable placement
+    radix_pass_counted32((const uint32_t *)arr, (uint32_t *)out, n, p, pass, radix_pass_flags(p, pass), count, wc);
 }
 
-static void sequential_radix_inplace(int *arr, int n) {
-    if (n <= 1) return;
-
-    /* Shift negatives, track max */
-    int min = INT_MAX, mx = INT_MIN;
-    for (int i = 0; i < n; i++) {
-        if (arr[i] < min) min = arr[i];
-        if (arr[i] > mx)  mx  = arr[i];
-    }
-    int shift = 0;
-    if (min < 0) {
-        shift = -min;
-        for (int i = 0; i < n; i++) arr[i] += shift;
-        mx += shift;
-    }
-
-    for (int exp = 1; mx / exp > 0; exp *= 10)
-        seq_counting_sort(arr, n, exp);
-
-    if (shift) {
-        for (int i = 0; i < n; i++) arr[i] -= shift;
-    }
-}
-
-static double time_sequential_radix(const int *src, int n) {
+// mx: largest value, known from the loader
+static double time_sequential_radix(const int *src, int n, int mx) {
     if (n <= 1) return 0.0;
 
+    radix_plan p;
+    radix_plan_init(&p, RADIX_I32, digit_bits, radix_key32(RADIX_I32, (uint32_t)mx));
+
+    // Both buffers and the counts are allocated once; the passes swap them instead of copying back
     int *arr = (int *)malloc(n * sizeof(int));
-    if (!arr) { perror("malloc"); exit(1); }
+    int *tmp = (int *)malloc(n * sizeof(int));
+    size_t *hist = (size_t *)calloc((size_t)p.passes * p.buckets + 1, sizeof(size_t)); // one row per pass
+    void *wc = scatter_kind == RADIX_SCATTER_WC ? radix_wc_alloc(p.buckets, 1) : NULL;
+    if (!arr || !tmp || !hist || (scatter_kind == RADIX_SCATTER_WC && !wc)) { perror("malloc"); exit(1); }
     for (int i = 0; i < n; i++) arr[i] = src[i];
 
-    int min = INT_MAX, mx = INT_MIN;
-    for (int i = 0; i < n; i++) {
-        if (arr[i] < min) min = arr[i];
-        if (arr[i] > mx)  mx  = arr[i];
-    }
-    int shift = 0;
-    if (min < 0) {
-        shift = -min;
-        for (int i = 0; i < n; i++) arr[i] += shift;
-        mx += shift;
-    }
-
     struct timespec t1, t2;
     clock_gettime(CLOCK_MONOTONIC, &t1);
 
-    for (int exp = 1; mx / exp > 0; exp *= 10)
-        seq_counting_sort(arr, n, exp);
+    // every digit counted in one read; a digit that is the same in every key needs no pass
+    radix_histogram_all32((const uint32_t *)arr, 0, n, &p, RADIX_PASS_FIRST, hist);
+    radix_plan_skip_trivial(&p, hist, n);
+
+    int *from = arr, *to = tmp;
+    for (int pass = 0; pass < p.passes; pass++) {
+        if (radix_pass_skipped(&p, pass)) continue;
+        seq_counting_sort(from, to, n, &p, pass, hist + (size_t)pass * p.buckets, wc);
+        int *t = from; from = to; to = t;
+    }
+    if (from != arr) memcpy(arr, from, n * sizeof(int));   // odd pass count: one copy at the end
 
     clock_gettime(CLOCK_MONOTONIC, &t2);
     double secs = (t2.tv_sec - t1.tv_sec) + (t2.tv_nsec - t1.tv_nsec) / 1e9;
 
     free(arr);
+    free(tmp);
+    free(hist);
+    free(wc);
     return secs;
 }
 
-/* ---------- Parallel radix (persistent THREADS workers) ---------- */
-static void radix_sort_parallel(int *arr, int n) {
-    if (n <= 1) return;
-
-    /* === Adaptive trick: for tiny n, skip threads entirely === */
-    if (n <= ADAPT_THRESHOLD) {
-        sequential_radix_inplace(arr, n);
-        return;
-    }
-
-    /* Reset stop flag for this run (important across multiple datasets) */
-    done = 0;
-
-    /* Shift negatives to non-negative */
-    int min = INT_MAX;
-    for (int i = 0; i < n; i++)
-        if (arr[i] < min) min = arr[i];
-    if (min < 0)
-        for (int i = 0; i < n; i++) arr[i] -= min;
-
-    /* Find maximum */
-    int max = (n > 0 ? arr[0] : 0);
-    for (int i = 1; i < n; i++)
-        if (arr[i] > max) max = arr[i];
-
-    /* Start workers once; barrier participants = THREADS + 1 (main) */
-    barrier_init(THREADS + 1);
-
-    pthread_t threads[THREADS];
-    ThreadData tds[THREADS];
-
-    /* Balanced work partition (base + remainder) */
-    int base = n / THREADS;
-    int rem  = n % THREADS;
-    for (int t = 0; t < THREADS; t++) {
-        int start = t * base + (t < rem ? t : rem);
-        int end   = start + base + (t < rem ? 1 : 0);
-        if (start > n) start = n;
-        if (end   > n) end   = n;
-
-        tds[t].arr   = arr;
-        tds[t].start = start;
-        tds[t].end   = end;
-
-        pthread_create(&threads[t], NULL, worker, &tds[t]);
-    }
-
-    /* Initial handshake: join workers' first barrier_wait() */
-    barrier_wait();
-
-    int *output = (int *)malloc(n * sizeof(int));
-    if (!output) { perror("malloc"); exit(1); }
-
-    /* Passes: two barriers per pass (start / finish) */
-    for (current_exp = 1; max / current_exp > 0; current_exp *= 10) {
-        /* Phase 1: start pass */
-        barrier_wait();
-
-        /* Phase 2: wait for all workers to finish counting */
-        barrier_wait();
-
-        /* Merge all thread-local histograms */
-        int global_count[DIGITS] = {0};
-        int total_seen = 0; // ADDED: sanity check accumulator
-
-        for (int t = 0; t < THREADS; t++)
-            for (int d = 0; d < DIGITS; d++)
-                global_count[d] += tds[t].local_count[d];
-
-        // ADDED: verify the merged histogram equals n (detects bad slices or missed counts)
-        for (int d = 0; d < DIGITS; d++) total_seen += global_count[d];
-        if (total_seen != n) {
-            fprintf(stderr, "ERROR: histogram sum %d != n %d (exp=%d)\n",
-                    total_seen, n, current_exp);
-            // Optional: dump slices or per-thread counts here
-            exit(1);
-        }
-
-        /* Prefix sums */
-        for (int d = 1; d < DIGITS; d++)
-            global_count[d] += global_count[d - 1];
-
-        /* Stable placement (single-threaded placement) */
-        for (int i = n - 1; i >= 0; i--) {
-            int digit = (arr[i] / current_exp) % 10;
-            output[--global_count[digit]] = arr[i];
-        }
+// -m inplace -s: the same in-place sort on one thread, on a copy (the pool sorts arr afterwards)
+static double time_sequential_inplace(const int *src, int n) {
+    int *arr = (int *)malloc((n > 0 ? n : 1) * sizeof(int));
+    if (!arr) { perror("malloc"); exit(1); }
+    memcpy(arr, src, n * sizeof(int));
 
-        /* Copy back */
-        for (int i = 0; i < n; i++) arr[i] = output[i];
-    }
+    struct timespec t1, t2;
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    if (radix_sort_inplace(arr, n, RADIX_I32, digit_bits) != 0) { fprintf(stderr, "radix_sort_inplace failed\n"); exit(1); }
+    clock_gettime(CLOCK_MONOTONIC, &t2);
 
-    /* Tell workers to exit and release them */
-    done = 1;
-    barrier_wait(); /* wake workers to see 'done' and break */
+    free(arr);
+    return (t2.tv_sec - t1.tv_sec) + (t2.tv_nsec - t1.tv_nsec) / 1e9;
+}
 
-    for (int t = 0; t < THREADS; t++)
-        pthread_join(threads[t], NULL);
+// -m auto, counting path: the same counting sort on one thread, so the speedup compares like with like
+static double time_sequential_counting(const int *src, int n, uint64_t min_key, uint64_t max_key) {
+    int *arr = (int *)malloc((n > 0 ? n : 1) * sizeof(int));
+    if (!arr) { perror("malloc"); exit(1); }
+    memcpy(arr, src, n * sizeof(int));
 
-    free(output);
-    pthread_mutex_destroy(&lock);
-    pthread_cond_destroy(&cond);
+    struct timespec t1, t2;
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    if (radix_count_sort(arr, n, RADIX_I32, min_key, max_key) != 0) { fprintf(stderr, "radix_count_sort failed\n"); exit(1); }
+    clock_gettime(CLOCK_MONOTONIC, &t2);
 
-    /* Restore negatives */
-    if (min < 0)
-        for (int i = 0; i < n; i++) arr[i] += min;
+    free(arr);
+    return (t2.tv_sec - t1.tv_sec) + (t2.tv_nsec - t1.tv_nsec) / 1e9;
 }
 
-/* ---------- File loader ---------- */
-static int *read_input(const char *filename, int *n) {
-    FILE *f = fopen(filename, "r");
-    if (!f) { perror("open"); return NULL; }
-    int cap = 1024, cnt = 0;
-    int *arr = (int *)malloc(cap * sizeof(int));
-    if (!arr) { perror("malloc"); fclose(f); return NULL; }
-    while (1) {
-        int v;
-        if (fscanf(f, "%d", &v) != 1) break;
-        if (cnt == cap) {
-            cap *= 2;
-            int *tmp = (int *)realloc(arr, cap * sizeof(int));
-            if (!tmp) { perror("realloc"); free(arr); fclose(f); return NULL; }
-            arr = tmp;
-        }
-        arr[cnt++] = v;
+/* ---------- Parallel radix (persistent pool in a radix_ctx) ---------- */
+static void radix_sort_parallel(radix_ctx *ctx, int *arr, int n, int mn, int mx) {
+    /* n <= seq_cutoff skips the threads inside the context */
+    /* mn/mx come from the loader, so the LSD path skips its own max scan and -m auto its min/max scan */
+    uint64_t minmax[2] = { radix_key32(RADIX_I32, (uint32_t)mn), radix_key32(RADIX_I32, (uint32_t)mx) };
+    int rc = tuned_seq ? (use_inplace ? radix_sort_inplace(arr, n, RADIX_I32, digit_bits) : radix_sort(arr, n, RADIX_I32, digit_bits))
+           : use_auto ? radix_ctx_sort_auto(ctx, arr, n, RADIX_I32, digit_bits, minmax, &auto_path)
+           : use_msd ? radix_ctx_sort_msd(ctx, arr, n, RADIX_I32, digit_bits)
+           : use_inplace ? radix_ctx_sort_inplace(ctx, arr, n, RADIX_I32, digit_bits)
+                     : radix_ctx_sort_bounded(ctx, arr, n, RADIX_I32, digit_bits,
+                                              radix_key32(RADIX_I32, (uint32_t)mx));
+    if (rc != 0) {
+        fprintf(stderr, "%s failed (n=%d)\n", use_auto ? "radix_ctx_sort_auto" : use_msd ? "radix_ctx_sort_msd"
+                : use_inplace ? "radix_ctx_sort_inplace" : "radix_ctx_sort", n);
+        exit(1);
     }
-    fclose(f);
-    *n = cnt;
-    return arr;
 }
 
-/* ---------- NEW: load sequential time from seq_output.txt ---------- */
-// ADDED: looks up a dataset name in seq_output.txt (same folder) and returns its time.
-// Format per line: "<filename> <time>" e.g. "input_small_100.txt 0.000008"
-static int load_seq_time_from_file(const char *dataset_name, double *out_time) {
-    FILE *f = fopen("seq_output.txt", "r");
-    if (!f) {
-        // If the file doesn't exist, just say "not found".
-        return 0;
-    }
-
-    char name[256];
-    double t;
-    int found = 0;
-
-    // Read lines: each scanf tries to get "<string> <double>"
-    while (fscanf(f, "%255s %lf", name, &t) == 2) {
-        if (strcmp(name, dataset_name) == 0) {
-            *out_time = t;
-            found = 1;
-            break;
-        }
-    }
-
-    fclose(f);
-    return found; // 1 if found, 0 otherwise
+/* ---------- File loader ---------- */
+// .txt: mmap + parallel chunk parse, .bin: mapped as is (common/radix_io.c); min/max in ds->stats
+static int *read_input(const char *filename, int *n, radix_dataset *ds) {
+    if (radix_dataset_open(ds, filename, bin_mode, threads) != 0) { perror("open"); return NULL; }
+    *n = (int)ds->stats.n;
+    return ds->data;
 }
 
 /* ---------- One dataset run (prints + logs) ---------- */
-static void run_dataset(FILE *log, const char *filename) {
+static void run_dataset(FILE *log, radix_ctx *ctx, const char *filename) {
     printf("\n[Dataset: %s]\n", filename);
 
     int n = 0;
-    int *arr = read_input(filename, &n);
+    radix_dataset ds;
+    int *arr = read_input(filename, &n, &ds);
     if (!arr) {
         printf("Skipping (cannot open/read).\n");
         return;
     }
 
-    /* Sequential timing: now prefer reading from seq_output.txt */
-    double seq_time;
-    if (!load_seq_time_from_file(filename, &seq_time)) { // ADDED: file-based lookup
-        // Fallback if the dataset isn't in seq_output.txt:
-        seq_time = time_sequential_radix(arr, n);        // still have a correct value
+    /* First touch: the pool copies the data into a fresh array, every thread its own slice, so the
+       pages of a slice get allocated on the node of the thread that sorts it (pinned with -P).
+       -m inplace sorts the loaded values where they are: that copy is the memory it saves */
+    int *loaded = arr;
+    if ((size_t)n > seq_cutoff && !use_inplace) {
+        int *placed = (int *)malloc(n * sizeof(int));
+        if (placed) {
+            radix_ctx_first_touch(ctx, placed, loaded, n, sizeof(int));
+            arr = placed;
+        }
+    }
+
+    /* -u: digits (unless -b was given) and engine for this size and key range */
+    int saved_bits = digit_bits;
+    tuned_seq = 0;
+    if (tune_path) {
+        const radix_tune_entry *e = radix_tune_pick(&tune, (size_t)n,
+            radix_tune_range_bits(radix_key32(RADIX_I32, (uint32_t)ds.stats.min), radix_key32(RADIX_I32, (uint32_t)ds.stats.max)));
+        if (e) {
+            if (!bits_given) digit_bits = e->bits;
+            tuned_seq = e->backend == RADIX_TUNE_SEQ && (size_t)n > seq_cutoff;
+            printf("Tuned:           %s, %d-bit digits (profile entry n <= %zu, %d-bit key range)\n",
+                   tuned_seq || (size_t)n <= seq_cutoff ? "sequential core" : "pool", digit_bits, e->max_n, e->range_bits);
+        }
     }
 
+    /* Sequential timing: measured here, on this machine and this data (no stored times).
+       -m inplace keeps nothing but the input in memory, so its baseline (a copy) needs -s.
+       -m auto picks its path from the loader's min/max, so a counting run is timed against a counting sort */
+    uint64_t min_key = radix_key32(RADIX_I32, (uint32_t)ds.stats.min), max_key = radix_key32(RADIX_I32, (uint32_t)ds.stats.max);
+    int seq_counting = use_auto && !tuned_seq && n > 1
+                    && radix_choose_path(arr, n, RADIX_I32, digit_bits, min_key, max_key, NULL) == RADIX_PATH_COUNTING;
+    int seq_run = !use_inplace || inplace_baseline;
+    double seq_time = seq_counting ? time_sequential_counting(arr, n, min_key, max_key)
+                    : !use_inplace ? time_sequential_radix(arr, n, ds.stats.max)
+                    : inplace_baseline ? time_sequential_inplace(arr, n) : 0.0;
+
     /* Parallel timing (with adaptive early-out for tiny n) */
+#ifdef RADIX_TRACE
+    radix_trace_reset(); // only the parallel sort is traced
+#endif
     struct timespec t1, t2;
     clock_gettime(CLOCK_MONOTONIC, &t1);
-    radix_sort_parallel(arr, n);
+    auto_path = RADIX_PATH_LSD;
+    radix_sort_parallel(ctx, arr, n, ds.stats.min, ds.stats.max);
     clock_gettime(CLOCK_MONOTONIC, &t2);
     double par_time = (t2.tv_sec - t1.tv_sec) + (t2.tv_nsec - t1.tv_nsec) / 1e9;
+#ifdef RADIX_TRACE
+    radix_trace_summary(stdout); // per-thread time in every phase (barrier = blocked waiting)
+    if (trace_path && radix_trace_dump(trace_path) != 0) perror(trace_path);
+#endif
 
     /* Output (avoid printing huge arrays) */
     if (n <= 100) {
@@ -350,48 +219,175 @@ static void run_dataset(FILE *log, const char *filename) {
     } else {
         printf("Sorted %d integers.\n", n);
     }
+    int lsd_run = use_auto ? auto_path == RADIX_PATH_LSD : !use_msd && !use_inplace;
+    if (use_auto && !tuned_seq)
+        printf("Path:            %s (%lld key values)\n", radix_path_name(auto_path),
+               (long long)ds.stats.max - ds.stats.min + 1);
+    if (lsd_run && !tuned_seq && (size_t)n > seq_cutoff) {
+        int run, skipped;
+        radix_ctx_pass_stats(ctx, &run, &skipped);
+        printf("Digit passes:    %d run, %d skipped (same digit in every key)\n", run, skipped);
+    }
 
     /* CLI metrics */
     double Sx = (par_time > 0.0) ? (seq_time / par_time) : 0.0;
-    double E  = (THREADS > 0) ? (Sx / THREADS) : 0.0;
-    double alpha = (THREADS > 1) ? ((Sx - 1.0) / (THREADS - 1.0)) : 0.0;
-
-    printf("Sequential time (from file or fallback): %.6f s\n", seq_time);
-    printf("Parallel time:                           %.6f s\n", par_time);
-    printf("Speedup:                                 %.2fx\n", Sx);
-    printf("Efficiency:                              %.2f\n", E);
-
-    /* Log file */
-    fprintf(log, "==== Dataset: %s ====\n", filename);
-    fprintf(log, "N: %d\n", n);
-    fprintf(log, "Sequential time: %.6f s\n", seq_time);
-    fprintf(log, "Parallel time:   %.6f s\n", par_time);
-    fprintf(log, "Speedup (S):     %.2fx\n", Sx);
-    fprintf(log, "Efficiency (E):  %.2f\n", E);
-    fprintf(log, "Amdahl’s α:      %.2f\n", alpha);
-    fprintf(log, "--------------------------------------------\n\n");
+    int par_threads = tuned_seq ? 1 : radix_ctx_threads(ctx);
+    double E  = Sx / par_threads;
+
+    if (seq_run) {
+        printf("Sequential time: %.6f s\n", seq_time);
+        printf("Parallel time:   %.6f s\n", par_time);
+        printf("Speedup:         %.2fx\n", Sx);
+        printf("Efficiency:      %.2f\n", E);
+    } else {
+        printf("Sequential time: not measured (-s times it on a copy)\n");
+        printf("Parallel time:   %.6f s\n", par_time);
+    }
 
-    free(arr);
+    /* Log file: one row per engine (single run each; tools/radix_bench does repetitions) */
+    int wc_run = scatter_kind == RADIX_SCATTER_WC; // -S wc rows get their own backend names (MSD partitions stay direct)
+    radix_report_row row = { "pthreads", seq_counting ? "seq-counting" : use_inplace ? "seq-inplace" : wc_run ? "seq-wc" : "seq", filename, (size_t)n,
+                             sizeof(int), 1, digit_bits, 1, { seq_time, seq_time, seq_time, seq_time }, 1.0, 0, { 0 }, 0 };
+    if (seq_run) radix_report_write(log, log_format, &row);
+    row.backend = use_inplace ? "pthreads-inplace"
+                : !lsd_run ? (auto_path == RADIX_PATH_COUNTING ? "pthreads-counting" : "pthreads-msd")
+                : wc_run ? "pthreads-wc" : "pthreads";
+    row.threads = par_threads;
+    row.t       = (radix_time_stats){ par_time, par_time, par_time, par_time };
+    row.speedup = Sx;
+    radix_report_write(log, log_format, &row);
+
+    if (arr != loaded) {
+        if (ds.mapped && bin_mode == RADIX_BIN_INPLACE) memcpy(loaded, arr, n * sizeof(int)); // -w: the file gets the sorted values
+        free(arr);
+    }
+    radix_dataset_close(&ds);
+    digit_bits = saved_bits;
 }
 
 /* ---------- Main driver ---------- */
-int main(void) {
-    FILE *log = fopen("performance_results_pthread.txt", "a");
+int main(int argc, char *argv[]) {
+    // ADDED: optional digit width, e.g. "./pthreads -b 8" (0 = decimal, default)
+    //        and barrier kind, e.g. "./pthreads -B mutex" to compare against the spin/futex barrier
+    //        and sort order, e.g. "./pthreads -m msd" or "-m auto" to pick per dataset (default lsd),
+    //        or "-m inplace" to sort without the second n-element buffer (its sequential baseline needs -s)
+    //        and scatter, e.g. "./pthreads -S wc" to stage keys in cache-line buffers (default direct)
+    //        and thread count / pinning, e.g. "./pthreads -t 0 -P spread" (default 4 threads, unpinned)
+    //        and dataset files, e.g. "./pthreads -w input_mixed_1000000.bin" (default: the input_*.txt list)
+    //        and the results log, e.g. "./pthreads -f json -o results.jsonl" (default: CSV rows in performance_results_pthread.csv)
+    //        and a tuning profile, e.g. "./pthreads -u radix_tune.profile" (threads, cutoff, digits per dataset)
+    //        and, in a -DRADIX_TRACE build, a Chrome trace file, e.g. "./pthreads -T trace.json"
+    int opt;
+    while ((opt = getopt(argc, argv, "b:B:m:sS:t:P:u:wf:o:T:")) != -1) {
+        if (opt == 'b') {
+            digit_bits = atoi(optarg);
+            bits_given = 1;
+            if (digit_bits != RADIX_DECIMAL && digit_bits != 8 && digit_bits != 11 && digit_bits != 16) {
+                fprintf(stderr, "digit bits must be 0 (decimal), 8, 11 or 16\n");
+                return 1;
+            }
+        } else if (opt == 'B') {
+            if (radix_barrier_parse(optarg, &barrier_kind) != 0) {
+                fprintf(stderr, "barrier must be 'spin' or 'mutex'\n");
+                return 1;
+            }
+        } else if (opt == 'm') {
+            use_msd = use_auto = use_inplace = 0;
+            if (strcmp(optarg, "msd") == 0)          use_msd = 1;
+            else if (strcmp(optarg, "auto") == 0)    use_auto = 1;
+            else if (strcmp(optarg, "inplace") == 0) use_inplace = 1;
+            else if (strcmp(optarg, "lsd") != 0) { fprintf(stderr, "mode must be 'lsd', 'msd', 'auto' or 'inplace'\n"); return 1; }
+        } else if (opt == 's') {
+            inplace_baseline = 1;
+        } else if (opt == 'S') {
+            if (radix_scatter_parse(optarg, &scatter_kind) != 0) {
+                fprintf(stderr, "scatter must be 'direct' or 'wc'\n");
+                return 1;
+            }
+        } else if (opt == 't') {
+            threads = atoi(optarg);
+            if (threads < 0) { fprintf(stderr, "threads must be >= 0 (0 = every usable CPU)\n"); return 1; }
+            if (threads == 0) threads = radix_topo_cpus();
+            threads_given = 1;
+        } else if (opt == 'u') {
+            tune_path = optarg;
+        } else if (opt == 'P') {
+            if (radix_pin_parse(optarg, &pin_kind) != 0) {
+                fprintf(stderr, "pinning must be 'none', 'compact' or 'spread'\n");
+                return 1;
+            }
+        } else if (opt == 'w') {
+            bin_mode = RADIX_BIN_INPLACE;
+        } else if (opt == 'f') {
+            if (radix_report_parse_format(optarg, &log_format) != 0) {
+                fprintf(stderr, "log format must be 'csv' or 'json'\n");
+                return 1;
+            }
+        } else if (opt == 'o') {
+            log_path = optarg;
+        } else if (opt == 'T') {
+#ifdef RADIX_TRACE
+            trace_path = optarg;
+#else
+            fprintf(stderr, "-T needs a build with -DRADIX_TRACE (and common/radix_trace.c)\n");
+            return 1;
+#endif
+        } else {
+            fprintf(stderr, "Usage: %s [-b 0|8|11|16] [-B spin|mutex] [-m lsd|msd|auto|inplace] [-s] [-S direct|wc] [-t threads] [-P none|compact|spread] [-u profile] [-w] [-f csv|json] [-o log] [-T trace.json] [dataset ...]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    if (tune_path) {
+        if (radix_tune_load(tune_path, &tune) != 0) { perror(tune_path); return 1; }
+        if (!threads_given) threads = tune.threads;
+        seq_cutoff = tune.seq_cutoff;
+        printf("Profile: %s (%d entries, calibrated on %d CPU(s)), sequential up to n = %zu\n",
+               tune_path, tune.count, tune.cpus, seq_cutoff);
+    }
+
+    FILE *log = radix_report_open(log_path, log_format); // CSV/JSON rows, appended run after run
     if (!log) { perror("open log"); return 1; }
 
-    time_t now = time(NULL);
-    char *dt = ctime(&now);
-    if (dt && dt[strlen(dt)-1] == '\n') dt[strlen(dt)-1] = '\0';
-    fprintf(log, "============================================\n");
-    fprintf(log, "Run Timestamp: %s\n", dt ? dt : "(unknown time)");
-    fprintf(log, "Threads used: %d\n", THREADS);
-    fprintf(log, "Adaptive threshold: n <= %d uses sequential path\n", ADAPT_THRESHOLD);
-    fprintf(log, "============================================\n\n");
+    radix_set_scatter(scatter_kind); // the pool's LSD passes pick it up at every sort
+    printf("Threads: %d, barrier: %s, mode: %s, scatter: %s, ", threads, radix_barrier_name(barrier_kind),
+           use_auto ? "auto" : use_msd ? "MSD" : use_inplace ? "in-place MSD" : "LSD", radix_scatter_name(scatter_kind));
+    if (digit_bits == RADIX_DECIMAL) printf("digits: decimal (base 10)\n");
+    else                             printf("digits: %d-bit (base %u)\n", digit_bits, 1u << digit_bits);
+
+    /* One pool for the whole run: 'threads' participants (main included) */
+    radix_ctx_config cfg;
+    radix_ctx_config_init(&cfg);
+    cfg.threads    = threads;
+    cfg.seq_cutoff = seq_cutoff;
+    cfg.barrier    = barrier_kind;
+    cfg.pin        = pin_kind;
+    radix_ctx *ctx = radix_ctx_create(&cfg);
+    if (!ctx) { fprintf(stderr, "radix_ctx_create failed\n"); fclose(log); return 1; }
+    if (pin_kind != RADIX_PIN_NONE) {
+        if (radix_ctx_cpu(ctx, 0) < 0) {
+            printf("Pinning: CPU topology not readable, threads left unpinned\n");
+        } else {
+            printf("Pinning: %s over %d CPU(s) in %d package(s), CPU per thread:", radix_pin_name(pin_kind),
+                   radix_topo_cpus(), radix_topo_packages());
+            for (int t = 0; t < radix_ctx_threads(ctx); t++) printf(" %d", radix_ctx_cpu(ctx, t));
+            printf("\n");
+        }
+    }
+
+    /* 0) Datasets named on the command line (.txt or .bin) replace the default list */
+    if (optind < argc) {
+        for (int i = optind; i < argc; ++i) run_dataset(log, ctx, argv[i]);
+        radix_ctx_destroy(ctx);
+        fclose(log);
+        printf("\nResults appended to %s\n", log_path);
+        return 0;
+    }
 
     /* 1) Classic 20-int inputs first (if present) */
     const char *classic[] = {"input_small.txt", "input_medium.txt", "input_large.txt"};
     int classic_count = (int)(sizeof(classic) / sizeof(classic[0])); // ADDED: compute number of classic datasets
-    for (int i = 0; i < classic_count; ++i) run_dataset(log, classic[i]);
+    for (int i = 0; i < classic_count; ++i) run_dataset(log, ctx, classic[i]);
 
     /* 2) Scaled datasets: input_<label>_<size>.txt */
     // CHANGED: instead of generating many small/medium/large files,
@@ -404,10 +400,11 @@ int main(void) {
 
     int scaled_count = (int)(sizeof(scaled) / sizeof(scaled[0])); // ADDED
     for (int i = 0; i < scaled_count; ++i) {
-        run_dataset(log, scaled[i]); // ADDED
+        run_dataset(log, ctx, scaled[i]); // ADDED
     }
 
+    radix_ctx_destroy(ctx);
     fclose(log);
-    printf("\nFull report saved to performance_results_pthread.txt\n");
+    printf("\nResults appended to %s\n", log_path);
     return 0;
 }
@@ -0,0 +1,140 @@
+// radix_barrier.c - mutex/condvar barrier and sense-reversing spin/futex barrier
+#include <string.h>
+#include <sched.h>
+#include <limits.h>
+#include <unistd.h>
+#include "radix_barrier.h"
+
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+
+// Spin rounds before parking in the kernel. Round r pauses min(2^r, 64) times,
+// about 700 pauses in total: enough to catch a balanced pass, short enough not
+// to burn a core while the pool idles between sorts.
+#define SPIN_ROUNDS 16
+
+static inline void cpu_relax(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    __asm__ __volatile__("yield");
+#endif
+}
+
+/* ---------- Futex (Linux) / yield fallback ---------- */
+static void sense_sleep(atomic_int *word, int seen) {
+#ifdef __linux__
+    // Returns at once if *word != seen, so a flip between the check and the call is not lost
+    syscall(SYS_futex, (int *)word, FUTEX_WAIT_PRIVATE, seen, NULL, NULL, 0);
+#else
+    (void)word; (void)seen;
+    sched_yield();
+#endif
+}
+
+static void sense_wake(atomic_int *word) {
+#ifdef __linux__
+    syscall(SYS_futex, (int *)word, FUTEX_WAKE_PRIVATE, INT_MAX, NULL, NULL, 0);
+#else
+    (void)word;
+#endif
+}
+
+/* ---------- Barrier ---------- */
+int radix_barrier_init(radix_barrier *b, radix_barrier_kind kind, int parties) {
+    memset(b, 0, sizeof(*b));
+    b->kind    = kind;
+    b->parties = parties;
+    if (kind == RADIX_BARRIER_MUTEX) {
+        if (pthread_mutex_init(&b->lock, NULL) != 0) return -1;
+        if (pthread_cond_init(&b->cond, NULL) != 0) { pthread_mutex_destroy(&b->lock); return -1; }
+        return 0;
+    }
+    // With more parties than online CPUs a spinner only delays the thread it waits for
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    b->spin_rounds = (cpus > 0 && parties > cpus) ? 0 : SPIN_ROUNDS;
+    atomic_init(&b->remaining, parties);
+    atomic_init(&b->sense, 0);
+    atomic_init(&b->sleepers, 0);
+    return 0;
+}
+
+// Last arrival: re-arm the count for the next round, then flip the sense
+static void spin_open(radix_barrier *b) {
+    atomic_store_explicit(&b->remaining, b->parties, memory_order_relaxed);
+    atomic_fetch_add_explicit(&b->sense, 1, memory_order_seq_cst);
+    if (atomic_load_explicit(&b->sleepers, memory_order_seq_cst) > 0)
+        sense_wake(&b->sense);
+}
+
+void radix_barrier_wait(radix_barrier *b) {
+    if (b->kind == RADIX_BARRIER_MUTEX) {
+        pthread_mutex_lock(&b->lock);
+        unsigned long gen = b->generation;
+        if (++b->arrived >= b->parties) {  // last to arrive resets the count and wakes everyone
+            b->arrived = 0;
+            b->generation++;
+            pthread_cond_broadcast(&b->cond);
+        } else {
+            while (gen == b->generation)
+                pthread_cond_wait(&b->cond, &b->lock);
+        }
+        pthread_mutex_unlock(&b->lock);
+        return;
+    }
+
+    int sense = atomic_load_explicit(&b->sense, memory_order_acquire);
+    if (atomic_fetch_sub_explicit(&b->remaining, 1, memory_order_acq_rel) == 1) {
+        spin_open(b);
+        return;
+    }
+
+    // Spin with exponential backoff, then sleep on the sense word
+    for (int round = 0; ; round++) {
+        if (atomic_load_explicit(&b->sense, memory_order_acquire) != sense) return;
+        if (round < b->spin_rounds) {
+            int pauses = 1 << (round < 6 ? round : 6);
+            for (int i = 0; i < pauses; i++) cpu_relax();
+        } else {
+            atomic_fetch_add_explicit(&b->sleepers, 1, memory_order_seq_cst);
+            sense_sleep(&b->sense, sense);
+            atomic_fetch_sub_explicit(&b->sleepers, 1, memory_order_relaxed);
+        }
+    }
+}
+
+void radix_barrier_drop(radix_barrier *b, int count) {
+    if (b->kind == RADIX_BARRIER_MUTEX) {
+        pthread_mutex_lock(&b->lock);
+        b->parties -= count;
+        if (b->arrived > 0 && b->arrived >= b->parties) {
+            b->arrived = 0;
+            b->generation++;
+            pthread_cond_broadcast(&b->cond);
+        }
+        pthread_mutex_unlock(&b->lock);
+        return;
+    }
+    b->parties -= count;
+    int left = atomic_fetch_sub_explicit(&b->remaining, count, memory_order_acq_rel) - count;
+    if (left == 0 && b->parties > 0) spin_open(b);
+}
+
+void radix_barrier_destroy(radix_barrier *b) {
+    if (b->kind == RADIX_BARRIER_MUTEX) {
+        pthread_mutex_destroy(&b->lock);
+        pthread_cond_destroy(&b->cond);
+    }
+}
+
+const char *radix_barrier_name(radix_barrier_kind kind) {
+    return kind == RADIX_BARRIER_SPIN ? "spin" : "mutex";
+}
+
+int radix_barrier_parse(const char *name, radix_barrier_kind *kind) {
+    if (strcmp(name, "mutex") == 0) { *kind = RADIX_BARRIER_MUTEX; return 0; }
+    if (strcmp(name, "spin") == 0)  { *kind = RADIX_BARRIER_SPIN;  return 0; }
+    return -1;
+}
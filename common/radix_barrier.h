@@ -0,0 +1,40 @@
+// radix_barrier.h - reusable thread barriers for the radix worker pool
+#ifndef RADIX_BARRIER_H
+#define RADIX_BARRIER_H
+
+#include <pthread.h>
+#include <stdatomic.h>
+
+typedef enum {
+    RADIX_BARRIER_MUTEX,   // mutex + condition variable: every wait takes the lock, the last one broadcasts
+    RADIX_BARRIER_SPIN     // sense-reversing spin with backoff, falls back to a futex sleep
+} radix_barrier_kind;
+
+typedef struct {
+    radix_barrier_kind kind;
+    int parties;                 // threads that must arrive before the barrier opens
+
+    // RADIX_BARRIER_MUTEX
+    pthread_mutex_t lock;
+    pthread_cond_t  cond;
+    int arrived;
+    unsigned long generation;
+
+    // RADIX_BARRIER_SPIN - the sense word flips (increments) each time the barrier opens
+    int spin_rounds;                  // 0 when oversubscribed: go straight to the futex
+    _Alignas(64) atomic_int remaining;
+    _Alignas(64) atomic_int sense;    // also the futex word
+    atomic_int sleepers;              // waiters parked in the kernel, so the opener knows to wake them
+} radix_barrier;
+
+int  radix_barrier_init(radix_barrier *b, radix_barrier_kind kind, int parties);
+void radix_barrier_wait(radix_barrier *b);
+// 'count' participants leave for good (e.g. a worker that failed to start).
+void radix_barrier_drop(radix_barrier *b, int count);
+void radix_barrier_destroy(radix_barrier *b);
+
+const char *radix_barrier_name(radix_barrier_kind kind);
+// "mutex" or "spin" -> kind. Returns -1 for anything else.
+int radix_barrier_parse(const char *name, radix_barrier_kind *kind);
+
+#endif
@@ -0,0 +1,100 @@
+// radix_bin.c - read (mmap) and write the binary dataset format
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "radix_bin.h"
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__
+#error "radix_bin maps values directly and needs a little-endian host"
+#endif
+
+_Static_assert(sizeof(radix_bin_header) == RADIX_BIN_HEADER_SIZE, "header layout");
+
+void radix_bin_header_init(radix_bin_header *h, radix_key_type type, size_t n, const uint64_t minmax[2]) {
+    memset(h, 0, sizeof(*h));
+    memcpy(h->magic, RADIX_BIN_MAGIC, 8);
+    h->version = RADIX_BIN_VERSION;
+    h->type    = (uint32_t)type;
+    h->count   = n;
+    if (minmax) {
+        h->flags |= RADIX_BIN_HAS_MINMAX;
+        h->min = minmax[0];
+        h->max = minmax[1];
+    }
+}
+
+size_t radix_bin_check(const radix_bin_header *h, uint64_t file_bytes) {
+    if (memcmp(h->magic, RADIX_BIN_MAGIC, 8) != 0 || h->version != RADIX_BIN_VERSION ||
+        h->type > RADIX_F64 || file_bytes < RADIX_BIN_HEADER_SIZE)
+        return 0;
+    size_t elem = (size_t)radix_key_width((radix_key_type)h->type) / 8;
+    return h->count <= (file_bytes - RADIX_BIN_HEADER_SIZE) / elem ? elem : 0;
+}
+
+int radix_bin_probe(const char *path) {
+    char magic[8];
+    FILE *fp = fopen(path, "rb");
+    if (!fp) return 0;
+    int ok = fread(magic, 1, sizeof(magic), fp) == sizeof(magic) &&
+             memcmp(magic, RADIX_BIN_MAGIC, sizeof(magic)) == 0;
+    fclose(fp);
+    return ok;
+}
+
+int radix_bin_open(radix_bin_file *f, const char *path, radix_bin_mode mode) {
+    memset(f, 0, sizeof(*f));
+    int fd = open(path, mode == RADIX_BIN_INPLACE ? O_RDWR : O_RDONLY);
+    if (fd < 0) return -1;
+
+    struct stat sb;
+    if (fstat(fd, &sb) != 0) { int e = errno; close(fd); errno = e; return -1; }
+    size_t size = (size_t)sb.st_size;
+    if (size < RADIX_BIN_HEADER_SIZE) { close(fd); errno = EINVAL; return -1; }
+
+    // PROT_WRITE on a private mapping is fine for a read-only fd: writes stay in this process
+    int flags = mode == RADIX_BIN_INPLACE ? MAP_SHARED : MAP_PRIVATE;
+    void *m = mmap(NULL, size, PROT_READ | PROT_WRITE, flags, fd, 0);
+    close(fd);
+    if (m == MAP_FAILED) return -1;
+
+    memcpy(&f->hdr, m, sizeof(f->hdr));
+    size_t elem = radix_bin_check(&f->hdr, size);
+    if (elem == 0) {
+        munmap(m, size);
+        errno = EINVAL;
+        return -1;
+    }
+
+    f->map       = m;
+    f->map_bytes = size;
+    f->data      = (char *)m + RADIX_BIN_HEADER_SIZE;
+    f->mode      = mode;
+    madvise(f->data, f->hdr.count * elem, MADV_SEQUENTIAL);
+    return 0;
+}
+
+int radix_bin_close(radix_bin_file *f) {
+    if (!f->map) return 0;
+    int rc = 0;
+    if (f->mode == RADIX_BIN_INPLACE && msync(f->map, f->map_bytes, MS_SYNC) != 0) rc = -1;
+    munmap(f->map, f->map_bytes);
+    f->map = f->data = NULL;
+    return rc;
+}
+
+int radix_bin_write(const char *path, radix_key_type type, const void *data, size_t n,
+                    const uint64_t minmax[2]) {
+    radix_bin_header h;
+    radix_bin_header_init(&h, type, n, minmax);
+
+    FILE *fp = fopen(path, "wb");
+    if (!fp) return -1;
+    size_t elem = (size_t)radix_key_width(type) / 8;
+    int ok = fwrite(&h, sizeof(h), 1, fp) == 1 && fwrite(data, elem, n, fp) == n;
+    if (fclose(fp) != 0) ok = 0;
+    return ok ? 0 : -1;
+}
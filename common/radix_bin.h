@@ -0,0 +1,66 @@
+// radix_bin.h - binary dataset format: fixed header + raw little-endian values, sorted through mmap
+#ifndef RADIX_BIN_H
+#define RADIX_BIN_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "radix_core.h"
+
+// File layout (all fields little-endian):
+//   0  magic "RADIXBIN"
+//   8  version (1)            u32
+//  12  type (radix_key_type)  u32
+//  16  count                  u64
+//  24  flags                  u32   RADIX_BIN_HAS_MINMAX
+//  28  reserved               u32
+//  32  min, max               u64   raw bits of the smallest / largest element,
+//                                   zero-extended for 4-byte types
+//  48  zero padding up to 64, then count values
+#define RADIX_BIN_MAGIC        "RADIXBIN"
+#define RADIX_BIN_VERSION      1
+#define RADIX_BIN_HEADER_SIZE  64      // keeps the values 64-byte aligned in the mapping
+#define RADIX_BIN_HAS_MINMAX   1u
+
+typedef struct {
+    char     magic[8];
+    uint32_t version;
+    uint32_t type;
+    uint64_t count;
+    uint32_t flags;
+    uint32_t reserved;
+    uint64_t min, max;
+    uint8_t  pad[RADIX_BIN_HEADER_SIZE - 48];
+} radix_bin_header;
+
+typedef enum {
+    RADIX_BIN_PRIVATE,   // MAP_PRIVATE: sorting touches copy-on-write pages, the file is unchanged
+    RADIX_BIN_INPLACE    // MAP_SHARED: the sorted values are written back to the file
+} radix_bin_mode;
+
+typedef struct {
+    radix_bin_header hdr;
+    void  *data;          // hdr.count values, sortable in place
+    void  *map;
+    size_t map_bytes;
+    radix_bin_mode mode;
+} radix_bin_file;
+
+// Fills a header for n values of 'type'. minmax (raw bits {min, max}) may be NULL.
+void radix_bin_header_init(radix_bin_header *h, radix_key_type type, size_t n, const uint64_t minmax[2]);
+
+// Bytes per value if *h is a valid header of a file of 'file_bytes' bytes, 0 otherwise.
+size_t radix_bin_check(const radix_bin_header *h, uint64_t file_bytes);
+
+// 1 if 'path' starts with the magic, 0 otherwise (also when it cannot be read).
+int radix_bin_probe(const char *path);
+
+// Maps 'path'. Returns 0, or -1 with errno set (EINVAL: bad magic, version, type or size).
+int  radix_bin_open(radix_bin_file *f, const char *path, radix_bin_mode mode);
+// Unmaps; an in-place file is synced to disk first. Returns -1 if the sync fails.
+int  radix_bin_close(radix_bin_file *f);
+
+// Writes n values of 'type'. minmax (raw bits {min, max}) may be NULL.
+int radix_bin_write(const char *path, radix_key_type type, const void *data, size_t n,
+                    const uint64_t minmax[2]);
+
+#endif
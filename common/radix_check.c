@@ -0,0 +1,91 @@
+// radix_check.c - qsort reference and streaming fingerprint behind the tools' result checks
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include "radix_check.h"
+
+/* ---------- Against qsort ---------- */
+// One comparator per key type (qsort has no context argument), all by radix key
+#define CMP_KEY(name, T, key)                                   \
+    static int name(const void *a, const void *b) {             \
+        T x = key(*(const T *)a), y = key(*(const T *)b);       \
+        return (x > y) - (x < y);                               \
+    }
+#define KEY_U32(v) radix_key32(RADIX_U32, v)
+#define KEY_I32(v) radix_key32(RADIX_I32, v)
+#define KEY_F32(v) radix_key32(RADIX_F32, v)
+#define KEY_U64(v) radix_key64(RADIX_U64, v)
+#define KEY_I64(v) radix_key64(RADIX_I64, v)
+#define KEY_F64(v) radix_key64(RADIX_F64, v)
+CMP_KEY(cmp_u32, uint32_t, KEY_U32)
+CMP_KEY(cmp_i32, uint32_t, KEY_I32)
+CMP_KEY(cmp_f32, uint32_t, KEY_F32)
+CMP_KEY(cmp_u64, uint64_t, KEY_U64)
+CMP_KEY(cmp_i64, uint64_t, KEY_I64)
+CMP_KEY(cmp_f64, uint64_t, KEY_F64)
+
+static int (*const cmp_key[])(const void *, const void *) = {   // indexed by radix_key_type
+    cmp_u32, cmp_i32, cmp_f32, cmp_u64, cmp_i64, cmp_f64
+};
+
+void radix_check_qsort(void *a, size_t n, radix_key_type type) {
+    qsort(a, n, (size_t)radix_key_width(type) / 8, cmp_key[type]);
+}
+
+int radix_check_sorted(const void *in, const void *out, size_t n, radix_key_type type) {
+    size_t bytes = n * (size_t)(radix_key_width(type) / 8);
+    void *ref = malloc(bytes ? bytes : 1);
+    if (!ref) { errno = ENOMEM; return -1; }
+    memcpy(ref, in, bytes);
+    radix_check_qsort(ref, n, type);
+    int differ = memcmp(ref, out, bytes) != 0;
+    free(ref);
+    return differ;
+}
+
+/* ---------- Streaming ---------- */
+// splitmix64 finalizer: every input bit moves about half the output bits
+static inline uint64_t mix64(uint64_t x) {
+    x ^= x >> 30; x *= 0xbf58476d1ce4e5b9ull;
+    x ^= x >> 27; x *= 0x94d049bb133111ebull;
+    return x ^ (x >> 31);
+}
+
+void radix_check_sum_init(radix_check_sum *s, radix_key_type type) {
+    memset(s, 0, sizeof(*s));
+    s->type = type;
+}
+
+void radix_check_sum_add(radix_check_sum *s, const void *a, size_t n) {
+    uint64_t sum = s->sum, mix = s->mix, last = s->last;
+    int down = 0;
+    if (radix_key_width(s->type) == 32) {
+        const uint32_t *v = a;
+        for (size_t i = 0; i < n; i++) {
+            uint64_t k = radix_key32(s->type, v[i]);
+            sum += v[i];
+            mix += mix64(v[i]);
+            down |= k < last;
+            last = k;
+        }
+    } else {
+        const uint64_t *v = a;
+        for (size_t i = 0; i < n; i++) {
+            uint64_t k = radix_key64(s->type, v[i]);
+            sum += v[i];
+            mix += mix64(v[i]);
+            down |= k < last;
+            last = k;
+        }
+    }
+    s->n += n;
+    s->sum = sum;
+    s->mix = mix;
+    s->last = last;
+    s->unordered |= down;
+}
+
+int radix_check_sum_compare(const radix_check_sum *in, const radix_check_sum *out) {
+    return out->unordered || out->type != in->type || out->n != in->n
+        || out->sum != in->sum || out->mix != in->mix;
+}
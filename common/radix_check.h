@@ -0,0 +1,38 @@
+// radix_check.h - reference checks for the tools: results against qsort of a copy, and a
+// streaming fingerprint for outputs too large to hold twice
+#ifndef RADIX_CHECK_H
+#define RADIX_CHECK_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "radix_core.h"
+
+/* ---------- Against qsort ---------- */
+// Sorts a[0, n) with qsort in the order the radix engines give: by radix_key32/64, so
+// floats order as -NaN < -inf < ... < -0.0 < +0.0 < ... < +inf < +NaN.
+void radix_check_qsort(void *a, size_t n, radix_key_type type);
+
+// 0 if out[0, n) holds in[0, n) sorted, 1 if not, -1 with errno = ENOMEM. Compares with
+// radix_check_qsort of a copy, so a sorted result that lost or changed values fails too.
+int radix_check_sorted(const void *in, const void *out, size_t n, radix_key_type type);
+
+/* ---------- Streaming ---------- */
+// Count and an order-independent fingerprint of the values added, plus whether they came
+// in order. Fed with the input and with the output one piece at a time, it tells that the
+// output is the input sorted without a second copy in memory.
+typedef struct {
+    radix_key_type type;
+    uint64_t n;
+    uint64_t sum;        // sum of the raw bits
+    uint64_t mix;        // sum of a hash of the raw bits: a changed value rarely keeps both sums
+    uint64_t last;       // key of the last value added (0 before the first: no key is smaller)
+    int unordered;       // a key was smaller than the one before it
+} radix_check_sum;
+
+void radix_check_sum_init(radix_check_sum *s, radix_key_type type);
+// Adds a[0, n) after the values added so far.
+void radix_check_sum_add(radix_check_sum *s, const void *a, size_t n);
+// 0 if 'out' came in order and has the count and fingerprint of 'in', 1 otherwise.
+int  radix_check_sum_compare(const radix_check_sum *in, const radix_check_sum *out);
+
+#endif
@@ -0,0 +1,321 @@
+// radix_core.c - digit plans, per-pass kernels and the sequential LSD engine
+#include <stdlib.h>
+#include <string.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+#include "radix_core.h"
+
+/* ---------- Digit plan ---------- */
+int radix_plan_init(radix_plan *p, radix_key_type type, int bits, uint64_t max_key) {
+    memset(p, 0, sizeof(*p));
+    p->type  = type;
+    p->width = radix_key_width(type);
+    p->bits  = bits;
+
+    // Transform masks (see radix_in32 / radix_out32)
+    uint64_t sign = 1ull << (p->width - 1);
+    if (type == RADIX_I32 || type == RADIX_I64) p->smask = sign;
+    if (type == RADIX_F32 || type == RADIX_F64) { p->smask = sign; p->fmask = sign - 1; }
+
+    if (bits == RADIX_DECIMAL) {
+        p->buckets = 10;
+        int places = (p->width == 32) ? 10 : 20;   // 10^9 / 10^19 are the last places a key has
+        uint64_t place = 1;
+        for (int d = 0; d < places; d++) {
+            p->pow10[d] = place;
+            if (max_key / place > 0) p->passes = d + 1;
+            if (d < places - 1) place *= 10;
+        }
+        return 0;
+    }
+
+    if (bits != 8 && bits != 11 && bits != 16) return -1;
+    p->buckets = 1u << bits;
+    p->mask    = p->buckets - 1;
+
+    int width = 0;                           // number of significant bits in max_key
+    while (width < p->width && (max_key >> width) != 0) width++;
+    p->passes = (width + bits - 1) / bits;
+    return 0;
+}
+
+int radix_plan_skip_trivial(radix_plan *p, const size_t *hist, size_t n) {
+    int skipped = 0;
+    for (int pass = 0; pass < p->passes; pass++) {
+        const size_t *row = hist + (size_t)pass * p->buckets;
+        for (uint32_t d = 0; d < p->buckets; d++) {
+            if (row[d] == 0) continue;
+            if (row[d] == n) { p->skip |= 1ull << pass; skipped++; }
+            break;                           // first non-empty bucket decides
+        }
+    }
+    return skipped;
+}
+
+/* ---------- Write-combining scatter ---------- */
+static radix_scatter_kind scatter_kind = RADIX_SCATTER_DIRECT;
+
+void radix_set_scatter(radix_scatter_kind kind) { scatter_kind = kind; }
+radix_scatter_kind radix_get_scatter(void) { return scatter_kind; }
+
+const char *radix_scatter_name(radix_scatter_kind kind) {
+    return kind == RADIX_SCATTER_WC ? "wc" : "direct";
+}
+
+int radix_scatter_parse(const char *name, radix_scatter_kind *kind) {
+    if (strcmp(name, "direct") == 0) { *kind = RADIX_SCATTER_DIRECT; return 0; }
+    if (strcmp(name, "wc") == 0)     { *kind = RADIX_SCATTER_WC;     return 0; }
+    return -1;
+}
+
+size_t radix_wc_bytes(uint32_t buckets) {
+    size_t bytes = (size_t)buckets * (RADIX_WC_LINE + sizeof(size_t));
+    return (bytes + RADIX_WC_LINE - 1) / RADIX_WC_LINE * RADIX_WC_LINE;
+}
+
+void *radix_wc_alloc(uint32_t buckets, int count) {
+    return aligned_alloc(RADIX_WC_LINE, radix_wc_bytes(buckets) * (size_t)(count > 0 ? count : 1));
+}
+
+// One full staged line (both pointers RADIX_WC_LINE aligned) to dst, bypassing the cache
+// where SSE2 streaming stores exist.
+static inline void radix_wc_stream(void *dst, const void *line) {
+#ifdef __SSE2__
+    const __m128i *s = (const __m128i *)line;
+    __m128i *d = (__m128i *)dst;
+    for (int i = 0; i < RADIX_WC_LINE / 16; i++) _mm_stream_si128(d + i, _mm_load_si128(s + i));
+#else
+    memcpy(dst, line, RADIX_WC_LINE);
+#endif
+}
+
+// Streaming stores are weakly ordered: fence them before another thread may read dst.
+static inline void radix_wc_fence(void) {
+#ifdef __SSE2__
+    _mm_sfence();
+#endif
+}
+
+/* ---------- SIMD kernels ---------- */
+#include "radix_simd.inc"
+
+/* ---------- Kernels ---------- */
+// Same code for both key widths; the decimal / bit-field split is made outside
+// the loops so the hot loops stay branch-free.
+#define RK_W      32
+#define RK_T      uint32_t
+#define RK_FN(f)  f##32
+#include "radix_kernels.inc"
+#undef RK_W
+#undef RK_T
+#undef RK_FN
+
+#define RK_W      64
+#define RK_T      uint64_t
+#define RK_FN(f)  f##64
+#include "radix_kernels.inc"
+#undef RK_W
+#undef RK_T
+#undef RK_FN
+
+/* ---------- Sequential engine ---------- */
+int radix_sort(void *a, size_t n, radix_key_type type, int bits) {
+    return radix_sort_scratch(a, NULL, n, type, bits);
+}
+
+int radix_sort_scratch(void *a, void *scratch, size_t n, radix_key_type type, int bits) {
+    if (radix_key_width(type) == 32)
+        return lsd_sort32((uint32_t *)a, (uint32_t *)scratch, NULL, n, type, bits);
+    return lsd_sort64((uint64_t *)a, (uint64_t *)scratch, NULL, n, type, bits);
+}
+
+int radix_sort_pairs(void *keys, uint32_t *values, size_t n, radix_key_type type, int bits) {
+    if (radix_key_width(type) == 32)
+        return lsd_sort32((uint32_t *)keys, NULL, values, n, type, bits);
+    return lsd_sort64((uint64_t *)keys, NULL, values, n, type, bits);
+}
+
+int radix_sort_inplace(void *a, size_t n, radix_key_type type, int bits) {
+    if (radix_key_width(type) == 32)
+        return flag_sort_all32((uint32_t *)a, n, type, bits);
+    return flag_sort_all64((uint64_t *)a, n, type, bits);
+}
+
+/* ---------- Direct counting sort ---------- */
+int radix_count_sort(void *a, size_t n, radix_key_type type, uint64_t min_key, uint64_t max_key) {
+    if (n <= 1) return 0;
+    if (radix_key_width(type) == 32)
+        return count_sort32((uint32_t *)a, n, type, (uint32_t)min_key, (uint32_t)max_key);
+    return count_sort64((uint64_t *)a, n, type, min_key, max_key);
+}
+
+/* ---------- Strategy ---------- */
+const char *radix_path_name(radix_path path) {
+    return path == RADIX_PATH_COUNTING ? "counting" : path == RADIX_PATH_MSD ? "msd" : "lsd";
+}
+
+radix_path radix_choose_path(const void *a, size_t n, radix_key_type type, int bits,
+                             uint64_t min_key, uint64_t max_key, double *top_share) {
+    if (top_share) *top_share = 0;
+    uint64_t span = max_key - min_key;
+    if (max_key >= min_key && span < n && span < RADIX_COUNT_MAX_RANGE) return RADIX_PATH_COUNTING;
+
+    // LSD passes left after the digits every key shares are skipped
+    int varying = 0;
+    while (varying < 64 && ((min_key ^ max_key) >> varying) != 0) varying++;
+    int passes;
+    if (bits == RADIX_DECIMAL) {
+        passes = 0;
+        for (uint64_t k = max_key; k != 0; k /= 10) passes++;
+    } else {
+        passes = (varying + bits - 1) / bits;
+    }
+
+    // Top digit of key - min_key, 'top' bits wide, over a strided sample
+    int spread = 0;
+    while (spread < 64 && (span >> spread) != 0) spread++;
+    int top = bits == RADIX_DECIMAL ? 8 : bits;
+    if (top > spread) top = spread;
+    int shift = spread - top;
+    size_t step = n > RADIX_SAMPLE ? n / RADIX_SAMPLE : 1, taken = 0, largest = 0;
+    size_t *h = NULL;
+    if (n > 0 && (h = calloc((size_t)1 << top, sizeof(size_t))) != NULL) {
+        int wide = radix_key_width(type) == 64;
+        for (size_t i = 0; i < n && taken < RADIX_SAMPLE; i += step, taken++) {
+            uint64_t k = wide ? radix_key64(type, ((const uint64_t *)a)[i])
+                              : radix_key32(type, ((const uint32_t *)a)[i]);
+            if (k < min_key || k > max_key) continue;   // bounds too tight: left out
+            size_t d = (size_t)((k - min_key) >> shift);
+            if (++h[d] > largest) largest = h[d];
+        }
+        free(h);
+    }
+    double share = taken ? (double)largest / (double)taken : 1.0;
+    if (top_share) *top_share = share;
+    return n > RADIX_SAMPLE && passes >= 3 && share <= 0.25 ? RADIX_PATH_MSD : RADIX_PATH_LSD;
+}
+
+/* ---------- Segmented sort ---------- */
+size_t radix_segments_max(const size_t *offsets, size_t segments) {
+    size_t largest = 0;
+    for (size_t i = 0; i < segments; i++)
+        if (offsets[i + 1] - offsets[i] > largest) largest = offsets[i + 1] - offsets[i];
+    return largest;
+}
+
+int radix_sort_segments(void *a, const size_t *offsets, size_t segments, radix_key_type type, int bits) {
+    radix_plan plan;
+    if (radix_plan_init(&plan, type, bits, radix_key_max(type)) != 0) return -1;
+    size_t largest = radix_segments_max(offsets, segments);
+    if (largest <= 1) return 0;
+
+    size_t elem = (size_t)plan.width / 8;
+    void   *scratch = malloc(largest * elem);
+    size_t *hist    = malloc((size_t)plan.passes * plan.buckets * sizeof(size_t));
+    if (!scratch || !hist) { free(scratch); free(hist); return -1; }
+    for (size_t i = 0; i < segments; i++) {
+        size_t lo = offsets[i], n = offsets[i + 1] - lo;
+        if (plan.width == 32) radix_sort_segment32((uint32_t *)a + lo, scratch, n, &plan, hist);
+        else                  radix_sort_segment64((uint64_t *)a + lo, scratch, n, &plan, hist);
+    }
+    free(scratch);
+    free(hist);
+    return 0;
+}
+
+/* ---------- Selection ---------- */
+void radix_select_plan(radix_plan *p, radix_key_type type, uint64_t min_key, uint64_t max_key,
+                       uint64_t *prefix) {
+    radix_plan_init(p, type, RADIX_SELECT_BITS, min_key ^ max_key);
+    int low = p->passes * p->bits;             // bits the digits cover
+    *prefix = low >= 64 ? 0 : min_key & ~((1ull << low) - 1);
+}
+
+size_t radix_select_bucket(const size_t *rows, int threads, uint32_t buckets, size_t *k,
+                           size_t *at, uint32_t *d) {
+    size_t below = 0, kept = 0;
+    uint32_t b = 0;
+    for (; b < buckets; b++) {
+        kept = 0;
+        for (int t = 0; t < threads; t++) kept += rows[(size_t)t * buckets + b];
+        if (*k < below + kept) break;
+        below += kept;
+    }
+    *k -= below;
+    *d = b;
+    if (at) {
+        size_t slot = 0;
+        for (int t = 0; t < threads; t++) {
+            at[t] = slot;
+            slot += rows[(size_t)t * buckets + b];
+        }
+    }
+    return kept;
+}
+
+int radix_select_key(const void *a, size_t n, radix_key_type type, size_t k, uint64_t *key) {
+    if (k >= n) return -1;
+    if (radix_key_width(type) == 32) {
+        uint32_t key32;
+        if (select_key32((const uint32_t *)a, n, type, k, &key32) != 0) return -1;
+        *key = key32;
+        return 0;
+    }
+    return select_key64((const uint64_t *)a, n, type, k, key);
+}
+
+int radix_select(const void *a, size_t n, radix_key_type type, size_t k, void *out) {
+    uint64_t key;
+    if (radix_select_key(a, n, type, k, &key) != 0) return -1;
+    if (radix_key_width(type) == 32) *(uint32_t *)out = radix_raw32(type, (uint32_t)key);
+    else                             *(uint64_t *)out = radix_raw64(type, key);
+    return 0;
+}
+
+int radix_topk(const void *a, size_t n, radix_key_type type, size_t k, int largest, void *out) {
+    if (k > n) return -1;
+    if (k == 0) return 0;
+    uint64_t t;
+    if (radix_select_key(a, n, type, largest ? n - k : k - 1, &t) != 0) return -1;
+    radix_plan plan;
+    radix_plan_init(&plan, type, 8, 0);        // key transform only
+    size_t taken = radix_key_width(type) == 32
+                 ? radix_take32((const uint32_t *)a, 0, n, &plan, (uint32_t)t, largest, (uint32_t *)out, k)
+                 : radix_take64((const uint64_t *)a, 0, n, &plan, t, largest, (uint64_t *)out, k);
+    if (radix_sort(out, taken, type, 11) != 0) return -1;
+    radix_topk_finish(out, taken, k, type, t, largest);
+    return 0;
+}
+
+void radix_topk_finish(void *out, size_t taken, size_t k, radix_key_type type, uint64_t t, int largest) {
+    if (radix_key_width(type) == 32) {
+        uint32_t *o = out, x = radix_raw32(type, (uint32_t)t);
+        for (size_t i = 0; largest && i < taken / 2; i++) {
+            uint32_t s = o[i]; o[i] = o[taken - 1 - i]; o[taken - 1 - i] = s;
+        }
+        for (size_t i = taken; i < k; i++) o[i] = x;
+    } else {
+        uint64_t *o = out, x = radix_raw64(type, t);
+        for (size_t i = 0; largest && i < taken / 2; i++) {
+            uint64_t s = o[i]; o[i] = o[taken - 1 - i]; o[taken - 1 - i] = s;
+        }
+        for (size_t i = taken; i < k; i++) o[i] = x;
+    }
+}
+
+int radix_argsort(const void *keys, uint32_t *perm, size_t n, radix_key_type type, int bits) {
+    radix_plan plan;
+    if (radix_plan_init(&plan, type, bits, 0) != 0 || n > UINT32_MAX) return -1;
+
+    // Sort a copy of the keys with the identity permutation riding along
+    size_t bytes = n * (size_t)(radix_key_width(type) / 8);
+    void *copy = malloc(bytes ? bytes : 1);
+    if (!copy) return -1;
+    memcpy(copy, keys, bytes);
+    for (size_t i = 0; i < n; i++) perm[i] = (uint32_t)i;
+
+    int rc = radix_sort_pairs(copy, perm, n, type, bits);
+    free(copy);
+    return rc;
+}
@@ -0,0 +1,417 @@
+// radix_core.h - shared LSD radix core used by the sequential, OpenMP and pthreads programs
+#ifndef RADIX_CORE_H
+#define RADIX_CORE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* ---------- Key types ---------- */
+// Every element type is sorted as an unsigned key of the same width. The key is
+// the raw bit pattern with the sign bit flipped (signed integers) or, for IEEE-754
+// floats, all bits flipped when negative and only the sign bit when positive.
+// That mapping is monotonic, so no separate "shift by -min" pass is needed.
+// Floats order as -NaN < -inf < ... < -0.0 < +0.0 < ... < +inf < +NaN.
+typedef enum {
+    RADIX_U32, RADIX_I32, RADIX_F32,   // 4-byte elements
+    RADIX_U64, RADIX_I64, RADIX_F64    // 8-byte elements
+} radix_key_type;
+
+static inline int radix_key_width(radix_key_type t) { return t >= RADIX_U64 ? 64 : 32; }
+
+// Raw bits -> key (used to turn a known min/max into key space without touching the array).
+static inline uint32_t radix_key32(radix_key_type t, uint32_t raw) {
+    if (t == RADIX_I32) return raw ^ 0x80000000u;
+    if (t == RADIX_F32) return (raw & 0x80000000u) ? ~raw : raw ^ 0x80000000u;
+    return raw;
+}
+static inline uint64_t radix_key64(radix_key_type t, uint64_t raw) {
+    if (t == RADIX_I64) return raw ^ 0x8000000000000000ull;
+    if (t == RADIX_F64) return (raw & 0x8000000000000000ull) ? ~raw : raw ^ 0x8000000000000000ull;
+    return raw;
+}
+
+// Key -> raw bits (inverse of radix_key32/64).
+static inline uint32_t radix_raw32(radix_key_type t, uint32_t key) {
+    if (t == RADIX_I32) return key ^ 0x80000000u;
+    if (t == RADIX_F32) return (key & 0x80000000u) ? key ^ 0x80000000u : ~key;
+    return key;
+}
+static inline uint64_t radix_raw64(radix_key_type t, uint64_t key) {
+    if (t == RADIX_I64) return key ^ 0x8000000000000000ull;
+    if (t == RADIX_F64) return (key & 0x8000000000000000ull) ? key ^ 0x8000000000000000ull : ~key;
+    return key;
+}
+
+/* ---------- Digit plan ---------- */
+// A plan says how a key is cut into digits: either the classic decimal places
+// (1, 10, 100, ...) or fixed-width bit fields pulled out with shift-and-mask.
+#define RADIX_DECIMAL      0            /* digit_bits value selecting base-10 digits */
+#define RADIX_MAX_BITS     16
+#define RADIX_MAX_BUCKETS  (1u << RADIX_MAX_BITS)
+
+typedef struct {
+    radix_key_type type;
+    int      width;      // key width in bits (32 or 64)
+    int      bits;       // RADIX_DECIMAL, 8, 11 or 16
+    uint32_t buckets;    // 10 for decimal, otherwise 1 << bits
+    uint32_t mask;       // buckets - 1 (power-of-two digits only)
+    int      passes;     // digit positions needed to cover the largest key
+    uint64_t smask;      // key = raw ^ (smask | (raw negative ? fmask : 0))
+    uint64_t fmask;
+    uint64_t pow10[20];  // decimal place value of every pass
+    uint64_t skip;       // bit k set: every key has the same digit at position k, pass k is not run
+} radix_plan;
+
+// Fills *p for keys of 'type' in [0, max_key] (no pass skipped). Returns -1 if bits is not 0, 8, 11 or 16.
+int radix_plan_init(radix_plan *p, radix_key_type type, int bits, uint64_t max_key);
+
+// Largest key of 'type': a plan built for it covers every digit position of the key.
+static inline uint64_t radix_key_max(radix_key_type t) {
+    return radix_key_width(t) == 32 ? UINT32_MAX : UINT64_MAX;
+}
+
+// hist holds the digit histograms of all n keys, one row of p->buckets per pass
+// (radix_histogram_all). Marks in p->skip every pass whose keys all fall in one bucket:
+// scattering it would not move anything. Returns the number of passes skipped.
+int radix_plan_skip_trivial(radix_plan *p, const size_t *hist, size_t n);
+
+static inline int radix_pass_skipped(const radix_plan *p, int pass) { return (int)((p->skip >> pass) & 1); }
+
+// Passes left to run after skipping.
+static inline int radix_plan_passes_run(const radix_plan *p) {
+    int run = 0;
+    for (int pass = 0; pass < p->passes; pass++) run += !radix_pass_skipped(p, pass);
+    return run;
+}
+
+// Digit of 'key' at position 'pass' (0 = least significant).
+static inline uint32_t radix_digit32(const radix_plan *p, uint32_t key, int pass) {
+    if (p->bits == RADIX_DECIMAL)
+        return (uint32_t)((key / (uint32_t)p->pow10[pass]) % 10u);
+    return (key >> (pass * p->bits)) & p->mask;
+}
+static inline uint32_t radix_digit64(const radix_plan *p, uint64_t key, int pass) {
+    if (p->bits == RADIX_DECIMAL)
+        return (uint32_t)((key / p->pow10[pass]) % 10u);
+    return (uint32_t)(key >> (pass * p->bits)) & p->mask;
+}
+
+/* ---------- Pass flags ---------- */
+// The key transform lives inside the first and last passes that run: the first one reads
+// the caller's values and writes keys, the last one reads keys and writes values.
+#define RADIX_PASS_FIRST  1
+#define RADIX_PASS_LAST   2
+
+static inline int radix_pass_flags(const radix_plan *p, int pass) {
+    int first = 0, last = p->passes - 1;
+    while (first < last && radix_pass_skipped(p, first)) first++;
+    while (last > first && radix_pass_skipped(p, last)) last--;
+    return (pass == first ? RADIX_PASS_FIRST : 0) | (pass == last ? RADIX_PASS_LAST : 0);
+}
+
+// Element as stored in the source of a pass -> key.
+static inline uint32_t radix_in32(const radix_plan *p, uint32_t x, int flags) {
+    if (!(flags & RADIX_PASS_FIRST)) return x;
+    return x ^ ((uint32_t)p->smask | ((0u - (x >> 31)) & (uint32_t)p->fmask));
+}
+// Key -> element as it must be stored in the destination of a pass.
+static inline uint32_t radix_out32(const radix_plan *p, uint32_t key, int flags) {
+    if (!(flags & RADIX_PASS_LAST)) return key;
+    return key ^ ((uint32_t)p->smask | ((0u - (~key >> 31)) & (uint32_t)p->fmask));
+}
+static inline uint64_t radix_in64(const radix_plan *p, uint64_t x, int flags) {
+    if (!(flags & RADIX_PASS_FIRST)) return x;
+    return x ^ (p->smask | ((0ull - (x >> 63)) & p->fmask));
+}
+static inline uint64_t radix_out64(const radix_plan *p, uint64_t key, int flags) {
+    if (!(flags & RADIX_PASS_LAST)) return key;
+    return key ^ (p->smask | ((0ull - (~key >> 63)) & p->fmask));
+}
+
+/* ---------- Kernels ---------- */
+// The parallel engines run these on their own slices; the sequential engine on the whole array.
+// 'flags' are the RADIX_PASS_* bits of the pass being run.
+
+// count[d] += number of keys in src[lo, hi) whose digit is d (count has p->buckets entries).
+void radix_histogram32(const uint32_t *src, size_t lo, size_t hi,
+                       const radix_plan *p, int pass, int flags, size_t *count);
+void radix_histogram64(const uint64_t *src, size_t lo, size_t hi,
+                       const radix_plan *p, int pass, int flags, size_t *count);
+
+// Every pass in one read: hist[pass * p->buckets + d] += keys of src[lo, hi) with digit d at
+// position pass, for all pass < p->passes (hist has p->passes * p->buckets entries).
+void radix_histogram_all32(const uint32_t *src, size_t lo, size_t hi,
+                           const radix_plan *p, int flags, size_t *hist);
+void radix_histogram_all64(const uint64_t *src, size_t lo, size_t hi,
+                           const radix_plan *p, int flags, size_t *hist);
+
+// *mn / *mx = smallest / largest key (radix_in of the element) in src[lo, hi); UINT_MAX and 0 when empty.
+void radix_key_minmax32(const uint32_t *src, size_t lo, size_t hi, const radix_plan *p,
+                        uint32_t *mn, uint32_t *mx);
+void radix_key_minmax64(const uint64_t *src, size_t lo, size_t hi, const radix_plan *p,
+                        uint64_t *mn, uint64_t *mx);
+
+// Stable forward scatter of src[lo, hi): element with digit d goes to dst[offset[d]++].
+void radix_scatter32(const uint32_t *src, uint32_t *dst, size_t lo, size_t hi,
+                     const radix_plan *p, int pass, int flags, size_t *offset);
+void radix_scatter64(const uint64_t *src, uint64_t *dst, size_t lo, size_t hi,
+                     const radix_plan *p, int pass, int flags, size_t *offset);
+
+/* ---------- SIMD kernels ---------- */
+// The bit-field histograms and the min/max scan run AVX-512 or AVX2 code where the CPU has it
+// (radix_simd.inc, checked once at run time; no build flags needed) and the scalar loops
+// otherwise. 8 or 16 keys at a time become digits in vector registers, and are counted into
+// up to 4 sub-histograms in turn, so runs of the same digit (narrow or skewed keys) are no
+// longer one chain of increments to one counter. Results are identical to the scalar loops.
+typedef enum { RADIX_SIMD_SCALAR, RADIX_SIMD_AVX2, RADIX_SIMD_AVX512 } radix_simd_kind;
+
+// Best kind this CPU (and OS) supports; always RADIX_SIMD_SCALAR off x86.
+radix_simd_kind radix_simd_detect(void);
+// Process-wide choice for every engine: AVX2 where the CPU has it until set (AVX-512 only
+// when asked for: the increments, not the lanes, bound the histograms). A kind the CPU lacks
+// is lowered to the best one it has; RADIX_SIMD_SCALAR forces the scalar loops (to compare).
+void radix_set_simd(radix_simd_kind kind);
+radix_simd_kind radix_get_simd(void);
+
+const char *radix_simd_name(radix_simd_kind kind);
+// "scalar", "avx2" or "avx512" -> kind. Returns -1 for anything else.
+int radix_simd_parse(const char *name, radix_simd_kind *kind);
+
+/* ---------- Write-combining scatter ---------- */
+// With wide digits a scatter writes up to 65536 output streams at once, which thrashes L1
+// and the TLB. The write-combining scatter stages every bucket's keys in a cache-line buffer
+// and writes a line to dst only once it is full, with non-temporal (streaming) stores where
+// SSE2 has them, so each output line is written once and whole.
+typedef enum { RADIX_SCATTER_DIRECT, RADIX_SCATTER_WC } radix_scatter_kind;
+
+#define RADIX_WC_LINE  64
+
+// Process-wide choice for the LSD key scatters of every engine (sequential, pthreads,
+// OpenMP), read when a sort starts. Key-value sorts and MSD partitions always scatter directly.
+void radix_set_scatter(radix_scatter_kind kind);
+radix_scatter_kind radix_get_scatter(void);
+
+const char *radix_scatter_name(radix_scatter_kind kind);
+// "direct" or "wc" -> kind. Returns -1 for anything else.
+int radix_scatter_parse(const char *name, radix_scatter_kind *kind);
+
+// Bytes of one staging area for plans of up to 'buckets' buckets (a multiple of RADIX_WC_LINE),
+// and 'count' such areas back to back, RADIX_WC_LINE aligned (area i at i * radix_wc_bytes).
+// Release with free(); NULL when out of memory.
+size_t radix_wc_bytes(uint32_t buckets);
+void  *radix_wc_alloc(uint32_t buckets, int count);
+
+// Same result as radix_scatter32/64. wc is one staging area owned by the calling thread;
+// NULL (or a dst that is not element-aligned) falls back to the direct scatter.
+void radix_scatter_wc32(const uint32_t *src, uint32_t *dst, size_t lo, size_t hi,
+                        const radix_plan *p, int pass, int flags, size_t *offset, void *wc);
+void radix_scatter_wc64(const uint64_t *src, uint64_t *dst, size_t lo, size_t hi,
+                        const radix_plan *p, int pass, int flags, size_t *offset, void *wc);
+
+// Key-value variant: vsrc[i] is written to vdst at the same slot as src[i].
+void radix_scatter_pairs32(const uint32_t *src, uint32_t *dst, const uint32_t *vsrc, uint32_t *vdst,
+                           size_t lo, size_t hi, const radix_plan *p, int pass, int flags, size_t *offset);
+void radix_scatter_pairs64(const uint64_t *src, uint64_t *dst, const uint32_t *vsrc, uint32_t *vdst,
+                           size_t lo, size_t hi, const radix_plan *p, int pass, int flags, size_t *offset);
+
+// Counting-sort pass of src[0, n) into dst when count already holds its histogram
+// (e.g. a row of radix_histogram_all): scan + scatter. count is overwritten.
+// wc: staging area for the write-combining scatter, or NULL for the direct one.
+void radix_pass_counted32(const uint32_t *src, uint32_t *dst, size_t n,
+                          const radix_plan *p, int pass, int flags, size_t *count, void *wc);
+void radix_pass_counted64(const uint64_t *src, uint64_t *dst, size_t n,
+                          const radix_plan *p, int pass, int flags, size_t *count, void *wc);
+
+// One full counting-sort pass of src[0, n) into dst. count is caller scratch of p->buckets entries.
+void radix_pass32(const uint32_t *src, uint32_t *dst, size_t n,
+                  const radix_plan *p, int pass, int flags, size_t *count);
+void radix_pass64(const uint64_t *src, uint64_t *dst, size_t n,
+                  const radix_plan *p, int pass, int flags, size_t *count);
+void radix_pass_pairs32(const uint32_t *src, uint32_t *dst, const uint32_t *vsrc, uint32_t *vdst,
+                        size_t n, const radix_plan *p, int pass, int flags, size_t *count);
+void radix_pass_pairs64(const uint64_t *src, uint64_t *dst, const uint32_t *vsrc, uint32_t *vdst,
+                        size_t n, const radix_plan *p, int pass, int flags, size_t *count);
+
+/* ---------- Sequential engine ---------- */
+// Sorts n elements of 'type' in place. Returns 0 on success, -1 on bad bits or allocation failure.
+// One read histograms every digit position first; positions where all keys share the
+// digit are skipped. Every other pass reads one buffer and writes the other (a and a scratch
+// array of n elements take turns); a single copy back is made only when the number of
+// passes run is odd.
+int radix_sort(void *a, size_t n, radix_key_type type, int bits);
+
+// Same, with caller scratch of n elements of 'type' (NULL = allocate it), so repeated sorts
+// allocate nothing but the bucket counts. Its contents afterwards are unspecified.
+int radix_sort_scratch(void *a, void *scratch, size_t n, radix_key_type type, int bits);
+
+static inline int radix_sort_u32(uint32_t *a, size_t n, int bits) { return radix_sort(a, n, RADIX_U32, bits); }
+static inline int radix_sort_i32(int32_t *a, size_t n, int bits)  { return radix_sort(a, n, RADIX_I32, bits); }
+static inline int radix_sort_f32(float *a, size_t n, int bits)    { return radix_sort(a, n, RADIX_F32, bits); }
+static inline int radix_sort_u64(uint64_t *a, size_t n, int bits) { return radix_sort(a, n, RADIX_U64, bits); }
+static inline int radix_sort_i64(int64_t *a, size_t n, int bits)  { return radix_sort(a, n, RADIX_I64, bits); }
+static inline int radix_sort_f64(double *a, size_t n, int bits)   { return radix_sort(a, n, RADIX_F64, bits); }
+
+/* ---------- Direct counting sort ---------- */
+// When the keys span few distinct values (max_key - min_key < n, e.g. small integers or
+// low-cardinality IDs) one count per value and one write pass replace all the digit passes.
+// Keys only: the output is rebuilt from the counts, so no scratch array is needed.
+#define RADIX_COUNT_MAX_RANGE  (1u << 20)     /* values counted at most (8 MB of counts per thread) */
+
+// count[key - min_key]++ for every key of src[lo, hi); all keys must lie in [min_key, min_key + range).
+void radix_count_range32(const uint32_t *src, size_t lo, size_t hi, const radix_plan *p,
+                         uint32_t min_key, size_t *count);
+void radix_count_range64(const uint64_t *src, size_t lo, size_t hi, const radix_plan *p,
+                         uint64_t min_key, size_t *count);
+
+// Writes dst[lo, hi) of the sorted output, where start[v] (v < range) is the first slot of the
+// value whose key is min_key + v (the exclusive prefix sum of the counts).
+void radix_fill_range32(uint32_t *dst, size_t lo, size_t hi, const radix_plan *p,
+                        uint32_t min_key, const size_t *start, size_t range);
+void radix_fill_range64(uint64_t *dst, size_t lo, size_t hi, const radix_plan *p,
+                        uint64_t min_key, const size_t *start, size_t range);
+
+// Sorts a[0, n) whose keys all lie in [min_key, max_key] (radix_key32/64 of the smallest and
+// largest value). Returns -1 if max_key - min_key >= RADIX_COUNT_MAX_RANGE or out of memory.
+int radix_count_sort(void *a, size_t n, radix_key_type type, uint64_t min_key, uint64_t max_key);
+
+/* ---------- Strategy ---------- */
+// Which engine suits the data, decided from its key range and a sample of its keys.
+typedef enum {
+    RADIX_PATH_COUNTING,   // range of at most n values: radix_count_sort
+    RADIX_PATH_LSD,        // digit passes over the whole array
+    RADIX_PATH_MSD         // partition on the top digit, then sort the buckets in cache
+} radix_path;
+
+#define RADIX_SAMPLE  1024   /* keys looked at by radix_choose_path */
+
+const char *radix_path_name(radix_path path);
+
+// COUNTING when max_key - min_key < n (and < RADIX_COUNT_MAX_RANGE). Otherwise a strided
+// sample of RADIX_SAMPLE keys is counted on the top 'bits'-wide digit of the range: MSD
+// when n > RADIX_SAMPLE, LSD would need at least 3 passes over the varying bits and no top
+// digit holds more than a quarter of the sample (the buckets come out even, so they sort
+// in cache), LSD otherwise.
+// *top_share (may be NULL) gets the largest fraction of the sample in one top digit.
+radix_path radix_choose_path(const void *a, size_t n, radix_key_type type, int bits,
+                             uint64_t min_key, uint64_t max_key, double *top_share);
+
+/* ---------- Segmented sort ---------- */
+// Many independent small arrays in one flat buffer: segment i is a[offsets[i], offsets[i + 1]).
+// Sorting them in one call reuses one scratch array and one set of histograms for all of them,
+// and lets the parallel engines hand whole segments to threads.
+#define RADIX_SEG_SMALL  64   /* segments of at most this many keys are insertion sorted */
+
+// Sorts a[0, n) in place: insertion sort up to RADIX_SEG_SMALL keys, else the digit passes
+// of p (a plan over the whole key width) that are not trivial for these keys. scratch holds n
+// elements, hist p->passes * p->buckets counts. Allocates nothing.
+void radix_sort_segment32(uint32_t *a, uint32_t *scratch, size_t n, const radix_plan *p, size_t *hist);
+void radix_sort_segment64(uint64_t *a, uint64_t *scratch, size_t n, const radix_plan *p, size_t *hist);
+
+// Largest segment of offsets[0, segments] (0 when there are none).
+size_t radix_segments_max(const size_t *offsets, size_t segments);
+
+// Sorts every segment a[offsets[i], offsets[i + 1]) for i < segments on its own, in place.
+// offsets holds segments + 1 nondecreasing entries. Small digits (8) suit small segments: a
+// pass of 11 or 16-bit digits clears and scans more counts than a 2000-key segment has keys.
+// Returns 0, or -1 on bad bits or no memory.
+int radix_sort_segments(void *a, const size_t *offsets, size_t segments, radix_key_type type, int bits);
+
+/* ---------- Selection ---------- */
+// The k-th smallest element (k = 0 the smallest, n / 2 the median, (n - 1) * 99 / 100 the p99)
+// without sorting. Each level counts one RADIX_SELECT_BITS-wide digit, from the highest bit in
+// which the keys differ down, and keeps only the bucket that holds the k-th key: after the first
+// read just that bucket (about n / 2048 elements on spread-out keys) is copied and looked at again.
+// Keys spanning fewer than n values (and RADIX_COUNT_MAX_RANGE) are counted per value instead.
+#define RADIX_SELECT_BITS   11
+#define RADIX_SELECT_SMALL  32    /* candidates left that are insertion sorted instead */
+
+// Plan of RADIX_SELECT_BITS digits over the bits in which min_key and max_key differ. *prefix
+// gets the bits above them (the same in every key); each level adds the digit it keeps.
+void radix_select_plan(radix_plan *p, radix_key_type type, uint64_t min_key, uint64_t max_key,
+                       uint64_t *prefix);
+
+// One level: rows holds the digit histograms of 'threads' slices of the candidates. *d = the
+// bucket of the k-th one, *k -= candidates in the buckets before it, at[t] (at may be NULL) =
+// slot of slice t's first kept candidate in the next level. Returns the candidates kept.
+size_t radix_select_bucket(const size_t *rows, int threads, uint32_t buckets, size_t *k,
+                           size_t *at, uint32_t *d);
+
+// Copies the elements of src[lo, hi) whose digit at 'pass' is d to dst, in order (dst may be
+// src itself: the copy never overtakes the read). Any of dst[0, room) may be written, and the
+// copy stops once room are copied: pass their count from the histogram to get all of them.
+// Returns how many were copied.
+size_t radix_filter_digit32(const uint32_t *src, size_t lo, size_t hi, const radix_plan *p,
+                            int pass, uint32_t d, uint32_t *dst, size_t room);
+size_t radix_filter_digit64(const uint64_t *src, size_t lo, size_t hi, const radix_plan *p,
+                            int pass, uint32_t d, uint64_t *dst, size_t room);
+
+// Same for the elements whose key is below t (above t with 'above'); dst NULL only counts them.
+size_t radix_take32(const uint32_t *src, size_t lo, size_t hi, const radix_plan *p,
+                    uint32_t t, int above, uint32_t *dst, size_t room);
+size_t radix_take64(const uint64_t *src, size_t lo, size_t hi, const radix_plan *p,
+                    uint64_t t, int above, uint64_t *dst, size_t room);
+
+// *key = radix_key32/64 of the k-th smallest element of a[0, n); a is not modified.
+// Returns -1 if k >= n or out of memory.
+int radix_select_key(const void *a, size_t n, radix_key_type type, size_t k, uint64_t *key);
+// Same, the element itself is stored at out (4 or 8 bytes).
+int radix_select(const void *a, size_t n, radix_key_type type, size_t k, void *out);
+
+// out[0, k) = the k smallest elements in ascending order, or with 'largest' the k largest in
+// descending order. The k-th one is selected, one read copies those strictly before it, they
+// are sorted and the rest of out is filled with the k-th one (equal keys are equal bits).
+// Returns -1 if k > n or out of memory.
+int radix_topk(const void *a, size_t n, radix_key_type type, size_t k, int largest, void *out);
+
+// Last step of every radix_topk: out[0, taken) holds the elements before the k-th one (key t)
+// sorted ascending. Fills out[taken, k) with it and, with 'largest', reverses out[0, taken).
+void radix_topk_finish(void *out, size_t taken, size_t k, radix_key_type type, uint64_t t, int largest);
+
+/* ---------- In-place MSD (American flag sort) ---------- */
+// Every other engine scatters into an n-element buffer, so a sort needs twice the array's
+// memory. These permute the array itself: one digit is counted, every element is swapped into
+// its bucket along the permutation's cycles, then each bucket is sorted the same way on the
+// next digit. Extra memory is two rows of counts per level (and per thread in the parallel
+// engines), O(buckets x threads). Not stable, which a plain sort cannot show: equal keys are
+// equal bits.
+#define RADIX_FLAG_SMALL  32   /* buckets of at most this many keys are insertion sorted */
+
+// One thread's share of a partition on the digit at 'pass'. Each bucket d is cut in stripes,
+// one per thread; mine is [head[d], tail[d]). For each of my stripes in turn, every element
+// is carried to the next free slot of my stripe of its bucket (picking up what was there)
+// while that stripe has room. Afterwards my stripe of d holds bucket-d elements up to head[d]
+// and leftovers that found no room from there to tail[d]. A single stripe per bucket, sized by
+// the bucket's count, leaves nothing over: that is the sequential American flag permutation.
+void radix_flag_permute32(uint32_t *a, const radix_plan *p, int pass, size_t *head, const size_t *tail);
+void radix_flag_permute64(uint64_t *a, const radix_plan *p, int pass, size_t *head, const size_t *tail);
+
+// After every thread's permute: the stripes of bucket d cover [.., hi), stripe t's leftovers
+// being [head[t * stride], tail[t * stride]). Swaps them with bucket-d elements from the back
+// and returns where the leftovers now start: a[.., return) holds bucket d's elements only.
+size_t radix_flag_repair32(uint32_t *a, const radix_plan *p, int pass, uint32_t d, const size_t *head,
+                           const size_t *tail, size_t stride, int stripes, size_t hi);
+size_t radix_flag_repair64(uint64_t *a, const radix_plan *p, int pass, uint32_t d, const size_t *head,
+                           const size_t *tail, size_t stride, int stripes, size_t hi);
+
+// Sorts a[0, n) in place on digit positions pass ... 0 (keys agree on the ones above).
+// Positions where all keys of a bucket share the digit are skipped, and buckets with fewer keys
+// than p->buckets go on with 8-bit digits. work holds 2 * p->buckets * (pass + 1) counts.
+void radix_flag_sort32(uint32_t *a, size_t n, const radix_plan *p, int pass, size_t *work);
+void radix_flag_sort64(uint64_t *a, size_t n, const radix_plan *p, int pass, size_t *work);
+
+// Sorts n elements of 'type' in place: a min/max scan finds the top digit where keys differ,
+// then radix_flag_sort. Returns 0, or -1 on bad bits or no memory.
+int radix_sort_inplace(void *a, size_t n, radix_key_type type, int bits);
+
+/* ---------- Key-value and argsort ---------- */
+// Values are 32-bit payloads (record IDs, row indices) that move in the same stable
+// scatter as their keys, so equal keys keep their values in input order.
+
+// Sorts keys in place and applies the same permutation to values[0, n).
+int radix_sort_pairs(void *keys, uint32_t *values, size_t n, radix_key_type type, int bits);
+
+// perm[i] = index in keys of the i-th smallest key (stable). keys is not modified.
+// Returns -1 on bad bits, no memory or n > UINT32_MAX.
+int radix_argsort(const void *keys, uint32_t *perm, size_t n, radix_key_type type, int bits);
+
+#endif
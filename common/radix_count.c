@@ -0,0 +1,170 @@
+// radix_count.c - direct counting sort on the radix_ctx pool and the range-aware dispatcher
+#include <stdlib.h>
+#include <string.h>
+#include "radix_ctx_impl.h"
+#include "radix_trace.h"
+
+typedef struct {
+    uint64_t min_key;
+    size_t   range;          // values counted: max_key - min_key + 1
+    size_t  *rows;           // per thread: range counts; row 0 ends up as the start slot of every value
+    size_t  *chunk;          // per thread: elements whose value falls in its share of the range
+    uint64_t *tmin;          // min/max scan: per-thread smallest key (largest in ctx->tmax)
+} count_state;
+
+// 1. count my slice  2. sum the columns of my share of the values into row 0
+// 3. turn them into start slots  4. write my slice of the output from row 0
+static void count_job(radix_ctx *ctx, int tid) {
+    count_state *st = ctx->job_data;
+    const radix_plan *p = &ctx->plan;
+    size_t range = st->range, lo, hi;
+    size_t *row = st->rows + (size_t)tid * range;
+    radix_ctx_slice(ctx, tid, &lo, &hi);
+
+    RADIX_TRACE_START(t0);
+    memset(row, 0, range * sizeof(size_t));
+    if (p->width == 32) radix_count_range32((const uint32_t *)ctx->arr, lo, hi, p, (uint32_t)st->min_key, row);
+    else                radix_count_range64((const uint64_t *)ctx->arr, lo, hi, p, st->min_key, row);
+    RADIX_TRACE_STOP(tid, RADIX_PH_HISTOGRAM, -1, t0);
+    RADIX_TRACE_START(t_wait1);
+    radix_ctx_wait(ctx);             // every row is complete
+    RADIX_TRACE_STOP(tid, RADIX_PH_BARRIER, -1, t_wait1);
+
+    RADIX_TRACE_START(t1);
+    size_t v_lo = range * (size_t)tid / ctx->threads, v_hi = range * (size_t)(tid + 1) / ctx->threads;
+    size_t sum = 0;
+    for (size_t v = v_lo; v < v_hi; v++) {
+        size_t c = 0;
+        for (int t = 0; t < ctx->threads; t++) c += st->rows[(size_t)t * range + v];
+        st->rows[v] = c;
+        sum += c;
+    }
+    st->chunk[tid] = sum;
+    RADIX_TRACE_STOP(tid, RADIX_PH_SCAN, -1, t1);
+    RADIX_TRACE_START(t_wait2);
+    radix_ctx_wait(ctx);             // every chunk total is known
+    RADIX_TRACE_STOP(tid, RADIX_PH_BARRIER, -1, t_wait2);
+
+    RADIX_TRACE_START(t2);
+    size_t at = 0;
+    for (int t = 0; t < tid; t++) at += st->chunk[t];
+    for (size_t v = v_lo; v < v_hi; v++) {
+        size_t c = st->rows[v];
+        st->rows[v] = at;
+        at += c;
+    }
+    RADIX_TRACE_STOP(tid, RADIX_PH_SCAN, -1, t2);
+    RADIX_TRACE_START(t_wait3);
+    radix_ctx_wait(ctx);             // row 0 holds every start slot
+    RADIX_TRACE_STOP(tid, RADIX_PH_BARRIER, -1, t_wait3);
+
+    // Output slices are split by position, not by value, so a heavy value does not land on one thread
+    RADIX_TRACE_START(t3);
+    if (p->width == 32) radix_fill_range32((uint32_t *)ctx->arr, lo, hi, p, (uint32_t)st->min_key, st->rows, range);
+    else                radix_fill_range64((uint64_t *)ctx->arr, lo, hi, p, st->min_key, st->rows, range);
+    RADIX_TRACE_STOP(tid, RADIX_PH_SCATTER, -1, t3);
+}
+
+// Smallest and largest key of my slice
+static void minmax_job(radix_ctx *ctx, int tid) {
+    count_state *st = ctx->job_data;
+    const radix_plan *p = &ctx->plan;
+    size_t lo, hi;
+    radix_ctx_slice(ctx, tid, &lo, &hi);
+    RADIX_TRACE_START(t0);
+    uint64_t mn = UINT64_MAX, mx = 0;
+    if (p->width == 32) {
+        uint32_t mn32, mx32;
+        radix_key_minmax32((const uint32_t *)ctx->arr, lo, hi, p, &mn32, &mx32);
+        if (lo < hi) { mn = mn32; mx = mx32; }
+    } else if (lo < hi) {
+        radix_key_minmax64((const uint64_t *)ctx->arr, lo, hi, p, &mn, &mx);
+    }
+    st->tmin[tid] = mn;
+    ctx->tmax[tid] = mx;
+    RADIX_TRACE_STOP(tid, RADIX_PH_MAX, -1, t0);
+}
+
+// Points the pool at a[0, n) with a plan used only for its key transform. Caller holds sort_lock.
+static void point_at(radix_ctx *ctx, void *a, size_t n, radix_key_type type) {
+    radix_plan_init(&ctx->plan, type, 8, 0);
+    ctx->arr  = a;
+    ctx->vals = NULL;
+    ctx->lo   = 0;
+    ctx->n    = n;
+    ctx->elem = (size_t)radix_key_width(type) / 8;
+}
+
+void radix_ctx_key_range(radix_ctx *ctx, const void *a, size_t n, radix_key_type type,
+                         uint64_t *mn, uint64_t *mx) {
+    uint64_t tmin[ctx->threads];
+    count_state st = { 0, 0, NULL, NULL, tmin };
+    point_at(ctx, (void *)a, n, type);
+    ctx->job_data = &st;
+    radix_ctx_run(ctx, minmax_job);
+    ctx->job_data = NULL;
+    *mn = UINT64_MAX; *mx = 0;
+    for (int t = 0; t < ctx->threads; t++) {
+        if (tmin[t] < *mn) *mn = tmin[t];
+        if (ctx->tmax[t] > *mx) *mx = ctx->tmax[t];
+    }
+}
+
+int radix_ctx_sort_counting(radix_ctx *ctx, void *a, size_t n, radix_key_type type,
+                            uint64_t min_key, uint64_t max_key) {
+    if (max_key < min_key || max_key - min_key >= RADIX_COUNT_MAX_RANGE) return -1;
+    if (n <= 1) return 0;
+    size_t range = (size_t)(max_key - min_key) + 1;
+
+    // Small inputs, or so many values per thread that the per-thread rows cost more than they save
+    if (n <= ctx->seq_cutoff || ctx->threads == 1 || range > n / ctx->threads)
+        return radix_count_sort(a, n, type, min_key, max_key);
+
+    count_state st = { min_key, range, malloc((size_t)ctx->threads * range * sizeof(size_t)),
+                       malloc((size_t)ctx->threads * sizeof(size_t)), NULL };
+    if (!st.rows || !st.chunk) { free(st.rows); free(st.chunk); return -1; }
+
+    pthread_mutex_lock(&ctx->sort_lock);
+    point_at(ctx, a, n, type);
+    ctx->job_data = &st;
+    radix_ctx_run(ctx, count_job);
+    ctx->job_data = NULL;
+    pthread_mutex_unlock(&ctx->sort_lock);
+
+    free(st.rows);
+    free(st.chunk);
+    return 0;
+}
+
+int radix_ctx_sort_auto(radix_ctx *ctx, void *a, size_t n, radix_key_type type, int bits,
+                        const uint64_t *minmax, radix_path *used) {
+    radix_plan plan;
+    if (radix_plan_init(&plan, type, bits, 0) != 0) return -1;
+    if (used) *used = RADIX_PATH_LSD;
+    if (n <= 1) return 0;
+
+    uint64_t mn, mx;
+    if (minmax) {
+        mn = minmax[0];
+        mx = minmax[1];
+    } else if (n <= ctx->seq_cutoff || ctx->threads == 1) {
+        if (radix_key_width(type) == 32) {
+            uint32_t mn32, mx32;
+            radix_key_minmax32((const uint32_t *)a, 0, n, &plan, &mn32, &mx32);
+            mn = mn32;
+            mx = mx32;
+        } else {
+            radix_key_minmax64((const uint64_t *)a, 0, n, &plan, &mn, &mx);
+        }
+    } else {
+        pthread_mutex_lock(&ctx->sort_lock);
+        radix_ctx_key_range(ctx, a, n, type, &mn, &mx);
+        pthread_mutex_unlock(&ctx->sort_lock);
+    }
+
+    radix_path path = radix_choose_path(a, n, type, bits, mn, mx, NULL);
+    if (used) *used = path;
+    if (path == RADIX_PATH_COUNTING) return radix_ctx_sort_counting(ctx, a, n, type, mn, mx);
+    if (path == RADIX_PATH_MSD)      return radix_ctx_sort_msd(ctx, a, n, type, bits);
+    return radix_ctx_sort_bounded(ctx, a, n, type, bits, mx);
+}
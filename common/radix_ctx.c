@@ -0,0 +1,458 @@
+// radix_ctx.c - persistent worker pool and parallel LSD engine for the pthreads backend
+#define _GNU_SOURCE
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "radix_ctx_impl.h"
+#include "radix_trace.h"
+
+/* ---------- Context ---------- */
+void radix_ctx_config_init(radix_ctx_config *cfg) {
+    cfg->threads    = RADIX_CTX_DEFAULT_THREADS;
+    cfg->seq_cutoff = RADIX_CTX_DEFAULT_SEQ_CUTOFF;
+    cfg->barrier    = RADIX_BARRIER_SPIN;
+    cfg->pin        = RADIX_PIN_NONE;
+}
+
+/* ---------- Barrier ---------- */
+void radix_ctx_wait(radix_ctx *ctx) {
+    radix_barrier_wait(&ctx->barrier);
+}
+
+/* ---------- Pool ---------- */
+static void *worker_main(void *arg) {
+    radix_worker_arg *w = (radix_worker_arg *)arg;
+    radix_ctx *ctx = w->ctx;
+
+    if (ctx->cpu) radix_pin_self(ctx->cpu[w->tid]);   // before the first job touches any memory
+    for (;;) {
+        radix_ctx_wait(ctx);           // parked until the caller posts a job
+        radix_job job = ctx->job;
+        if (!job) break;
+        job(ctx, w->tid);
+        radix_ctx_wait(ctx);           // job finished on every thread
+    }
+    return NULL;
+}
+
+// The caller runs its share as tid 0, so 'threads' cores do work and none idles.
+void radix_ctx_run(radix_ctx *ctx, radix_job job) {
+    ctx->job = job;
+    radix_ctx_wait(ctx);
+    job(ctx, 0);
+    radix_ctx_wait(ctx);
+}
+
+radix_ctx *radix_ctx_create(const radix_ctx_config *cfg) {
+    radix_ctx_config def;
+    if (!cfg) { radix_ctx_config_init(&def); cfg = &def; }
+
+    radix_ctx *ctx = calloc(1, sizeof(*ctx));
+    if (!ctx) return NULL;
+    ctx->threads    = cfg->threads > 0 ? cfg->threads : RADIX_CTX_DEFAULT_THREADS;
+    ctx->seq_cutoff = cfg->seq_cutoff;
+
+    ctx->workers = calloc(ctx->threads, sizeof(pthread_t));
+    ctx->args    = calloc(ctx->threads, sizeof(radix_worker_arg));
+    ctx->tmax    = calloc(ctx->threads, sizeof(uint64_t));
+    if (cfg->pin != RADIX_PIN_NONE) ctx->cpu = malloc(ctx->threads * sizeof(int));
+    if (!ctx->workers || !ctx->args || !ctx->tmax || (cfg->pin != RADIX_PIN_NONE && !ctx->cpu)) {
+        free(ctx->workers); free(ctx->args); free(ctx->tmax); free(ctx->cpu); free(ctx);
+        return NULL;
+    }
+    if (ctx->cpu && radix_topo_assign(cfg->pin, ctx->threads, ctx->cpu) != 0) {
+        free(ctx->cpu);              // no topology: run unpinned
+        ctx->cpu = NULL;
+    }
+
+    if (radix_barrier_init(&ctx->barrier, cfg->barrier, ctx->threads) != 0) {
+        free(ctx->workers); free(ctx->args); free(ctx->tmax); free(ctx->cpu); free(ctx);
+        return NULL;
+    }
+    pthread_mutex_init(&ctx->sort_lock, NULL);
+    if (ctx->cpu) radix_pin_self(ctx->cpu[0]);
+
+    int wanted = ctx->threads;
+    for (int t = 1; t < wanted; t++) {
+        ctx->args[t].ctx = ctx;
+        ctx->args[t].tid = t;
+        if (pthread_create(&ctx->workers[t], NULL, worker_main, &ctx->args[t]) != 0) {
+            // Keep the workers that did start; the barrier now waits for t participants
+            radix_barrier_drop(&ctx->barrier, wanted - t);
+            ctx->threads = t;
+            break;
+        }
+    }
+    return ctx;
+}
+
+void radix_ctx_destroy(radix_ctx *ctx) {
+    if (!ctx) return;
+
+    ctx->job = NULL;                 // workers see no job and exit
+    radix_ctx_wait(ctx);
+    for (int t = 1; t < ctx->threads; t++)
+        pthread_join(ctx->workers[t], NULL);
+
+    pthread_mutex_destroy(&ctx->sort_lock);
+    radix_barrier_destroy(&ctx->barrier);
+    free(ctx->workers);
+    free(ctx->args);
+    free(ctx->tmax);
+    free(ctx->cpu);
+    free(ctx->scratch);
+    free(ctx->vscratch);
+    free(ctx->hist);
+    free(ctx->dhist);
+    free(ctx->wc);
+    free(ctx);
+}
+
+void radix_ctx_release(radix_ctx *ctx) {
+    pthread_mutex_lock(&ctx->sort_lock);
+    free(ctx->scratch);
+    free(ctx->vscratch);
+    ctx->scratch  = ctx->vscratch = NULL;
+    ctx->scratch_bytes = ctx->vscratch_bytes = 0;
+    pthread_mutex_unlock(&ctx->sort_lock);
+}
+
+int radix_ctx_threads(const radix_ctx *ctx) { return ctx->threads; }
+
+void radix_ctx_pass_stats(const radix_ctx *ctx, int *run, int *skipped) {
+    *run     = ctx->passes_run;
+    *skipped = ctx->passes_skipped;
+}
+
+radix_barrier_kind radix_ctx_barrier(const radix_ctx *ctx) { return ctx->barrier.kind; }
+
+int radix_ctx_cpu(const radix_ctx *ctx, int tid) {
+    return ctx->cpu && tid >= 0 && tid < ctx->threads ? ctx->cpu[tid] : -1;
+}
+
+/* ---------- Jobs ---------- */
+// Balanced partition (base + remainder), same split for every phase of a sort
+void radix_ctx_slice(const radix_ctx *ctx, int tid, size_t *lo, size_t *hi) {
+    size_t base = ctx->n / ctx->threads;
+    size_t rem  = ctx->n % ctx->threads;
+    size_t t    = (size_t)tid;
+    *lo = ctx->lo + t * base + (t < rem ? t : rem);
+    *hi = *lo + base + (t < rem ? 1 : 0);
+}
+
+static void max_key_job(radix_ctx *ctx, int tid) {
+    RADIX_TRACE_START(t0);
+    size_t lo, hi;
+    radix_ctx_slice(ctx, tid, &lo, &hi);
+    const radix_plan *p = &ctx->plan;
+    uint64_t mx = 0;
+    if (p->width == 32) {
+        uint32_t mn32, mx32 = 0;
+        radix_key_minmax32((const uint32_t *)ctx->arr, lo, hi, p, &mn32, &mx32);
+        mx = mx32;
+    } else {
+        uint64_t mn64;
+        radix_key_minmax64((const uint64_t *)ctx->arr, lo, hi, p, &mn64, &mx);
+    }
+    ctx->tmax[tid] = mx;
+    RADIX_TRACE_STOP(tid, RADIX_PH_MAX, -1, t0);
+}
+
+// First touch: my slice of dst copied from src (zeroed when src is NULL)
+typedef struct {
+    char       *dst;
+    const char *src;
+    size_t      elem;
+} touch_job_data;
+
+static void touch_job(radix_ctx *ctx, int tid) {
+    const touch_job_data *d = ctx->job_data;
+    size_t lo, hi;
+    radix_ctx_slice(ctx, tid, &lo, &hi);
+    if (d->src) memcpy(d->dst + lo * d->elem, d->src + lo * d->elem, (hi - lo) * d->elem);
+    else        memset(d->dst + lo * d->elem, 0, (hi - lo) * d->elem);
+}
+
+// Runs touch_job over [0, n) with the slices a sort of n elements uses. Caller holds sort_lock.
+static void first_touch(radix_ctx *ctx, void *dst, const void *src, size_t n, size_t elem) {
+    touch_job_data d = { dst, src, elem };
+    size_t lo = ctx->lo, cnt = ctx->n;
+    void *saved = ctx->job_data;
+    ctx->lo = 0;
+    ctx->n  = n;
+    ctx->job_data = &d;
+    radix_ctx_run(ctx, touch_job);
+    ctx->job_data = saved;
+    ctx->lo = lo;
+    ctx->n  = cnt;
+}
+
+void radix_ctx_first_touch(radix_ctx *ctx, void *dst, const void *src, size_t n, size_t elem) {
+    pthread_mutex_lock(&ctx->sort_lock);
+    first_touch(ctx, dst, src, n, elem);
+    pthread_mutex_unlock(&ctx->sort_lock);
+}
+
+// Row block of thread tid in ctx->dhist (tid == threads: the total)
+static size_t *digit_counts(radix_ctx *ctx, int tid) {
+    return ctx->dhist + (size_t)tid * ctx->plan.passes * ctx->plan.buckets;
+}
+
+// Histograms of every digit position of my slice in one read
+static void digit_count_job(radix_ctx *ctx, int tid) {
+    RADIX_TRACE_START(t0);
+    size_t lo, hi;
+    radix_ctx_slice(ctx, tid, &lo, &hi);
+    const radix_plan *p = &ctx->plan;
+    size_t *h = digit_counts(ctx, tid);
+    memset(h, 0, (size_t)p->passes * p->buckets * sizeof(size_t));
+    if (p->width == 32)
+        radix_histogram_all32((const uint32_t *)ctx->arr, lo, hi, p, RADIX_PASS_FIRST, h);
+    else
+        radix_histogram_all64((const uint64_t *)ctx->arr, lo, hi, p, RADIX_PASS_FIRST, h);
+    RADIX_TRACE_STOP(tid, RADIX_PH_HISTOGRAM, -1, t0);
+}
+
+// Count my slice | barrier | scan offsets, scatter my slice | barrier.
+// The next pass reads the other buffer, so nothing is copied between passes.
+void radix_ctx_pass(radix_ctx *ctx, int tid, int pass, int flags, int from) {
+    const radix_plan *p = &ctx->plan;
+    size_t lo, hi;
+    radix_ctx_slice(ctx, tid, &lo, &hi);
+
+    size_t *local  = radix_ctx_count(ctx, tid);
+    size_t *offset = radix_ctx_offset(ctx, tid);
+    int counted = flags & RADIX_CTX_COUNTED;
+    flags &= ~RADIX_CTX_COUNTED;
+    char *arr = (char *)(from ? ctx->out : ctx->arr);
+    char *out = (char *)(from ? ctx->arr : ctx->out);
+    uint32_t *vals = from ? ctx->vout : ctx->vals;
+    uint32_t *vout = from ? ctx->vals : ctx->vout;
+
+    if (!counted) {
+        RADIX_TRACE_START(t_hist);
+        memset(local, 0, p->buckets * sizeof(size_t));
+        if (p->width == 32)
+            radix_histogram32((const uint32_t *)arr, lo, hi, p, pass, flags, local);
+        else
+            radix_histogram64((const uint64_t *)arr, lo, hi, p, pass, flags, local);
+        RADIX_TRACE_STOP(tid, RADIX_PH_HISTOGRAM, pass, t_hist);
+    }
+
+    RADIX_TRACE_START(t_wait1);
+    radix_ctx_wait(ctx);             // every histogram is complete
+    RADIX_TRACE_STOP(tid, RADIX_PH_BARRIER, pass, t_wait1);
+
+    RADIX_TRACE_START(t_scan);
+    // Exclusive scan across (digit, thread): my first slot for digit d is every
+    // element with a smaller digit + the same digit in earlier slices
+    size_t running = ctx->lo;
+    for (uint32_t d = 0; d < p->buckets; d++) {
+        for (int t = 0; t < ctx->threads; t++) {
+            if (t == tid) offset[d] = running;
+            running += radix_ctx_count(ctx, t)[d];
+        }
+    }
+    if (tid == 0 && running - ctx->lo != ctx->n) {   // bad slices or missed counts
+        fprintf(stderr, "ERROR: histogram sum %zu != n %zu (pass=%d)\n", running - ctx->lo, ctx->n, pass);
+        abort();
+    }
+    RADIX_TRACE_STOP(tid, RADIX_PH_SCAN, pass, t_scan);
+
+    // Stable scatter of my slice (forward order keeps equal digits in input order)
+    RADIX_TRACE_START(t_scatter);
+    if (vals && p->width == 32)
+        radix_scatter_pairs32((const uint32_t *)arr, (uint32_t *)out, vals, vout,
+                              lo, hi, p, pass, flags, offset);
+    else if (vals)
+        radix_scatter_pairs64((const uint64_t *)arr, (uint64_t *)out, vals, vout,
+                              lo, hi, p, pass, flags, offset);
+    else if (ctx->wc_on && p->width == 32)
+        radix_scatter_wc32((const uint32_t *)arr, (uint32_t *)out, lo, hi, p, pass, flags, offset,
+                           (char *)ctx->wc + (size_t)tid * radix_wc_bytes(ctx->wc_buckets));
+    else if (ctx->wc_on)
+        radix_scatter_wc64((const uint64_t *)arr, (uint64_t *)out, lo, hi, p, pass, flags, offset,
+                           (char *)ctx->wc + (size_t)tid * radix_wc_bytes(ctx->wc_buckets));
+    else if (p->width == 32)
+        radix_scatter32((const uint32_t *)arr, (uint32_t *)out, lo, hi, p, pass, flags, offset);
+    else
+        radix_scatter64((const uint64_t *)arr, (uint64_t *)out, lo, hi, p, pass, flags, offset);
+    RADIX_TRACE_STOP(tid, RADIX_PH_SCATTER, pass, t_scatter);
+
+    RADIX_TRACE_START(t_wait2);
+    radix_ctx_wait(ctx);             // output holds the whole pass
+    RADIX_TRACE_STOP(tid, RADIX_PH_BARRIER, pass, t_wait2);
+}
+
+void radix_ctx_copy_back(radix_ctx *ctx, int tid, int pass) {
+    (void)pass;                      // only the trace span uses it
+    size_t lo, hi;
+    radix_ctx_slice(ctx, tid, &lo, &hi);
+    RADIX_TRACE_START(t_copy);
+    memcpy((char *)ctx->arr + lo * ctx->elem, (const char *)ctx->out + lo * ctx->elem, (hi - lo) * ctx->elem);
+    if (ctx->vals)
+        memcpy(ctx->vals + lo, ctx->vout + lo, (hi - lo) * sizeof(uint32_t));
+    RADIX_TRACE_STOP(tid, RADIX_PH_COPY, pass, t_copy);
+}
+
+// Passes ping-pong between arr and the scratch buffer; an odd number of them leaves the
+// result in scratch and needs one copy (every thread copies its own slice). The first pass
+// that runs still sees the input order, so digit_count_job already counted my slice for it.
+static void lsd_job(radix_ctx *ctx, int tid) {
+    const radix_plan *p = &ctx->plan;
+    int from = 0, last = -1;
+    for (int pass = 0; pass < p->passes; pass++) {
+        if (radix_pass_skipped(p, pass)) continue;
+        int flags = radix_pass_flags(p, pass);
+        if (last < 0) {
+            memcpy(radix_ctx_count(ctx, tid), digit_counts(ctx, tid) + (size_t)pass * p->buckets,
+                   p->buckets * sizeof(size_t));
+            flags |= RADIX_CTX_COUNTED;
+        }
+        radix_ctx_pass(ctx, tid, pass, flags, from);
+        from ^= 1;
+        last = pass;
+    }
+    if (from)
+        radix_ctx_copy_back(ctx, tid, last);
+}
+
+/* ---------- Sort ---------- */
+// Grows *buf to at least 'bytes'; old contents are not kept.
+static int reserve(void **buf, size_t *cap, size_t bytes) {
+    if (bytes <= *cap) return 0;
+    free(*buf);
+    *buf = malloc(bytes);
+    *cap = *buf ? bytes : 0;
+    return *buf ? 0 : -1;
+}
+
+int radix_ctx_prepare(radix_ctx *ctx, void *a, uint32_t *vals, size_t n, radix_key_type type, int bits,
+                      const uint64_t *max_key) {
+    if (radix_plan_init(&ctx->plan, type, bits, 0) != 0) return -1;
+    ctx->arr  = a;
+    ctx->vals = vals;
+    ctx->lo   = 0;
+    ctx->n    = n;
+    ctx->elem = (size_t)radix_key_width(type) / 8;
+
+    uint64_t mx = 0;
+    if (max_key) {
+        mx = *max_key;
+    } else {
+        radix_ctx_run(ctx, max_key_job);
+        for (int t = 0; t < ctx->threads; t++)
+            if (ctx->tmax[t] > mx) mx = ctx->tmax[t];
+    }
+    radix_plan_init(&ctx->plan, type, bits, mx);
+
+    size_t had = ctx->scratch_bytes;
+    if (reserve(&ctx->scratch, &ctx->scratch_bytes, n * ctx->elem) != 0 ||
+        reserve((void **)&ctx->hist, &ctx->hist_bytes,
+                (size_t)2 * ctx->threads * ctx->plan.buckets * sizeof(size_t)) != 0 ||
+        (vals && reserve(&ctx->vscratch, &ctx->vscratch_bytes, n * sizeof(uint32_t)) != 0))
+        return -1;
+    if (ctx->threads > 1 && ctx->scratch_bytes != had)   // new scratch: place every slice by its thread
+        first_touch(ctx, ctx->scratch, NULL, n, ctx->elem);
+    ctx->out  = ctx->scratch;
+    ctx->vout = vals ? (uint32_t *)ctx->vscratch : NULL;   // passes swap vals / vout, both must be NULL for keys only
+    ctx->wc_on = 0;                  // lsd_run turns it on for key-only sorts
+    return 0;
+}
+
+// After radix_ctx_prepare: counts every digit position, drops the trivial passes and runs the rest.
+static int lsd_run(radix_ctx *ctx) {
+    const radix_plan *p = &ctx->plan;
+    size_t rows = (size_t)p->passes * p->buckets;
+    ctx->passes_run = ctx->passes_skipped = 0;
+    if (p->passes == 0) return 0;
+    if (reserve((void **)&ctx->dhist, &ctx->dhist_bytes, (ctx->threads + 1) * rows * sizeof(size_t)) != 0)
+        return -1;
+    if (!ctx->vals && radix_get_scatter() == RADIX_SCATTER_WC) {
+        if (ctx->wc_buckets < p->buckets) {
+            free(ctx->wc);
+            ctx->wc = radix_wc_alloc(p->buckets, ctx->threads);
+            ctx->wc_buckets = ctx->wc ? p->buckets : 0;
+            if (!ctx->wc) return -1;
+        }
+        ctx->wc_on = 1;
+    }
+
+    radix_ctx_run(ctx, digit_count_job);
+    size_t *total = digit_counts(ctx, ctx->threads);
+    memcpy(total, digit_counts(ctx, 0), rows * sizeof(size_t));
+    for (int t = 1; t < ctx->threads; t++) {
+        const size_t *h = digit_counts(ctx, t);
+        for (size_t i = 0; i < rows; i++) total[i] += h[i];
+    }
+    ctx->passes_skipped = radix_plan_skip_trivial(&ctx->plan, total, ctx->n);
+    ctx->passes_run     = p->passes - ctx->passes_skipped;
+    if (ctx->passes_run > 0)
+        radix_ctx_run(ctx, lsd_job);
+    return 0;
+}
+
+static int lsd_sort(radix_ctx *ctx, void *a, size_t n, radix_key_type type, int bits,
+                    const uint64_t *max_key) {
+    radix_plan plan;
+    if (radix_plan_init(&plan, type, bits, 0) != 0) return -1;
+    if (n <= 1) return 0;
+
+    /* Adaptive trick: for tiny n, skip the pool entirely */
+    if (n <= ctx->seq_cutoff || ctx->threads == 1)
+        return radix_sort(a, n, type, bits);
+
+    // Without a known bound every digit position is counted; the ones above the largest key come out trivial
+    uint64_t full = radix_key_max(type);
+    pthread_mutex_lock(&ctx->sort_lock);
+    int rc = radix_ctx_prepare(ctx, a, NULL, n, type, bits, max_key ? max_key : &full);
+    if (rc == 0)
+        rc = lsd_run(ctx);
+    pthread_mutex_unlock(&ctx->sort_lock);
+    return rc;
+}
+
+int radix_ctx_sort(radix_ctx *ctx, void *a, size_t n, radix_key_type type, int bits) {
+    return lsd_sort(ctx, a, n, type, bits, NULL);
+}
+
+int radix_ctx_sort_bounded(radix_ctx *ctx, void *a, size_t n, radix_key_type type, int bits,
+                           uint64_t max_key) {
+    return lsd_sort(ctx, a, n, type, bits, &max_key);
+}
+
+int radix_ctx_sort_pairs(radix_ctx *ctx, void *keys, uint32_t *values, size_t n,
+                         radix_key_type type, int bits) {
+    radix_plan plan;
+    if (radix_plan_init(&plan, type, bits, 0) != 0) return -1;
+    if (n <= 1) return 0;
+
+    if (n <= ctx->seq_cutoff || ctx->threads == 1)
+        return radix_sort_pairs(keys, values, n, type, bits);
+
+    uint64_t full = radix_key_max(type);
+    pthread_mutex_lock(&ctx->sort_lock);
+    int rc = radix_ctx_prepare(ctx, keys, values, n, type, bits, &full);
+    if (rc == 0)
+        rc = lsd_run(ctx);
+    ctx->vals = NULL;
+    pthread_mutex_unlock(&ctx->sort_lock);
+    return rc;
+}
+
+int radix_ctx_argsort(radix_ctx *ctx, const void *keys, uint32_t *perm, size_t n,
+                      radix_key_type type, int bits) {
+    radix_plan plan;
+    if (radix_plan_init(&plan, type, bits, 0) != 0 || n > UINT32_MAX) return -1;
+
+    size_t bytes = n * (size_t)(radix_key_width(type) / 8);
+    void *copy = malloc(bytes ? bytes : 1);
+    if (!copy) return -1;
+    memcpy(copy, keys, bytes);
+    for (size_t i = 0; i < n; i++) perm[i] = (uint32_t)i;
+
+    int rc = radix_ctx_sort_pairs(ctx, copy, perm, n, type, bits);
+    free(copy);
+    return rc;
+}
@@ -0,0 +1,115 @@
+// radix_ctx.h - reusable pthreads sort context: a long-lived worker pool plus its scratch buffers
+#ifndef RADIX_CTX_H
+#define RADIX_CTX_H
+
+#include <stddef.h>
+#include "radix_core.h"
+#include "radix_barrier.h"
+#include "radix_topo.h"
+
+// All state of one sorter lives in the context (no globals), so independent
+// contexts can sort at the same time. Calls on the same context are serialized.
+typedef struct radix_ctx radix_ctx;
+
+typedef struct {
+    int    threads;      // participating threads, the calling thread included (0 = 4)
+    size_t seq_cutoff;   // n <= seq_cutoff skips the pool and runs the sequential core
+    radix_barrier_kind barrier;   // barrier crossed twice per pass (default RADIX_BARRIER_SPIN)
+    radix_pin_kind pin;  // RADIX_PIN_NONE (default), or pin tid t to its CPU in radix_topo_assign
+                         // order - the calling thread (tid 0) included, for as long as it lives
+} radix_ctx_config;
+
+#define RADIX_CTX_DEFAULT_THREADS     4
+#define RADIX_CTX_DEFAULT_SEQ_CUTOFF  2000
+
+// Fills *cfg with the defaults above.
+void radix_ctx_config_init(radix_ctx_config *cfg);
+
+// Starts threads - 1 workers that stay parked until the context is destroyed.
+// cfg may be NULL for the defaults. Returns NULL on failure.
+radix_ctx *radix_ctx_create(const radix_ctx_config *cfg);
+
+// Sorts n elements of 'type' in place with 'bits'-wide digits (RADIX_DECIMAL, 8, 11, 16).
+// One parallel read counts every digit position per thread, passes where all keys share the
+// digit are skipped, and the first pass that runs reuses those counts.
+// Scratch buffers are kept between calls and only grow. Returns 0, or -1 on bad bits / no memory.
+int radix_ctx_sort(radix_ctx *ctx, void *a, size_t n, radix_key_type type, int bits);
+
+// Same, for callers that already know the largest key (radix_key32/64 of the largest value,
+// e.g. from radix_load_stats): only the digit positions below it are counted. A smaller
+// max_key than the real one leaves the array unsorted.
+int radix_ctx_sort_bounded(radix_ctx *ctx, void *a, size_t n, radix_key_type type, int bits,
+                           uint64_t max_key);
+
+// Key-value and argsort on the pool (see radix_sort_pairs / radix_argsort in radix_core.h).
+int radix_ctx_sort_pairs(radix_ctx *ctx, void *keys, uint32_t *values, size_t n,
+                         radix_key_type type, int bits);
+int radix_ctx_argsort(radix_ctx *ctx, const void *keys, uint32_t *perm, size_t n,
+                      radix_key_type type, int bits);
+
+// Same contract as radix_ctx_sort, MSD order (radix_msd.c): the pool partitions on the top digit, buckets still
+// larger than n / (4 * threads) are partitioned again together, the rest are sorted as tasks
+// that idle threads steal. Small buckets finish with insertion sort or sequential counting sorts.
+int radix_ctx_sort_msd(radix_ctx *ctx, void *a, size_t n, radix_key_type type, int bits);
+
+// Direct counting sort on the pool (radix_count.c): per-thread counts of every value in
+// [min_key, max_key], start slots summed by value chunks, then every thread writes its own slice
+// of the output. Same bounds and return values as radix_count_sort; ranges wider than
+// n / threads values run sequentially.
+int radix_ctx_sort_counting(radix_ctx *ctx, void *a, size_t n, radix_key_type type,
+                            uint64_t min_key, uint64_t max_key);
+
+// Picks counting, LSD or MSD with radix_choose_path and runs it on the pool (radix_count.c).
+// minmax holds the smallest and largest key when the caller knows them (e.g. from
+// radix_load_stats), NULL for a parallel scan. *used (may be NULL) gets the path taken.
+int radix_ctx_sort_auto(radix_ctx *ctx, void *a, size_t n, radix_key_type type, int bits,
+                        const uint64_t *minmax, radix_path *used);
+
+// Radix-select and top-k on the pool (radix_select.c), same results and return values as
+// radix_select_key / radix_select / radix_topk. Each level every thread counts its slice of
+// the candidates and copies its ones in the kept bucket to its slots of the next buffer; once
+// at most seq_cutoff are left, the calling thread finishes alone.
+int radix_ctx_select_key(radix_ctx *ctx, const void *a, size_t n, radix_key_type type, size_t k,
+                         uint64_t *key);
+int radix_ctx_select(radix_ctx *ctx, const void *a, size_t n, radix_key_type type, size_t k, void *out);
+int radix_ctx_topk(radix_ctx *ctx, const void *a, size_t n, radix_key_type type, size_t k, int largest,
+                   void *out);
+
+// radix_sort_segments on the pool (radix_segments.c): threads claim chunks of segments and
+// sort each one alone with their own scratch. Segments holding more than n / threads keys
+// (and more than seq_cutoff) are sorted afterwards by the whole pool, one after the other.
+int radix_ctx_sort_segments(radix_ctx *ctx, void *a, const size_t *offsets, size_t segments,
+                            radix_key_type type, int bits);
+
+// In-place MSD on the pool (radix_inplace.c), same contract as radix_ctx_sort but without the
+// n-element scratch buffer: only O(buckets x threads) counts are allocated. Ranges larger than
+// n / threads are partitioned by every thread: each takes a stripe of every bucket and swaps
+// elements home while its stripes have room, then the leftovers of each bucket are moved to its
+// end and the next round stripes only those (a round that places nothing more runs on one
+// thread, which places everything). Smaller buckets are claimed as tasks and sorted alone with
+// radix_flag_sort.
+int radix_ctx_sort_inplace(radix_ctx *ctx, void *a, size_t n, radix_key_type type, int bits);
+
+// Fills dst[0, n) (n elements of elem bytes) from src, or with zeros when src is NULL,
+// each participant writing the slice it sorts. With pinned threads (cfg.pin) the pages
+// of every slice are first touched, so placed, on the node of the thread that works on
+// it. The pool's own scratch buffer is placed the same way whenever it grows.
+void radix_ctx_first_touch(radix_ctx *ctx, void *dst, const void *src, size_t n, size_t elem);
+
+// Digit passes of the last LSD sort that ran on the pool: *run scattered, *skipped left out
+// because every key had the same digit there. Both 0 before the first one.
+void radix_ctx_pass_stats(const radix_ctx *ctx, int *run, int *skipped);
+
+// Stops and joins the workers and frees the scratch buffers.
+void radix_ctx_destroy(radix_ctx *ctx);
+
+// Frees the n-element scratch buffers kept between sorts (the next LSD sort allocates them
+// again), e.g. before in-place sorts on a host short of memory.
+void radix_ctx_release(radix_ctx *ctx);
+
+int radix_ctx_threads(const radix_ctx *ctx);
+radix_barrier_kind radix_ctx_barrier(const radix_ctx *ctx);
+// CPU that tid is pinned to, -1 without pinning.
+int radix_ctx_cpu(const radix_ctx *ctx, int tid);
+
+#endif
@@ -0,0 +1,100 @@
+// radix_ctx_impl.h - radix_ctx internals shared by the engines that run on the pool
+// (radix_ctx.c for LSD, radix_msd.c for MSD, radix_count.c, radix_select.c, radix_segments.c,
+// radix_inplace.c).
+// Not part of the public API.
+#ifndef RADIX_CTX_IMPL_H
+#define RADIX_CTX_IMPL_H
+
+#include <pthread.h>
+#include "radix_ctx.h"
+
+typedef void (*radix_job)(radix_ctx *ctx, int tid);
+
+typedef struct {
+    radix_ctx *ctx;
+    int tid;
+} radix_worker_arg;
+
+struct radix_ctx {
+    int    threads;          // participants, the calling thread is tid 0
+    size_t seq_cutoff;
+    pthread_t        *workers;   // threads - 1 pool threads (tid 1 ...)
+    radix_worker_arg *args;
+    pthread_mutex_t sort_lock;   // one sort at a time on a given context
+    int              *cpu;       // per tid: pinned CPU (NULL without pinning)
+
+    radix_barrier barrier;   // every participant must arrive before any can proceed
+
+    radix_job job;           // work for the current round, NULL tells the workers to exit
+    void     *job_data;      // engine-specific state of the current round
+
+    // Current sort
+    void  *arr;
+    void  *out;
+    uint32_t *vals;          // values moving with the keys (NULL for a plain sort)
+    uint32_t *vout;
+    size_t lo;               // jobs work on [lo, lo + n) of arr / out
+    size_t n;
+    size_t elem;             // bytes per element
+    radix_plan plan;
+    uint64_t *tmax;          // per-thread largest key
+
+    // Scratch kept between sorts (only grows)
+    void   *scratch;
+    size_t  scratch_bytes;
+    void   *vscratch;
+    size_t  vscratch_bytes;
+    size_t *hist;            // per thread: local_count[buckets] followed by offset[buckets]
+    size_t  hist_bytes;
+    size_t *dhist;           // LSD: per thread, then the total: passes * buckets counts of every digit
+    size_t  dhist_bytes;
+    void   *wc;              // LSD write-combining scatter: one staging area per thread
+    uint32_t wc_buckets;     // buckets the areas are sized for (0 = none yet)
+    int     wc_on;           // current sort scatters through wc (radix_get_scatter at its start)
+
+    int passes_run;          // last LSD sort on the pool (radix_ctx_pass_stats)
+    int passes_skipped;
+};
+
+// Posts 'job' to every worker, runs it as tid 0 and returns when all have finished.
+void radix_ctx_run(radix_ctx *ctx, radix_job job);
+
+// Barrier among all participants of the running job.
+void radix_ctx_wait(radix_ctx *ctx);
+
+// tid's share of [ctx->lo, ctx->lo + ctx->n) (balanced: base + remainder).
+void radix_ctx_slice(const radix_ctx *ctx, int tid, size_t *lo, size_t *hi);
+
+// Points the context at a[0, n) (and vals[0, n) if not NULL), builds ctx->plan from the
+// largest key (*max_key, or a parallel scan when max_key is NULL) and makes sure scratch
+// and histograms are big enough. Caller holds sort_lock. Returns -1 on bad bits or no memory.
+int radix_ctx_prepare(radix_ctx *ctx, void *a, uint32_t *vals, size_t n, radix_key_type type, int bits,
+                      const uint64_t *max_key);
+
+// Smallest and largest key of a[0, n), each participant scanning its slice (radix_count.c).
+// Points the context at a. Caller holds sort_lock.
+void radix_ctx_key_range(radix_ctx *ctx, const void *a, size_t n, radix_key_type type,
+                         uint64_t *mn, uint64_t *mx);
+
+// Histogram / offset rows of thread 'tid' for the current plan.
+static inline size_t *radix_ctx_count(radix_ctx *ctx, int tid) {
+    return ctx->hist + (size_t)(2 * tid) * ctx->plan.buckets;
+}
+static inline size_t *radix_ctx_offset(radix_ctx *ctx, int tid) {
+    return radix_ctx_count(ctx, tid) + ctx->plan.buckets;
+}
+
+// radix_ctx_pass flag (next to RADIX_PASS_FIRST / LAST): my count row already holds this
+// pass's histogram of my slice, so the counting step is left out.
+#define RADIX_CTX_COUNTED  4
+
+// One parallel counting-sort pass over [ctx->lo, ctx->lo + ctx->n): count my slice,
+// scan offsets, scatter. from = 0 reads arr and writes out, from = 1 reads out and
+// writes arr (values move between vals and vout the same way). Ends on a barrier, so
+// the destination holds the whole pass. Every participant must call it.
+void radix_ctx_pass(radix_ctx *ctx, int tid, int pass, int flags, int from);
+
+// Copies my slice of out (and vout) back to arr (vals). No barrier.
+void radix_ctx_copy_back(radix_ctx *ctx, int tid, int pass);
+
+#endif
@@ -0,0 +1,438 @@
+// radix_ext.c - out-of-core sort: radix-sorted runs on disk, then double-buffered k-way merges
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "radix_ext.h"
+#include "radix_bin.h"
+#include "radix_ctx.h"
+
+#define EXT_MIN_BLOCK  4096   // smallest merge buffer in bytes; a smaller budget lowers the fan-in instead
+
+void radix_ext_config_init(radix_ext_config *cfg) {
+    cfg->mem_budget = RADIX_EXT_DEFAULT_BUDGET;
+    cfg->threads    = RADIX_CTX_DEFAULT_THREADS;
+    cfg->bits       = 11;
+    cfg->tmp_dir    = NULL;
+}
+
+static double now_secs(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec + t.tv_nsec / 1e9;
+}
+
+// Full pread / pwrite (short transfers are retried). Returns 0 or -1 with errno set.
+static int io_full(int write, int fd, void *buf, size_t bytes, off_t off) {
+    char *p = (char *)buf;
+    while (bytes > 0) {
+        ssize_t k = write ? pwrite(fd, p, bytes, off) : pread(fd, p, bytes, off);
+        if (k < 0 && errno == EINTR) continue;
+        if (k <= 0) { if (k == 0) errno = EIO; return -1; }
+        p += k; bytes -= (size_t)k; off += k;
+    }
+    return 0;
+}
+
+/* ---------- I/O thread ---------- */
+// One thread runs every read and write of a merge in submission order, so the
+// merge loop only blocks when the buffer it needs next has not arrived yet.
+typedef struct {
+    int    write;
+    int    fd;
+    void  *buf;
+    size_t bytes;
+    off_t  off;
+    int    pending;        // queued or running
+} io_req;
+
+typedef struct {
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t  work, done;
+    io_req **queue;        // ring of cap requests
+    int cap, head, count;
+    int stop;
+    int err;               // first errno seen, reported by io_wait
+} io_thread;
+
+static void *io_main(void *arg) {
+    io_thread *io = (io_thread *)arg;
+    pthread_mutex_lock(&io->lock);
+    for (;;) {
+        while (io->count == 0 && !io->stop) pthread_cond_wait(&io->work, &io->lock);
+        if (io->count == 0) break;
+        io_req *r = io->queue[io->head];
+        io->head = (io->head + 1) % io->cap;
+        io->count--;
+        pthread_mutex_unlock(&io->lock);
+
+        int rc = io_full(r->write, r->fd, r->buf, r->bytes, r->off);
+        int e  = errno;
+
+        pthread_mutex_lock(&io->lock);
+        if (rc != 0 && !io->err) io->err = e;
+        r->pending = 0;
+        pthread_cond_broadcast(&io->done);
+    }
+    pthread_mutex_unlock(&io->lock);
+    return NULL;
+}
+
+static int io_start(io_thread *io, int cap) {
+    memset(io, 0, sizeof(*io));
+    io->cap   = cap;
+    io->queue = malloc((size_t)cap * sizeof(io_req *));
+    if (!io->queue) return -1;
+    pthread_mutex_init(&io->lock, NULL);
+    pthread_cond_init(&io->work, NULL);
+    pthread_cond_init(&io->done, NULL);
+    if (pthread_create(&io->thread, NULL, io_main, io) != 0) {
+        free(io->queue);
+        return -1;
+    }
+    return 0;
+}
+
+static void io_stop(io_thread *io) {
+    pthread_mutex_lock(&io->lock);
+    io->stop = 1;
+    pthread_cond_signal(&io->work);
+    pthread_mutex_unlock(&io->lock);
+    pthread_join(io->thread, NULL);
+    pthread_mutex_destroy(&io->lock);
+    pthread_cond_destroy(&io->work);
+    pthread_cond_destroy(&io->done);
+    free(io->queue);
+}
+
+static void io_submit(io_thread *io, io_req *r, int write, int fd, void *buf, size_t bytes, off_t off) {
+    r->write = write; r->fd = fd; r->buf = buf; r->bytes = bytes; r->off = off;
+    pthread_mutex_lock(&io->lock);
+    r->pending = 1;
+    io->queue[(io->head + io->count) % io->cap] = r;
+    io->count++;
+    pthread_cond_signal(&io->work);
+    pthread_mutex_unlock(&io->lock);
+}
+
+// Waits for r (if it was ever submitted). Returns -1 once any request has failed.
+static int io_wait(io_thread *io, io_req *r) {
+    pthread_mutex_lock(&io->lock);
+    while (r->pending) pthread_cond_wait(&io->done, &io->lock);
+    int err = io->err;
+    pthread_mutex_unlock(&io->lock);
+    if (err) { errno = err; return -1; }
+    return 0;
+}
+
+/* ---------- Merge ---------- */
+typedef struct {
+    uint64_t off, len;     // values [off, off + len) of the source file's data area
+} ext_run;
+
+typedef struct {
+    char    *buf[2];
+    io_req   req[2];
+    uint64_t have[2];      // values requested into buf[b] (0 = empty)
+    uint64_t next;         // next value of the run not yet requested
+    uint64_t end;
+    int      cur;
+    uint64_t pos;          // position in buf[cur]
+} run_in;
+
+typedef struct {
+    uint64_t key;
+    int      run;
+} heap_node;
+
+typedef struct {
+    io_thread io;
+    radix_key_type type;
+    size_t   elem;
+    uint64_t blk;          // values per buffer
+    char    *mem;          // (2 * fan_in + 2) buffers of blk values
+    run_in  *in;
+    heap_node *heap;
+    io_req   oreq[2];      // output blocks: here, not on merge_runs' stack, as the I/O thread may still hold one
+} merger;
+
+static uint64_t key_at(const merger *m, const char *p) {
+    if (m->elem == 4) { uint32_t v; memcpy(&v, p, 4); return radix_key32(m->type, v); }
+    uint64_t v; memcpy(&v, p, 8);
+    return radix_key64(m->type, v);
+}
+
+static void run_request(merger *m, run_in *r, int b, int fd, off_t base) {
+    uint64_t k = r->end - r->next < m->blk ? r->end - r->next : m->blk;
+    r->have[b] = k;
+    if (k == 0) return;
+    io_submit(&m->io, &r->req[b], 0, fd, r->buf[b], k * m->elem, base + (off_t)(r->next * m->elem));
+    r->next += k;
+}
+
+static void sift_down(heap_node *h, int n, int i) {
+    heap_node x = h[i];
+    for (;;) {
+        int c = 2 * i + 1;
+        if (c >= n) break;
+        if (c + 1 < n && h[c + 1].key < h[c].key) c++;
+        if (h[c].key >= x.key) break;
+        h[i] = h[c];
+        i = c;
+    }
+    h[i] = x;
+}
+
+// After a failed request: waits for every request of the merge still queued, so the I/O
+// thread is done with its buffers and requests once merge_runs returns. Keeps errno.
+static int merge_fail(merger *m, int g) {
+    int e = errno;
+    for (int i = 0; i < g; i++) {
+        io_wait(&m->io, &m->in[i].req[0]);
+        io_wait(&m->io, &m->in[i].req[1]);
+    }
+    io_wait(&m->io, &m->oreq[0]);
+    io_wait(&m->io, &m->oreq[1]);
+    errno = e;
+    return -1;
+}
+
+// Merges g runs of src into dst starting at value dst_at. Returns 0 or -1.
+static int merge_runs(merger *m, const ext_run *runs, int g, int src, off_t src_base,
+                      int dst, off_t dst_base, uint64_t dst_at) {
+    size_t e = m->elem;
+    int hn = 0;
+    for (int i = 0; i < g; i++) {
+        run_in *r = &m->in[i];
+        memset(r->req, 0, sizeof(r->req));
+        r->buf[0] = m->mem + (size_t)(2 * i) * m->blk * e;
+        r->buf[1] = r->buf[0] + m->blk * e;
+        r->next = runs[i].off;
+        r->end  = runs[i].off + runs[i].len;
+        r->cur  = 0;
+        r->pos  = 0;
+        run_request(m, r, 0, src, src_base);
+        run_request(m, r, 1, src, src_base);   // prefetch
+    }
+    for (int i = 0; i < g; i++) {
+        run_in *r = &m->in[i];
+        if (io_wait(&m->io, &r->req[0]) != 0) return merge_fail(m, g);
+        if (r->have[0] == 0) continue;
+        m->heap[hn].key = key_at(m, r->buf[0]);
+        m->heap[hn].run = i;
+        hn++;
+    }
+    for (int i = hn / 2 - 1; i >= 0; i--) sift_down(m->heap, hn, i);
+
+    char *obuf[2] = { m->mem + (size_t)(2 * g) * m->blk * e, m->mem + (size_t)(2 * g + 1) * m->blk * e };
+    io_req *oreq = m->oreq;
+    memset(oreq, 0, sizeof(m->oreq));
+    int oc = 0;
+    uint64_t opos = 0;
+
+    while (hn > 0) {
+        run_in *r = &m->in[m->heap[0].run];
+        memcpy(obuf[oc] + opos * e, r->buf[r->cur] + r->pos * e, e);
+        if (++opos == m->blk) {
+            io_submit(&m->io, &oreq[oc], 1, dst, obuf[oc], opos * e, dst_base + (off_t)(dst_at * e));
+            dst_at += opos;
+            opos = 0;
+            oc ^= 1;
+            if (io_wait(&m->io, &oreq[oc]) != 0) return merge_fail(m, g);   // buffer written two blocks ago
+        }
+
+        if (++r->pos == r->have[r->cur]) {
+            // Buffer used up: switch to the prefetched one and refill this one behind it
+            int used = r->cur;
+            r->have[used] = 0;
+            r->cur ^= 1;
+            r->pos = 0;
+            if (io_wait(&m->io, &r->req[r->cur]) != 0) return merge_fail(m, g);
+            if (r->have[r->cur] == 0) {               // run finished
+                m->heap[0] = m->heap[--hn];
+                if (hn > 0) sift_down(m->heap, hn, 0);
+                continue;
+            }
+            run_request(m, r, used, src, src_base);
+        }
+        m->heap[0].key = key_at(m, r->buf[r->cur] + r->pos * e);
+        sift_down(m->heap, hn, 0);
+    }
+
+    if (opos > 0)
+        io_submit(&m->io, &oreq[oc], 1, dst, obuf[oc], opos * e, dst_base + (off_t)(dst_at * e));
+    if (io_wait(&m->io, &oreq[0]) != 0 || io_wait(&m->io, &oreq[1]) != 0) return merge_fail(m, g);
+    return 0;
+}
+
+/* ---------- Sort ---------- */
+static int tmp_file(const char *dir) {
+    char path[4096];
+    if ((size_t)snprintf(path, sizeof(path), "%.4000s/radix_ext_XXXXXX", dir) >= sizeof(path)) {
+        errno = ENAMETOOLONG;
+        return -1;
+    }
+    int fd = mkstemp(path);
+    if (fd >= 0) unlink(path);   // removed as soon as it is closed
+    return fd;
+}
+
+static int write_header(int fd, radix_key_type type, uint64_t n, size_t elem) {
+    radix_bin_header h;
+    uint64_t minmax[2] = { 0, 0 };
+    if (n > 0 &&
+        (io_full(0, fd, &minmax[0], elem, RADIX_BIN_HEADER_SIZE) != 0 ||
+         io_full(0, fd, &minmax[1], elem, RADIX_BIN_HEADER_SIZE + (off_t)((n - 1) * elem)) != 0))
+        return -1;
+    radix_bin_header_init(&h, type, (size_t)n, n > 0 ? minmax : NULL);
+    return io_full(1, fd, &h, sizeof(h), 0);
+}
+
+int radix_ext_sort(const char *in_path, const char *out_path, const radix_ext_config *cfg,
+                   radix_ext_stats *st) {
+    radix_ext_config def;
+    if (!cfg) { radix_ext_config_init(&def); cfg = &def; }
+    radix_ext_stats local;
+    if (!st) st = &local;
+    memset(st, 0, sizeof(*st));
+
+    int in = -1, out = -1, tmp[2] = { -1, -1 }, rc = -1, saved = 0;
+    void *buf = NULL;
+    ext_run *runs = NULL;
+    radix_ctx *ctx = NULL;
+    merger m;
+    memset(&m, 0, sizeof(m));
+    int io_running = 0;
+
+    in = open(in_path, O_RDONLY);
+    if (in < 0) return -1;
+    struct stat sb;
+    radix_bin_header h;
+    if (fstat(in, &sb) != 0 || io_full(0, in, &h, sizeof(h), 0) != 0) goto done;
+    size_t e = radix_bin_check(&h, (uint64_t)sb.st_size);
+    if (e == 0) { errno = EINVAL; goto done; }
+    radix_key_type type = (radix_key_type)h.type;
+    uint64_t n = h.count;
+    st->count = (size_t)n;
+
+    out = open(out_path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (out < 0) goto done;
+
+    // Phase 1 budget: chunk + the pool's scratch of the same size
+    uint64_t chunk = cfg->mem_budget / (2 * e);
+    if (chunk < EXT_MIN_BLOCK / e) chunk = EXT_MIN_BLOCK / e;
+    if (chunk > n) chunk = n ? n : 1;
+
+    radix_ctx_config cc;
+    radix_ctx_config_init(&cc);
+    cc.threads = cfg->threads;
+    ctx = radix_ctx_create(&cc);
+    buf = malloc(chunk * e);
+    if (!ctx || !buf) { errno = ENOMEM; goto done; }
+
+    uint64_t nruns = n ? (n + chunk - 1) / chunk : 0;
+    st->runs = (size_t)nruns;
+    runs = malloc((nruns ? nruns : 1) * sizeof(ext_run));
+    if (!runs) { errno = ENOMEM; goto done; }
+
+    // A single run goes straight to the output
+    const char *dir = cfg->tmp_dir;
+    char outdir[4096];
+    if (!dir) {
+        snprintf(outdir, sizeof(outdir), "%.4000s", out_path);
+        char *slash = strrchr(outdir, '/');
+        if (slash) *(slash == outdir ? slash + 1 : slash) = '\0';
+        else       snprintf(outdir, sizeof(outdir), ".");
+        dir = outdir;
+    }
+    int run_fd = out;
+    off_t run_base = RADIX_BIN_HEADER_SIZE;
+    if (nruns > 1) {
+        if ((tmp[0] = tmp_file(dir)) < 0) goto done;
+        run_fd = tmp[0];
+        run_base = 0;
+    }
+
+    double t0 = now_secs();
+    for (uint64_t r = 0; r < nruns; r++) {
+        uint64_t off = r * chunk, len = n - off < chunk ? n - off : chunk;
+        if (io_full(0, in, buf, len * e, RADIX_BIN_HEADER_SIZE + (off_t)(off * e)) != 0) goto done;
+        if (radix_ctx_sort(ctx, buf, (size_t)len, type, cfg->bits) != 0) { errno = EINVAL; goto done; }
+        if (io_full(1, run_fd, buf, len * e, run_base + (off_t)(off * e)) != 0) goto done;
+        runs[r].off = off;
+        runs[r].len = len;
+    }
+    st->run_secs = now_secs() - t0;
+    free(buf); buf = NULL;
+    radix_ctx_destroy(ctx); ctx = NULL;
+
+    // Phase 2: merge groups of fan_in runs until one is left; the last pass writes the output
+    t0 = now_secs();
+    int fan_in = (int)(cfg->mem_budget / EXT_MIN_BLOCK / 2) - 1;
+    if (fan_in < 2) fan_in = 2;
+    if ((uint64_t)fan_in > nruns) fan_in = (int)nruns;
+    st->fan_in = nruns > 1 ? fan_in : 0;
+
+    if (nruns > 1) {
+        size_t blk_bytes = cfg->mem_budget / (size_t)(2 * fan_in + 2);
+        if (blk_bytes < EXT_MIN_BLOCK) blk_bytes = EXT_MIN_BLOCK;
+        m.type = type;
+        m.elem = e;
+        m.blk  = blk_bytes / e;
+        m.mem  = malloc((size_t)(2 * fan_in + 2) * m.blk * e);
+        m.in   = malloc((size_t)fan_in * sizeof(run_in));
+        m.heap = malloc((size_t)fan_in * sizeof(heap_node));
+        if (!m.mem || !m.in || !m.heap || io_start(&m.io, 2 * fan_in + 2) != 0) { errno = ENOMEM; goto done; }
+        io_running = 1;
+    }
+
+    int src = 0;
+    while (nruns > 1) {
+        int last = nruns <= (uint64_t)fan_in;
+        int dst_fd = out;
+        off_t dst_base = RADIX_BIN_HEADER_SIZE;
+        if (!last) {
+            if (tmp[src ^ 1] < 0 && (tmp[src ^ 1] = tmp_file(dir)) < 0) goto done;
+            dst_fd = tmp[src ^ 1];
+            dst_base = 0;
+        }
+        uint64_t merged = 0;
+        for (uint64_t r = 0; r < nruns; r += (uint64_t)fan_in) {
+            int g = nruns - r < (uint64_t)fan_in ? (int)(nruns - r) : fan_in;
+            if (merge_runs(&m, runs + r, g, tmp[src], 0, dst_fd, dst_base, runs[r].off) != 0) goto done;
+            uint64_t len = 0;
+            for (int i = 0; i < g; i++) len += runs[r + i].len;
+            runs[merged].off = runs[r].off;   // groups stay where their first run was
+            runs[merged].len = len;
+            merged++;
+        }
+        nruns = merged;
+        src ^= 1;
+        st->merge_passes++;
+    }
+    st->merge_secs = now_secs() - t0;
+
+    if (write_header(out, type, n, e) != 0) goto done;
+    if (ftruncate(out, RADIX_BIN_HEADER_SIZE + (off_t)(n * e)) != 0) goto done;
+    rc = 0;
+
+done:
+    saved = errno;
+    if (io_running) io_stop(&m.io);
+    free(m.mem); free(m.in); free(m.heap);
+    free(buf);
+    free(runs);
+    if (ctx) radix_ctx_destroy(ctx);
+    if (tmp[0] >= 0) close(tmp[0]);
+    if (tmp[1] >= 0) close(tmp[1]);
+    if (out >= 0 && close(out) != 0 && rc == 0) { rc = -1; saved = errno; }
+    if (in >= 0) close(in);
+    errno = saved;
+    return rc;
+}
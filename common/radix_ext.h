@@ -0,0 +1,41 @@
+// radix_ext.h - external-memory sort of binary datasets (radix_bin.h) larger than the memory budget
+#ifndef RADIX_EXT_H
+#define RADIX_EXT_H
+
+#include <stddef.h>
+#include "radix_core.h"
+
+typedef struct {
+    size_t mem_budget;     // bytes for sort and merge buffers together
+    int    threads;        // radix_ctx pool size used to sort each run
+    int    bits;           // digit width (RADIX_DECIMAL, 8, 11, 16)
+    const char *tmp_dir;   // run files go here (NULL = the output file's directory)
+} radix_ext_config;
+
+#define RADIX_EXT_DEFAULT_BUDGET  ((size_t)256 << 20)
+
+typedef struct {
+    size_t count;          // values sorted
+    size_t runs;           // sorted runs written by phase 1 (1 = fitted in memory)
+    int    merge_passes;   // k-way merge passes (0 when it fitted)
+    int    fan_in;         // runs merged at once
+    double run_secs;       // read + sort + write of the runs
+    double merge_secs;
+} radix_ext_stats;
+
+// Fills *cfg with: RADIX_EXT_DEFAULT_BUDGET, 4 threads, 11-bit digits, tmp_dir NULL.
+void radix_ext_config_init(radix_ext_config *cfg);
+
+// Sorts the binary dataset in_path into out_path without holding more than about
+// cfg->mem_budget bytes of data in memory:
+//   1. chunks of budget / (2 * value size) values are read, sorted on a radix_ctx pool
+//      and written to an unlinked run file;
+//   2. the runs are k-way merged through a min-heap. Every run has two buffers: one is
+//      merged while an I/O thread reads the next block into the other; the output is
+//      double-buffered the same way. If the budget cannot give every run two blocks of
+//      at least 4 KB, runs are merged in groups and merging takes several passes.
+// cfg and st may be NULL. Returns 0, or -1 with errno set.
+int radix_ext_sort(const char *in_path, const char *out_path, const radix_ext_config *cfg,
+                   radix_ext_stats *st);
+
+#endif
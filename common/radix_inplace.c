@@ -0,0 +1,223 @@
+// radix_inplace.c - in-place MSD on the radix_ctx pool: striped parallel partitions of the
+// large ranges, American flag sort of the buckets as tasks
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include "radix_ctx_impl.h"
+#include "radix_trace.h"
+
+typedef struct {
+    size_t lo, n;
+    int pass;
+} flag_range;
+
+typedef struct {
+    radix_plan plan;
+    size_t *rows;              // per thread: digit counts of my slice of the range
+    size_t *head, *tail;       // per thread: my stripe of every bucket
+    size_t *lo, *hi;           // per bucket: range still unfinished (lo == hi: done)
+    size_t *end;               // per bucket: end of the bucket in the array
+    size_t *work;              // per thread: radix_flag_sort levels
+    size_t  work_row;          // counts per thread in work
+    flag_range *stack;         // ranges larger than 'big', partitioned by every thread
+    int     depth;
+    size_t  big;
+    flag_range cur;
+    int     done;              // stack empty
+    int     skip;              // cur's keys all share the digit: nothing to move
+    int     stripes;           // threads taking part in this round
+    size_t  left;              // elements out of place before this round
+    int     placed;            // every element of cur is in its bucket
+    atomic_uint next;          // next bucket of cur to claim as a task
+} flag_state;
+
+// tid 0: the bucket counts of cur from the per-thread rows
+static void flag_count(radix_ctx *ctx, flag_state *st) {
+    const radix_plan *p = &st->plan;
+    size_t at = st->cur.lo;
+    st->skip = 0;
+    for (uint32_t d = 0; d < p->buckets; d++) {
+        size_t c = 0;
+        for (int t = 0; t < ctx->threads; t++) c += st->rows[(size_t)t * p->buckets + d];
+        if (c == st->cur.n) st->skip = 1;
+        st->lo[d] = at;
+        at += c;
+        st->hi[d] = st->end[d] = at;
+    }
+    st->stripes = ctx->threads;
+    st->left    = st->cur.n;
+    st->placed  = 0;
+}
+
+// tid 0 after a round: a round that placed nothing more is followed by one with a single
+// stripe per bucket, which places everything
+static void flag_round(flag_state *st) {
+    size_t left = 0;
+    for (uint32_t d = 0; d < st->plan.buckets; d++) left += st->hi[d] - st->lo[d];
+    st->placed = left == 0;
+    if (left >= st->left) st->stripes = 1;
+    st->left = left;
+}
+
+// tid 0 once cur is partitioned: large buckets go on the stack, the rest become tasks
+static void flag_split(flag_state *st) {
+    atomic_store_explicit(&st->next, 0, memory_order_relaxed);
+    if (st->cur.pass == 0) return;
+    size_t lo = st->cur.lo;
+    for (uint32_t d = 0; d < st->plan.buckets; d++) {
+        if (st->end[d] - lo > st->big)
+            st->stack[st->depth++] = (flag_range){ lo, st->end[d] - lo, st->cur.pass - 1 };
+        lo = st->end[d];
+    }
+}
+
+static void flag_histogram(radix_ctx *ctx, flag_state *st, int tid) {
+    const radix_plan *p = &st->plan;
+    size_t *row = st->rows + (size_t)tid * p->buckets, lo, hi;
+    radix_ctx_slice(ctx, tid, &lo, &hi);
+    RADIX_TRACE_START(t0);
+    memset(row, 0, p->buckets * sizeof(size_t));
+    if (p->width == 32) radix_histogram32((const uint32_t *)ctx->arr, lo, hi, p, st->cur.pass, RADIX_PASS_FIRST, row);
+    else                radix_histogram64((const uint64_t *)ctx->arr, lo, hi, p, st->cur.pass, RADIX_PASS_FIRST, row);
+    RADIX_TRACE_STOP(tid, RADIX_PH_HISTOGRAM, st->cur.pass, t0);
+}
+
+// My stripe of every bucket's unfinished range, then carry my elements home
+static void flag_permute(radix_ctx *ctx, flag_state *st, int tid) {
+    const radix_plan *p = &st->plan;
+    size_t *head = st->head + (size_t)tid * p->buckets, *tail = st->tail + (size_t)tid * p->buckets;
+    size_t s = (size_t)st->stripes;
+    for (uint32_t d = 0; d < p->buckets; d++) {
+        size_t n = st->hi[d] - st->lo[d], base = n / s, extra = n % s, t = (size_t)tid;
+        head[d] = st->lo[d] + t * base + (t < extra ? t : extra);
+        tail[d] = head[d] + base + (t < extra);
+    }
+    RADIX_TRACE_START(t0);
+    if (p->width == 32) radix_flag_permute32((uint32_t *)ctx->arr, p, st->cur.pass, head, tail);
+    else                radix_flag_permute64((uint64_t *)ctx->arr, p, st->cur.pass, head, tail);
+    RADIX_TRACE_STOP(tid, RADIX_PH_SCATTER, st->cur.pass, t0);
+}
+
+static void flag_repair(radix_ctx *ctx, flag_state *st, int tid) {
+    const radix_plan *p = &st->plan;
+    RADIX_TRACE_START(t0);
+    for (uint32_t d = (uint32_t)tid; d < p->buckets; d += (uint32_t)ctx->threads) {
+        if (st->lo[d] == st->hi[d]) continue;
+        if (p->width == 32)
+            st->lo[d] = radix_flag_repair32((uint32_t *)ctx->arr, p, st->cur.pass, d, st->head + d, st->tail + d,
+                                            p->buckets, st->stripes, st->hi[d]);
+        else
+            st->lo[d] = radix_flag_repair64((uint64_t *)ctx->arr, p, st->cur.pass, d, st->head + d, st->tail + d,
+                                            p->buckets, st->stripes, st->hi[d]);
+    }
+    RADIX_TRACE_STOP(tid, RADIX_PH_COPY, st->cur.pass, t0);
+}
+
+// Buckets of cur claimed one at a time and sorted alone
+static void flag_tasks(radix_ctx *ctx, flag_state *st, int tid) {
+    const radix_plan *p = &st->plan;
+    size_t *work = st->work + (size_t)tid * st->work_row;
+    uint32_t d;
+    if (st->cur.pass == 0) return;             // the last digit: buckets are sorted already
+    while ((d = atomic_fetch_add_explicit(&st->next, 1, memory_order_relaxed)) < p->buckets) {
+        size_t lo = d ? st->end[d - 1] : st->cur.lo, n = st->end[d] - lo;
+        if (n <= 1 || n > st->big) continue;
+        RADIX_TRACE_START(t0);
+        if (p->width == 32) radix_flag_sort32((uint32_t *)ctx->arr + lo, n, p, st->cur.pass - 1, work);
+        else                radix_flag_sort64((uint64_t *)ctx->arr + lo, n, p, st->cur.pass - 1, work);
+        RADIX_TRACE_STOP(tid, RADIX_PH_TASK, st->cur.pass - 1, t0);
+    }
+}
+
+// Every range on the stack: 1. count my slice  2. rounds of permute + repair until every
+// element is in its bucket  3. push the large buckets, sort the others as tasks
+static void flag_job(radix_ctx *ctx, int tid) {
+    flag_state *st = ctx->job_data;
+    for (;;) {
+        if (tid == 0) {
+            st->done = st->depth == 0;
+            if (!st->done) {
+                st->cur = st->stack[--st->depth];
+                ctx->lo = st->cur.lo;
+                ctx->n  = st->cur.n;
+            }
+        }
+        radix_ctx_wait(ctx);
+        if (st->done) break;
+
+        flag_histogram(ctx, st, tid);
+        radix_ctx_wait(ctx);
+        if (tid == 0) {
+            flag_count(ctx, st);
+            if (st->skip && st->cur.pass > 0)    // same digit everywhere: go on with the next one
+                st->stack[st->depth++] = (flag_range){ st->cur.lo, st->cur.n, st->cur.pass - 1 };
+        }
+        radix_ctx_wait(ctx);
+        if (st->skip) continue;
+
+        while (!st->placed) {
+            if (tid < st->stripes) flag_permute(ctx, st, tid);
+            radix_ctx_wait(ctx);
+            flag_repair(ctx, st, tid);
+            radix_ctx_wait(ctx);
+            if (tid == 0) flag_round(st);
+            radix_ctx_wait(ctx);
+        }
+
+        if (tid == 0) flag_split(st);
+        radix_ctx_wait(ctx);
+        flag_tasks(ctx, st, tid);
+        radix_ctx_wait(ctx);                    // tid 0 reuses the bucket ends for the next range
+    }
+}
+
+int radix_ctx_sort_inplace(radix_ctx *ctx, void *a, size_t n, radix_key_type type, int bits) {
+    radix_plan plan;
+    if (radix_plan_init(&plan, type, bits, 0) != 0) return -1;
+    if (n <= ctx->seq_cutoff || ctx->threads == 1) return radix_sort_inplace(a, n, type, bits);
+
+    pthread_mutex_lock(&ctx->sort_lock);
+    uint64_t mn, mx;
+    radix_ctx_key_range(ctx, a, n, type, &mn, &mx);
+    radix_plan_init(&plan, type, bits, mx);
+    int top = plan.passes - 1;           // highest digit position where the keys differ
+    while (top >= 0) {
+        uint64_t place = bits == RADIX_DECIMAL ? plan.pow10[top] : 0;
+        if (place ? mn / place != mx / place : (mn >> (top * bits)) != (mx >> (top * bits))) break;
+        top--;
+    }
+    if (top < 0) { pthread_mutex_unlock(&ctx->sort_lock); return 0; }   // all keys are equal
+
+    flag_state st;
+    memset(&st, 0, sizeof(st));
+    size_t b = plan.buckets, T = (size_t)ctx->threads;
+    st.plan     = plan;
+    st.work_row = 2 * b * (size_t)(top + 1);
+    st.rows  = malloc(T * b * sizeof(size_t));
+    st.head  = malloc(T * b * sizeof(size_t));
+    st.tail  = malloc(T * b * sizeof(size_t));
+    st.lo    = malloc(3 * b * sizeof(size_t));
+    st.work  = malloc(T * st.work_row * sizeof(size_t));
+    st.stack = malloc((T + 1) * (size_t)(top + 1) * sizeof(flag_range));   // at most T large buckets per level
+    int rc = -1;
+    if (st.rows && st.head && st.tail && st.lo && st.work && st.stack) {
+        st.hi  = st.lo + b;
+        st.end = st.hi + b;
+        st.big = n / T > ctx->seq_cutoff ? n / T : ctx->seq_cutoff;
+        st.stack[st.depth++] = (flag_range){ 0, n, top };
+        ctx->arr  = a;
+        ctx->elem = (size_t)plan.width / 8;
+        ctx->job_data = &st;
+        radix_ctx_run(ctx, flag_job);
+        ctx->job_data = NULL;
+        rc = 0;
+    }
+    pthread_mutex_unlock(&ctx->sort_lock);
+    free(st.rows);
+    free(st.head);
+    free(st.tail);
+    free(st.lo);
+    free(st.work);
+    free(st.stack);
+    return rc;
+}
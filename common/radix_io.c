@@ -0,0 +1,247 @@
+// radix_io.c - mmap + chunked parallel decimal parser behind radix_load_i32, decimal writer,
+// text/binary dataset opener
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "radix_io.h"
+
+#define LOAD_MAX_THREADS  64
+#define LOAD_MIN_CHUNK    (256 * 1024)   // bytes per thread below which extra threads cost more than they save
+
+typedef struct {
+    const char *buf;     // whole file
+    size_t lo, hi;       // my chunk: starts at the file start or just after a separator
+    size_t count;        // numbers starting in the chunk (pass 1)
+    int32_t *out;        // where my first number goes (pass 2)
+    int32_t min, max;
+    int err;             // EINVAL: malformed token, ERANGE: outside int32 (pass 2)
+} load_chunk;
+
+static inline int is_digit(unsigned char c) { return (unsigned)(c - '0') < 10u; }
+
+static inline int is_space(unsigned char c) {
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t' || c == '\v' || c == '\f';
+}
+
+// A token starts at every non-space byte that does not follow one; each must be a number.
+static void count_chunk(load_chunk *c) {
+    const unsigned char *s = (const unsigned char *)c->buf;
+    size_t count = 0;
+    int prev = 0;
+    for (size_t i = c->lo; i < c->hi; i++) {
+        int d = !is_space(s[i]);
+        count += (size_t)(d & !prev);
+        prev = d;
+    }
+    c->count = count;
+}
+
+// Stops at the first token that is not [+-]digits or does not fit in int32 (c->err).
+static void parse_chunk(load_chunk *c) {
+    const unsigned char *s = (const unsigned char *)c->buf;
+    int32_t *out = c->out;
+    int32_t mn = INT32_MAX, mx = INT32_MIN;
+    size_t i = c->lo, hi = c->hi;
+
+    c->err = 0;
+    while (i < hi) {
+        while (i < hi && is_space(s[i])) i++;
+        if (i == hi) break;
+        uint32_t neg = s[i] == '-';
+        i += neg | (s[i] == '+');
+        size_t first = i;
+        uint64_t v = 0;
+        int big = 0;
+        while (i < hi && is_digit(s[i])) {
+            v = v * 10u + (uint64_t)(s[i++] - '0');
+            big |= v > 0x80000000u;                        // sticky, so 20+ digits cannot wrap back into range
+        }
+        if (i == first || (i < hi && !is_space(s[i]))) { c->err = EINVAL; break; }
+        if (big || v > 0x7fffffffu + neg) { c->err = ERANGE; break; }
+        int32_t x = (int32_t)(((uint32_t)v ^ (0u - neg)) + neg);   // two's-complement negate without a branch
+        *out++ = x;
+        mn = x < mn ? x : mn;
+        mx = x > mx ? x : mx;
+    }
+    c->min = mn;
+    c->max = mx;
+}
+
+static void *count_main(void *arg) { count_chunk((load_chunk *)arg); return NULL; }
+static void *parse_main(void *arg) { parse_chunk((load_chunk *)arg); return NULL; }
+
+// Runs fn on every chunk: chunk 0 on the caller, the others on short-lived threads.
+static void run_chunks(load_chunk *chunk, int nchunks, void *(*fn)(void *)) {
+    pthread_t tid[LOAD_MAX_THREADS];
+    int started[LOAD_MAX_THREADS] = {0};
+    for (int t = 1; t < nchunks; t++)
+        started[t] = pthread_create(&tid[t], NULL, fn, &chunk[t]) == 0;
+    fn(&chunk[0]);
+    for (int t = 1; t < nchunks; t++) {
+        if (started[t]) pthread_join(tid[t], NULL);
+        else            fn(&chunk[t]);
+    }
+}
+
+int radix_parse_i32(const char *buf, size_t size, int threads, int32_t **arr, size_t *cap,
+                    radix_load_stats *stats) {
+    if (threads <= 0) {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = cpus > 0 ? (int)cpus : 1;
+    }
+    if (threads > LOAD_MAX_THREADS) threads = LOAD_MAX_THREADS;
+    if ((size_t)threads > size / LOAD_MIN_CHUNK) threads = (int)(size / LOAD_MIN_CHUNK);
+    if (threads < 1) threads = 1;
+
+    // Chunk t starts at size * t / threads, moved forward past the number it lands in
+    load_chunk chunk[LOAD_MAX_THREADS];
+    size_t at = 0;
+    for (int t = 0; t < threads; t++) {
+        size_t end = (t == threads - 1) ? size : size / threads * (size_t)(t + 1);
+        if (end < at) end = at;
+        while (end < size && !is_space((unsigned char)buf[end])) end++;
+        chunk[t] = (load_chunk){ .buf = buf, .lo = at, .hi = end };
+        at = end;
+    }
+
+    run_chunks(chunk, threads, count_main);
+
+    size_t n = stats->n;
+    for (int t = 0; t < threads; t++) n += chunk[t].count;
+    if (n > *cap || !*arr) {
+        size_t want = *cap * 2 > n ? *cap * 2 : n;
+        int32_t *grown = realloc(*arr, (want ? want : 1) * sizeof(int32_t));
+        if (!grown) { errno = ENOMEM; return -1; }
+        *arr = grown;
+        *cap = want;
+    }
+    size_t pos = stats->n;
+    for (int t = 0; t < threads; t++) { chunk[t].out = *arr + pos; pos += chunk[t].count; }
+    run_chunks(chunk, threads, parse_main);
+    for (int t = 0; t < threads; t++)
+        if (chunk[t].err) { errno = chunk[t].err; return -1; }
+
+    stats->n = n;
+    for (int t = 0; t < threads; t++) {
+        if (chunk[t].count == 0) continue;
+        if (chunk[t].min < stats->min) stats->min = chunk[t].min;
+        if (chunk[t].max > stats->max) stats->max = chunk[t].max;
+    }
+    return 0;
+}
+
+int32_t *radix_load_i32(const char *path, int threads, radix_load_stats *stats) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return NULL;
+    struct stat sb;
+    if (fstat(fd, &sb) != 0) { int e = errno; close(fd); errno = e; return NULL; }
+    size_t size = (size_t)sb.st_size;
+
+    const char *buf = NULL;
+    int mapped = 0;
+    if (size > 0) {
+        void *m = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (m != MAP_FAILED) {
+            madvise(m, size, MADV_SEQUENTIAL);
+            buf = m;
+            mapped = 1;
+        } else {
+            // Not mappable (pipe, special file): read it in one go
+            char *r = malloc(size);
+            size_t got = 0;
+            while (r && got < size) {
+                ssize_t k = read(fd, r + got, size - got);
+                if (k <= 0) break;
+                got += (size_t)k;
+            }
+            if (!r || got != size) { free(r); close(fd); errno = EIO; return NULL; }
+            buf = r;
+        }
+    }
+    close(fd);
+
+    radix_load_stats ls = { 0, INT32_MAX, INT32_MIN };
+    int32_t *arr = NULL;
+    size_t cap = 0;
+    int rc = radix_parse_i32(buf, size, threads, &arr, &cap, &ls);
+    int e = errno;
+    if (mapped) munmap((void *)buf, size);
+    else        free((void *)buf);
+    if (rc != 0) { free(arr); errno = e; return NULL; }
+    if (stats) *stats = ls;
+    return arr;
+}
+
+/* ---------- Decimal writer ---------- */
+static const char digit_pairs[201] =
+    "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+    "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+// Two digits per division, written backwards into a small buffer, then copied out
+size_t radix_format_i32(const int32_t *a, size_t n, char *out) {
+    char *o = out;
+    for (size_t i = 0; i < n; i++) {
+        int32_t x = a[i];
+        uint32_t v = x < 0 ? 0u - (uint32_t)x : (uint32_t)x;
+        char tmp[RADIX_TEXT_MAX_I32];
+        char *end = tmp + sizeof(tmp), *p = end;
+        while (v >= 100) {
+            uint32_t q = v / 100;
+            p -= 2;
+            memcpy(p, digit_pairs + 2 * (v - q * 100), 2);
+            v = q;
+        }
+        if (v >= 10) { p -= 2; memcpy(p, digit_pairs + 2 * v, 2); }
+        else         *--p = (char)('0' + v);
+        *o = '-';
+        o += x < 0;
+        memcpy(o, p, (size_t)(end - p));
+        o += end - p;
+        *o++ = '\n';
+    }
+    return (size_t)(o - out);
+}
+
+/* ---------- Text or binary dataset ---------- */
+int radix_dataset_open(radix_dataset *d, const char *path, radix_bin_mode mode, int threads) {
+    memset(d, 0, sizeof(*d));
+    if (!radix_bin_probe(path)) {
+        d->data = radix_load_i32(path, threads, &d->stats);
+        return d->data ? 0 : -1;
+    }
+
+    if (radix_bin_open(&d->bin, path, mode) != 0) return -1;
+    if (d->bin.hdr.type != RADIX_I32) { radix_bin_close(&d->bin); errno = EINVAL; return -1; }
+    d->mapped  = 1;
+    d->data    = (int32_t *)d->bin.data;
+    d->stats.n = (size_t)d->bin.hdr.count;
+    if (d->bin.hdr.flags & RADIX_BIN_HAS_MINMAX) {
+        d->stats.min = (int32_t)(uint32_t)d->bin.hdr.min;
+        d->stats.max = (int32_t)(uint32_t)d->bin.hdr.max;
+    } else {
+        // Older or hand-written files: one pass for the bounds
+        int32_t mn = INT32_MAX, mx = INT32_MIN;
+        for (size_t i = 0; i < d->stats.n; i++) {
+            int32_t x = d->data[i];
+            mn = x < mn ? x : mn;
+            mx = x > mx ? x : mx;
+        }
+        d->stats.min = mn;
+        d->stats.max = mx;
+    }
+    return 0;
+}
+
+int radix_dataset_close(radix_dataset *d) {
+    int rc = 0;
+    if (d->mapped) rc = radix_bin_close(&d->bin);
+    else           free(d->data);
+    d->data = NULL;
+    return rc;
+}
@@ -0,0 +1,53 @@
+// radix_io.h - fast loaders for the integer datasets (input_*.txt and the binary .bin format)
+#ifndef RADIX_IO_H
+#define RADIX_IO_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "radix_bin.h"
+
+// Filled by the loader during the parse, so callers need no extra min/max pass.
+typedef struct {
+    size_t  n;          // integers read
+    int32_t min, max;   // INT32_MAX / INT32_MIN when n == 0
+} radix_load_stats;
+
+// Reads the whitespace-separated decimal integers in 'path' (optional leading '-' or
+// '+'). The file is mmapped, cut into chunks at whitespace and the chunks are parsed
+// by 'threads' threads (0 = online CPUs; small files use one). Returns a malloc'd
+// array to free(), or NULL with errno set: EINVAL for a token that is not a number
+// ("1.5", "--5", "x"), ERANGE for a number outside int32.
+int32_t *radix_load_i32(const char *path, int threads, radix_load_stats *stats);
+
+// The parser behind radix_load_i32, for text already in memory (e.g. one block of a stream).
+// Appends the numbers of buf[0, size) to (*arr)[stats->n ...], growing *arr (room for *cap
+// values; NULL / 0 to start) by at least doubling, and widens stats->n / min / max to cover
+// them (start from n = 0, min = INT32_MAX, max = INT32_MIN). buf must end at whitespace or at
+// the end of the input, or the last number is cut. Returns 0, or -1 with errno = ENOMEM,
+// EINVAL or ERANGE (as radix_load_i32; *arr may have grown, stats is unchanged).
+int radix_parse_i32(const char *buf, size_t size, int threads, int32_t **arr, size_t *cap,
+                    radix_load_stats *stats);
+
+// Longest line radix_format_i32 writes: "-2147483648\n"
+#define RADIX_TEXT_MAX_I32  12
+
+// Writes a[0, n) as decimal text, one value per line, to out (room for n * RADIX_TEXT_MAX_I32
+// bytes). Returns the bytes written.
+size_t radix_format_i32(const int32_t *a, size_t n, char *out);
+
+// An int32 dataset in either format. Binary files (radix_bin.h) are mapped and sorted
+// where they lie, text files are parsed into a malloc'd array.
+typedef struct {
+    int32_t *data;
+    radix_load_stats stats;
+    radix_bin_file bin;
+    int mapped;              // 1: data lives in bin's mapping
+} radix_dataset;
+
+// mode only matters for binary files. Returns 0, or -1 with errno set
+// (EINVAL also for a binary file that does not hold RADIX_I32 values).
+int  radix_dataset_open(radix_dataset *d, const char *path, radix_bin_mode mode, int threads);
+// Frees or unmaps (syncing an in-place file). Returns -1 if the sync fails.
+int  radix_dataset_close(radix_dataset *d);
+
+#endif
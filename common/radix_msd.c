@@ -0,0 +1,287 @@
+// radix_msd.c - parallel MSD engine on the radix_ctx pool: large buckets are partitioned
+// by all threads together, the rest are sorted as tasks on per-thread work-stealing deques
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include "radix_ctx_impl.h"
+#include "radix_trace.h"
+
+#define MSD_INSERTION_MAX  32     // buckets this small are insertion sorted
+#define MSD_LSD_MAX        4096   // up to here the remaining digits go through sequential counting sorts
+#define MSD_SPLIT_DIV      4      // buckets > n / (MSD_SPLIT_DIV * threads) get a parallel partition
+
+// Elements stay in their caller form between passes: every pass applies and undoes the key transform
+#define MSD_FLAGS  (RADIX_PASS_FIRST | RADIX_PASS_LAST)
+
+/* ---------- Tasks ---------- */
+typedef struct {
+    size_t lo, hi;   // bucket [lo, hi) of ctx->arr
+    int pass;        // next digit to sort on; all higher digits are equal inside the bucket
+} msd_task;
+
+// Owner pushes and pops at the bottom, thieves take from the top (the oldest, largest buckets)
+typedef struct {
+    pthread_mutex_t lock;
+    msd_task *task;
+    size_t top, bottom, cap;   // live tasks are task[top, bottom)
+} msd_deque;
+
+typedef struct {
+    msd_deque *deque;          // one per thread
+    atomic_size_t pending;     // tasks queued or running, 0 ends the job
+    size_t split;              // bucket size above which all threads partition together
+
+    // Buckets waiting for a parallel partition (tid 0 only)
+    msd_task *big;
+    size_t big_n;
+    msd_task cur;              // bucket being partitioned right now
+    int done;                  // no big bucket left
+    int next;                  // round-robin deque for the buckets tid 0 hands out
+} msd_state;
+
+static void task_run(radix_ctx *ctx, msd_state *st, int tid, msd_task t);
+
+static int deque_push(msd_deque *q, msd_task t) {
+    pthread_mutex_lock(&q->lock);
+    if (q->top == q->bottom) q->top = q->bottom = 0;
+    if (q->bottom == q->cap) {
+        size_t cap = q->cap ? 2 * q->cap : 64;
+        msd_task *grown = realloc(q->task, cap * sizeof(msd_task));
+        if (!grown) { pthread_mutex_unlock(&q->lock); return -1; }
+        q->task = grown;
+        q->cap  = cap;
+    }
+    q->task[q->bottom++] = t;
+    pthread_mutex_unlock(&q->lock);
+    return 0;
+}
+
+static int deque_pop(msd_deque *q, msd_task *t) {
+    int got = 0;
+    pthread_mutex_lock(&q->lock);
+    if (q->bottom > q->top) { *t = q->task[--q->bottom]; got = 1; }
+    pthread_mutex_unlock(&q->lock);
+    return got;
+}
+
+static int deque_steal(msd_deque *q, msd_task *t) {
+    int got = 0;
+    pthread_mutex_lock(&q->lock);
+    if (q->bottom > q->top) { *t = q->task[q->top++]; got = 1; }
+    pthread_mutex_unlock(&q->lock);
+    return got;
+}
+
+// Queues a sub-bucket on deque 'owner'. Runs it right away if the deque cannot grow.
+static void task_add(radix_ctx *ctx, msd_state *st, int owner, int tid, msd_task t) {
+    if (t.hi - t.lo <= 1 || t.pass < 0) return;   // a single element or no digit left
+    atomic_fetch_add_explicit(&st->pending, 1, memory_order_relaxed);
+    if (deque_push(&st->deque[owner], t) != 0) {
+        task_run(ctx, st, tid, t);
+        atomic_fetch_sub_explicit(&st->pending, 1, memory_order_release);
+    }
+}
+
+/* ---------- Small buckets ---------- */
+static void insertion_sort(radix_ctx *ctx, size_t lo, size_t hi) {
+    const radix_plan *p = &ctx->plan;
+    if (p->width == 32) {
+        uint32_t *a = (uint32_t *)ctx->arr;
+        for (size_t i = lo + 1; i < hi; i++) {
+            uint32_t x = a[i], k = radix_in32(p, x, RADIX_PASS_FIRST);
+            size_t j = i;
+            while (j > lo && radix_in32(p, a[j - 1], RADIX_PASS_FIRST) > k) { a[j] = a[j - 1]; j--; }
+            a[j] = x;
+        }
+    } else {
+        uint64_t *a = (uint64_t *)ctx->arr;
+        for (size_t i = lo + 1; i < hi; i++) {
+            uint64_t x = a[i], k = radix_in64(p, x, RADIX_PASS_FIRST);
+            size_t j = i;
+            while (j > lo && radix_in64(p, a[j - 1], RADIX_PASS_FIRST) > k) { a[j] = a[j - 1]; j--; }
+            a[j] = x;
+        }
+    }
+}
+
+// Sequential LSD over digits 0..t.pass of the bucket, using the same slots of ctx->out.
+// Wide digits are re-cut into 8-bit ones so a pass never clears more than 256 counters.
+static void lsd_tail(radix_ctx *ctx, int tid, msd_task t) {
+    radix_plan sub = ctx->plan;
+    if (sub.bits == RADIX_DECIMAL) {
+        sub.passes = t.pass + 1;
+    } else {
+        int bits = (t.pass + 1) * sub.bits;
+        if (bits > sub.width) bits = sub.width;
+        sub.bits    = 8;
+        sub.buckets = 256;
+        sub.mask    = 255;
+        sub.passes  = (bits + 7) / 8;
+    }
+
+    size_t n = t.hi - t.lo, e = ctx->elem;
+    char *a   = (char *)ctx->arr + t.lo * e;
+    char *tmp = (char *)ctx->out + t.lo * e;
+    size_t *count = radix_ctx_count(ctx, tid);
+    char *src = a, *dst = tmp;
+    for (int pass = 0; pass < sub.passes; pass++) {
+        if (sub.width == 32)
+            radix_pass32((const uint32_t *)src, (uint32_t *)dst, n, &sub, pass, MSD_FLAGS, count);
+        else
+            radix_pass64((const uint64_t *)src, (uint64_t *)dst, n, &sub, pass, MSD_FLAGS, count);
+        char *t = src; src = dst; dst = t;
+    }
+    if (src != a) memcpy(a, src, n * e);     // odd pass count
+}
+
+// Sorts one bucket: small ones directly, larger ones get one sequential partition step
+// and their sub-buckets go back on this thread's deque.
+static void task_run(radix_ctx *ctx, msd_state *st, int tid, msd_task t) {
+    RADIX_TRACE_START(t0);
+    size_t n = t.hi - t.lo;
+    if (n <= MSD_LSD_MAX) {
+        if (n <= MSD_INSERTION_MAX) insertion_sort(ctx, t.lo, t.hi);
+        else                        lsd_tail(ctx, tid, t);
+        RADIX_TRACE_STOP(tid, RADIX_PH_TASK, t.pass, t0);
+        return;
+    }
+
+    const radix_plan *p = &ctx->plan;
+    size_t e = ctx->elem;
+    char *a   = (char *)ctx->arr + t.lo * e;
+    char *tmp = (char *)ctx->out + t.lo * e;
+    size_t *count = radix_ctx_count(ctx, tid);
+    if (p->width == 32)
+        radix_pass32((const uint32_t *)a, (uint32_t *)tmp, n, p, t.pass, MSD_FLAGS, count);
+    else
+        radix_pass64((const uint64_t *)a, (uint64_t *)tmp, n, p, t.pass, MSD_FLAGS, count);
+    memcpy(a, tmp, n * e);
+
+    // After the scatter count[d] is the end of bucket d
+    size_t start = 0;
+    for (uint32_t d = 0; d < p->buckets; d++) {
+        msd_task child = { t.lo + start, t.lo + count[d], t.pass - 1 };
+        start = count[d];
+        if (child.hi - child.lo <= MSD_INSERTION_MAX) {
+            if (child.hi - child.lo > 1 && child.pass >= 0) insertion_sort(ctx, child.lo, child.hi);
+        } else {
+            task_add(ctx, st, tid, tid, child);
+        }
+    }
+    RADIX_TRACE_STOP(tid, RADIX_PH_TASK, t.pass, t0);
+}
+
+/* ---------- Job ---------- */
+// tid 0, after a parallel partition of st->cur: sub-buckets still larger than st->split
+// wait for their own parallel partition, the rest are dealt out over the deques.
+static void split_parallel(radix_ctx *ctx, msd_state *st) {
+    const radix_plan *p = &ctx->plan;
+    size_t start = st->cur.lo;
+    for (uint32_t d = 0; d < p->buckets; d++) {
+        size_t size = 0;
+        for (int t = 0; t < ctx->threads; t++) size += radix_ctx_count(ctx, t)[d];
+        msd_task child = { start, start + size, st->cur.pass - 1 };
+        start += size;
+        if (size <= 1 || child.pass < 0) continue;
+        if (size > st->split) {
+            st->big[st->big_n++] = child;
+        } else {
+            task_add(ctx, st, st->next, 0, child);
+            st->next = (st->next + 1) % ctx->threads;
+        }
+    }
+}
+
+static void msd_job(radix_ctx *ctx, int tid) {
+    msd_state *st = (msd_state *)ctx->job_data;
+
+    // Phase 1: all threads partition the big buckets one after another
+    for (;;) {
+        if (tid == 0) {
+            st->done = (st->big_n == 0);
+            if (!st->done) {
+                st->cur = st->big[--st->big_n];
+                ctx->lo = st->cur.lo;
+                ctx->n  = st->cur.hi - st->cur.lo;
+            }
+        }
+        RADIX_TRACE_START(t_wait);
+        radix_ctx_wait(ctx);
+        RADIX_TRACE_STOP(tid, RADIX_PH_BARRIER, st->cur.pass, t_wait);
+        if (st->done) break;
+        radix_ctx_pass(ctx, tid, st->cur.pass, MSD_FLAGS, 0);
+        radix_ctx_copy_back(ctx, tid, st->cur.pass);   // sub-buckets are sorted in arr
+        RADIX_TRACE_START(t_done);
+        radix_ctx_wait(ctx);         // bucket is back in arr, every count row is final
+        RADIX_TRACE_STOP(tid, RADIX_PH_BARRIER, st->cur.pass, t_done);
+        if (tid == 0) split_parallel(ctx, st);
+    }
+
+    // Phase 2: work through my deque, then steal from the others until no task is left
+    for (;;) {
+        msd_task t;
+        int got = deque_pop(&st->deque[tid], &t);
+        for (int i = 1; !got && i < ctx->threads; i++)
+            got = deque_steal(&st->deque[(tid + i) % ctx->threads], &t);
+        if (got) {
+            task_run(ctx, st, tid, t);
+            atomic_fetch_sub_explicit(&st->pending, 1, memory_order_release);
+            continue;
+        }
+        if (atomic_load_explicit(&st->pending, memory_order_acquire) == 0) break;
+        sched_yield();               // someone is still splitting a bucket
+    }
+}
+
+/* ---------- Sort ---------- */
+int radix_ctx_sort_msd(radix_ctx *ctx, void *a, size_t n, radix_key_type type, int bits) {
+    radix_plan plan;
+    if (radix_plan_init(&plan, type, bits, 0) != 0) return -1;
+    if (n <= 1) return 0;
+
+    if (n <= ctx->seq_cutoff || ctx->threads == 1)
+        return radix_sort(a, n, type, bits);
+
+    pthread_mutex_lock(&ctx->sort_lock);
+    if (radix_ctx_prepare(ctx, a, NULL, n, type, bits, NULL) != 0) {
+        pthread_mutex_unlock(&ctx->sort_lock);
+        return -1;
+    }
+    if (ctx->plan.passes == 0) {     // every key is 0
+        pthread_mutex_unlock(&ctx->sort_lock);
+        return 0;
+    }
+
+    msd_state st;
+    memset(&st, 0, sizeof(st));
+    st.split = n / ((size_t)MSD_SPLIT_DIV * ctx->threads);
+    if (st.split < MSD_LSD_MAX) st.split = MSD_LSD_MAX;
+    atomic_init(&st.pending, 0);
+
+    // Big buckets are disjoint and larger than split, so at most n / split wait at once
+    st.big   = malloc((n / st.split + 1) * sizeof(msd_task));
+    st.deque = calloc(ctx->threads, sizeof(msd_deque));
+    if (!st.big || !st.deque) {
+        free(st.big); free(st.deque);
+        pthread_mutex_unlock(&ctx->sort_lock);
+        return -1;
+    }
+    for (int t = 0; t < ctx->threads; t++)
+        pthread_mutex_init(&st.deque[t].lock, NULL);
+
+    st.big[st.big_n++] = (msd_task){ 0, n, ctx->plan.passes - 1 };
+    ctx->job_data = &st;
+    radix_ctx_run(ctx, msd_job);
+    ctx->job_data = NULL;
+
+    for (int t = 0; t < ctx->threads; t++) {
+        pthread_mutex_destroy(&st.deque[t].lock);
+        free(st.deque[t].task);
+    }
+    free(st.deque);
+    free(st.big);
+    pthread_mutex_unlock(&ctx->sort_lock);
+    return 0;
+}
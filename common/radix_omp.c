@@ -0,0 +1,619 @@
+// radix_omp.c - OpenMP LSD engine (plain, key-value and argsort), direct counting sort, segmented
+// sort, in-place MSD and radix-select
+#include <stdlib.h>
+#include <string.h>
+#include <omp.h>
+#include "radix_omp.h"
+#include "radix_trace.h"
+
+// vals may be NULL, scratch too (allocated then). Slices, digit counting, scan and scatter
+// follow the pthreads engine in radix_ctx.c, and so does the ping-pong between a and scratch.
+static int omp_lsd(void *a, void *scratch, uint32_t *vals, size_t n, radix_key_type type, int bits) {
+    radix_plan plan;
+    if (radix_plan_init(&plan, type, bits, radix_key_max(type)) != 0) return -1;
+    if (n <= 1) return 0;
+
+    int width = radix_key_width(type);
+    size_t elem = (size_t)width / 8;
+    size_t rows = (size_t)plan.passes * plan.buckets;
+
+    int threads = omp_get_max_threads();
+    char     *out   = scratch ? scratch : malloc(n * elem);
+    uint32_t *vout  = vals ? malloc(n * sizeof(uint32_t)) : NULL;
+    size_t   *hist  = malloc((size_t)2 * threads * plan.buckets * sizeof(size_t));
+    size_t   *dhist = malloc((threads + 1) * rows * sizeof(size_t));   // per thread, then the total
+    int       use_wc = !vals && radix_get_scatter() == RADIX_SCATTER_WC;
+    char     *wc    = use_wc ? radix_wc_alloc(plan.buckets, threads) : NULL;   // staging area per thread
+    if (!out || !hist || !dhist || (vals && !vout) || (use_wc && !wc)) {
+        if (out != scratch) free(out);
+        free(vout); free(hist); free(dhist); free(wc);
+        return -1;
+    }
+    size_t *total = dhist + (size_t)threads * rows;
+
+    #pragma omp parallel num_threads(threads)
+    {
+        radix_plan *p = &plan;
+        int tid = omp_get_thread_num();
+        int nt  = omp_get_num_threads();
+        size_t base = n / nt, rem = n % nt, t = (size_t)tid;
+        size_t lo = t * base + (t < rem ? t : rem);
+        size_t hi = lo + base + (t < rem ? 1 : 0);
+        size_t *local  = hist + (size_t)(2 * tid) * p->buckets;
+        size_t *offset = local + p->buckets;
+        size_t *mine   = dhist + (size_t)tid * rows;
+
+        // Every digit position of my slice in one read
+        RADIX_TRACE_START(t_count);
+        memset(mine, 0, rows * sizeof(size_t));
+        if (width == 32)
+            radix_histogram_all32((const uint32_t *)a, lo, hi, p, RADIX_PASS_FIRST, mine);
+        else
+            radix_histogram_all64((const uint64_t *)a, lo, hi, p, RADIX_PASS_FIRST, mine);
+        RADIX_TRACE_STOP(tid, RADIX_PH_HISTOGRAM, -1, t_count);
+
+        #pragma omp barrier
+        #pragma omp single
+        {
+            memcpy(total, dhist, rows * sizeof(size_t));
+            for (int u = 1; u < nt; u++)
+                for (size_t i = 0; i < rows; i++) total[i] += dhist[(size_t)u * rows + i];
+            radix_plan_skip_trivial(p, total, n);
+        }                                // implicit barrier: the plan is final
+
+        int from = 0, last = -1;
+        for (int pass = 0; pass < p->passes; pass++) {
+            if (radix_pass_skipped(p, pass)) continue;
+            int flags = radix_pass_flags(p, pass);
+            char     *arr  = from ? out : (char *)a;     // every other pass reads the scratch side
+            char     *dst  = from ? (char *)a : out;
+            uint32_t *vsrc = from ? vout : vals;
+            uint32_t *vdst = from ? vals : vout;
+
+            RADIX_TRACE_START(t_hist);
+            if (last < 0) {              // input order: the counts of my slice are already known
+                memcpy(local, mine + (size_t)pass * p->buckets, p->buckets * sizeof(size_t));
+            } else {
+                memset(local, 0, p->buckets * sizeof(size_t));
+                if (width == 32)
+                    radix_histogram32((const uint32_t *)arr, lo, hi, p, pass, flags, local);
+                else
+                    radix_histogram64((const uint64_t *)arr, lo, hi, p, pass, flags, local);
+            }
+            RADIX_TRACE_STOP(tid, RADIX_PH_HISTOGRAM, pass, t_hist);
+
+            RADIX_TRACE_START(t_wait1);
+            #pragma omp barrier
+            RADIX_TRACE_STOP(tid, RADIX_PH_BARRIER, pass, t_wait1);
+
+            RADIX_TRACE_START(t_scan);
+            size_t running = 0;
+            for (uint32_t d = 0; d < p->buckets; d++) {
+                for (int u = 0; u < nt; u++) {
+                    if (u == tid) offset[d] = running;
+                    running += hist[(size_t)(2 * u) * p->buckets + d];
+                }
+            }
+            RADIX_TRACE_STOP(tid, RADIX_PH_SCAN, pass, t_scan);
+
+            RADIX_TRACE_START(t_scatter);
+            if (vals && width == 32)
+                radix_scatter_pairs32((const uint32_t *)arr, (uint32_t *)dst, vsrc, vdst,
+                                      lo, hi, p, pass, flags, offset);
+            else if (vals)
+                radix_scatter_pairs64((const uint64_t *)arr, (uint64_t *)dst, vsrc, vdst,
+                                      lo, hi, p, pass, flags, offset);
+            else if (wc && width == 32)
+                radix_scatter_wc32((const uint32_t *)arr, (uint32_t *)dst, lo, hi, p, pass, flags, offset,
+                                   wc + (size_t)tid * radix_wc_bytes(p->buckets));
+            else if (wc)
+                radix_scatter_wc64((const uint64_t *)arr, (uint64_t *)dst, lo, hi, p, pass, flags, offset,
+                                   wc + (size_t)tid * radix_wc_bytes(p->buckets));
+            else if (width == 32)
+                radix_scatter32((const uint32_t *)arr, (uint32_t *)dst, lo, hi, p, pass, flags, offset);
+            else
+                radix_scatter64((const uint64_t *)arr, (uint64_t *)dst, lo, hi, p, pass, flags, offset);
+            RADIX_TRACE_STOP(tid, RADIX_PH_SCATTER, pass, t_scatter);
+
+            RADIX_TRACE_START(t_wait2);
+            #pragma omp barrier
+            RADIX_TRACE_STOP(tid, RADIX_PH_BARRIER, pass, t_wait2);
+            from ^= 1;
+            last = pass;
+        }
+
+        if (from) {                      // odd number of passes run: the result is in the scratch side
+            RADIX_TRACE_START(t_copy);
+            memcpy((char *)a + lo * elem, out + lo * elem, (hi - lo) * elem);
+            if (vals)
+                memcpy(vals + lo, vout + lo, (hi - lo) * sizeof(uint32_t));
+            RADIX_TRACE_STOP(tid, RADIX_PH_COPY, last, t_copy);
+        }
+    }
+    if (out != scratch) free(out);
+    free(vout);
+    free(hist);
+    free(dhist);
+    free(wc);
+    return 0;
+}
+
+int radix_omp_sort(void *a, size_t n, radix_key_type type, int bits) {
+    return omp_lsd(a, NULL, NULL, n, type, bits);
+}
+
+int radix_omp_sort_scratch(void *a, void *scratch, size_t n, radix_key_type type, int bits) {
+    return omp_lsd(a, scratch, NULL, n, type, bits);
+}
+
+int radix_omp_sort_pairs(void *keys, uint32_t *values, size_t n, radix_key_type type, int bits) {
+    return omp_lsd(keys, NULL, values, n, type, bits);
+}
+
+// Same steps as the pool version in radix_count.c: per-thread counts, column sums over
+// value chunks, start slots, then every thread writes its own slice of the output.
+int radix_omp_sort_counting(void *a, size_t n, radix_key_type type, uint64_t min_key, uint64_t max_key) {
+    if (max_key < min_key || max_key - min_key >= RADIX_COUNT_MAX_RANGE) return -1;
+    if (n <= 1) return 0;
+    size_t range = (size_t)(max_key - min_key) + 1;
+    int threads = omp_get_max_threads();
+    if (threads == 1 || range > n / threads) return radix_count_sort(a, n, type, min_key, max_key);
+
+    radix_plan plan;
+    radix_plan_init(&plan, type, 8, 0);   // only its key transform is used
+    int width = radix_key_width(type);
+    size_t *rows  = malloc((size_t)threads * range * sizeof(size_t));
+    size_t *chunk = malloc((size_t)threads * sizeof(size_t));
+    if (!rows || !chunk) { free(rows); free(chunk); return -1; }
+
+    #pragma omp parallel num_threads(threads)
+    {
+        int tid = omp_get_thread_num();
+        int nt  = omp_get_num_threads();
+        size_t base = n / nt, rem = n % nt, t = (size_t)tid;
+        size_t lo = t * base + (t < rem ? t : rem);
+        size_t hi = lo + base + (t < rem ? 1 : 0);
+        size_t *row = rows + (size_t)tid * range;
+
+        RADIX_TRACE_START(t_count);
+        memset(row, 0, range * sizeof(size_t));
+        if (width == 32) radix_count_range32((const uint32_t *)a, lo, hi, &plan, (uint32_t)min_key, row);
+        else             radix_count_range64((const uint64_t *)a, lo, hi, &plan, min_key, row);
+        RADIX_TRACE_STOP(tid, RADIX_PH_HISTOGRAM, -1, t_count);
+        #pragma omp barrier
+
+        RADIX_TRACE_START(t_scan);
+        size_t v_lo = range * t / nt, v_hi = range * (t + 1) / nt, sum = 0;
+        for (size_t v = v_lo; v < v_hi; v++) {
+            size_t c = 0;
+            for (int u = 0; u < nt; u++) c += rows[(size_t)u * range + v];
+            rows[v] = c;
+            sum += c;
+        }
+        chunk[tid] = sum;
+        #pragma omp barrier
+        size_t at = 0;
+        for (int u = 0; u < tid; u++) at += chunk[u];
+        for (size_t v = v_lo; v < v_hi; v++) {
+            size_t c = rows[v];
+            rows[v] = at;
+            at += c;
+        }
+        RADIX_TRACE_STOP(tid, RADIX_PH_SCAN, -1, t_scan);
+        #pragma omp barrier
+
+        RADIX_TRACE_START(t_fill);
+        if (width == 32) radix_fill_range32((uint32_t *)a, lo, hi, &plan, (uint32_t)min_key, rows, range);
+        else             radix_fill_range64((uint64_t *)a, lo, hi, &plan, min_key, rows, range);
+        RADIX_TRACE_STOP(tid, RADIX_PH_SCATTER, -1, t_fill);
+    }
+    free(rows);
+    free(chunk);
+    return 0;
+}
+
+int radix_omp_argsort(const void *keys, uint32_t *perm, size_t n, radix_key_type type, int bits) {
+    radix_plan plan;
+    if (radix_plan_init(&plan, type, bits, 0) != 0 || n > UINT32_MAX) return -1;
+
+    size_t bytes = n * (size_t)(radix_key_width(type) / 8);
+    void *copy = malloc(bytes ? bytes : 1);
+    if (!copy) return -1;
+    memcpy(copy, keys, bytes);
+    #pragma omp parallel for
+    for (size_t i = 0; i < n; i++) perm[i] = (uint32_t)i;
+
+    int rc = omp_lsd(copy, NULL, perm, n, type, bits);
+    free(copy);
+    return rc;
+}
+
+int radix_omp_sort_segments(void *a, const size_t *offsets, size_t segments, radix_key_type type, int bits) {
+    radix_plan plan;
+    if (radix_plan_init(&plan, type, bits, radix_key_max(type)) != 0) return -1;
+    int threads = omp_get_max_threads();
+    size_t total = segments ? offsets[segments] - offsets[0] : 0;
+    if (threads == 1) return radix_sort_segments(a, offsets, segments, type, bits);
+
+    size_t big = total / threads, largest = 0;   // bigger segments would leave the team idle
+    for (size_t i = 0; i < segments; i++) {
+        size_t n = offsets[i + 1] - offsets[i];
+        if (n <= big && n > largest) largest = n;
+    }
+    size_t elem = (size_t)plan.width / 8;
+    int failed = 0;
+
+    if (largest > 1) {
+        #pragma omp parallel num_threads(threads)
+        {
+            void   *scratch = malloc(largest * elem);
+            size_t *hist    = malloc((size_t)plan.passes * plan.buckets * sizeof(size_t));
+            RADIX_TRACE_START(t_seg);
+            #pragma omp for schedule(dynamic, 16)
+            for (size_t i = 0; i < segments; i++) {
+                size_t lo = offsets[i], n = offsets[i + 1] - lo;
+                if (n > big) continue;
+                if (!scratch || !hist) {
+                    #pragma omp atomic write
+                    failed = 1;
+                    continue;
+                }
+                if (plan.width == 32) radix_sort_segment32((uint32_t *)a + lo, scratch, n, &plan, hist);
+                else                  radix_sort_segment64((uint64_t *)a + lo, scratch, n, &plan, hist);
+            }
+            RADIX_TRACE_STOP(omp_get_thread_num(), RADIX_PH_TASK, -1, t_seg);
+            free(scratch);
+            free(hist);
+        }
+    }
+    if (failed) return -1;
+
+    for (size_t i = 0; i < segments; i++) {
+        size_t n = offsets[i + 1] - offsets[i];
+        if (n > big && radix_omp_sort((char *)a + offsets[i] * elem, n, type, bits) != 0) return -1;
+    }
+    return 0;
+}
+
+typedef struct {
+    radix_plan plan;
+    int     threads;
+    size_t  big;               // ranges larger than this are partitioned by the whole team
+    size_t *rows;              // per thread: digit counts of my slice
+    size_t *head, *tail;       // per thread: my stripe of every bucket
+    size_t *bounds;            // per digit position: lo, hi and end of every bucket
+    size_t *work;              // per thread: radix_flag_sort levels
+    size_t  work_row;
+} omp_flag_state;
+
+// Same steps as flag_job in radix_inplace.c for one range: digit counts per slice, rounds of
+// striped permute + repair until every element is in its bucket, then the buckets up to 'big'
+// as tasks. Larger buckets are partitioned afterwards by the next call, one after the other.
+static void omp_flag(omp_flag_state *st, char *a, size_t n, int pass) {
+    const radix_plan *p = &st->plan;
+    size_t B = p->buckets, elem = (size_t)p->width / 8;
+    size_t *lo_d = NULL, *hi_d = NULL, *end = NULL, left = n;
+    int skip = 0, done = 0, placed = 0, stripes = st->threads;
+
+    #pragma omp parallel num_threads(st->threads)
+    {
+        int tid = omp_get_thread_num();
+        int nt  = omp_get_num_threads();
+        size_t lo = n * (size_t)tid / nt, hi = n * (size_t)(tid + 1) / nt;
+        size_t *row  = st->rows + (size_t)tid * B;
+        size_t *head = st->head + (size_t)tid * B, *tail = st->tail + (size_t)tid * B;
+
+        for (;;) {                   // a position where every key has the same digit moves nothing
+            RADIX_TRACE_START(t_hist);
+            memset(row, 0, B * sizeof(size_t));
+            if (p->width == 32) radix_histogram32((const uint32_t *)a, lo, hi, p, pass, RADIX_PASS_FIRST, row);
+            else                radix_histogram64((const uint64_t *)a, lo, hi, p, pass, RADIX_PASS_FIRST, row);
+            RADIX_TRACE_STOP(tid, RADIX_PH_HISTOGRAM, pass, t_hist);
+            #pragma omp barrier
+            #pragma omp single
+            {
+                lo_d = st->bounds + (size_t)pass * 3 * B;
+                hi_d = lo_d + B;
+                end  = hi_d + B;
+                size_t at = 0;
+                skip = 0;
+                for (uint32_t d = 0; d < B; d++) {
+                    size_t c = 0;
+                    for (int u = 0; u < nt; u++) c += st->rows[(size_t)u * B + d];
+                    if (c == n) skip = 1;
+                    lo_d[d] = at;
+                    at += c;
+                    hi_d[d] = end[d] = at;
+                }
+                if (skip && pass == 0) done = 1;
+                else if (skip)         pass--;
+            }                        // implicit barrier: the buckets are known
+            if (done || !skip) break;
+        }
+
+        while (!done && !placed) {
+            if (tid < stripes) {     // my stripe of every bucket's unfinished range
+                for (uint32_t d = 0; d < B; d++) {
+                    size_t m = hi_d[d] - lo_d[d], base = m / stripes, extra = m % stripes, t = (size_t)tid;
+                    head[d] = lo_d[d] + t * base + (t < extra ? t : extra);
+                    tail[d] = head[d] + base + (t < extra);
+                }
+                RADIX_TRACE_START(t_perm);
+                if (p->width == 32) radix_flag_permute32((uint32_t *)a, p, pass, head, tail);
+                else                radix_flag_permute64((uint64_t *)a, p, pass, head, tail);
+                RADIX_TRACE_STOP(tid, RADIX_PH_SCATTER, pass, t_perm);
+            }
+            #pragma omp barrier
+            RADIX_TRACE_START(t_repair);
+            for (uint32_t d = (uint32_t)tid; d < B; d += (uint32_t)nt) {
+                if (lo_d[d] == hi_d[d]) continue;
+                if (p->width == 32)
+                    lo_d[d] = radix_flag_repair32((uint32_t *)a, p, pass, d, st->head + d, st->tail + d,
+                                                  B, stripes, hi_d[d]);
+                else
+                    lo_d[d] = radix_flag_repair64((uint64_t *)a, p, pass, d, st->head + d, st->tail + d,
+                                                  B, stripes, hi_d[d]);
+            }
+            RADIX_TRACE_STOP(tid, RADIX_PH_COPY, pass, t_repair);
+            #pragma omp barrier
+            #pragma omp single
+            {                        // no progress: one stripe per bucket places everything
+                size_t now = 0;
+                for (uint32_t d = 0; d < B; d++) now += hi_d[d] - lo_d[d];
+                placed = now == 0;
+                if (now >= left) stripes = 1;
+                left = now;
+            }
+        }
+
+        if (!done && pass > 0) {
+            size_t *work = st->work + (size_t)tid * st->work_row;
+            RADIX_TRACE_START(t_task);
+            #pragma omp for schedule(dynamic, 16)
+            for (uint32_t d = 0; d < B; d++) {
+                size_t b_lo = d ? end[d - 1] : 0, m = end[d] - b_lo;
+                if (m <= 1 || m > st->big) continue;
+                if (p->width == 32) radix_flag_sort32((uint32_t *)a + b_lo, m, p, pass - 1, work);
+                else                radix_flag_sort64((uint64_t *)a + b_lo, m, p, pass - 1, work);
+            }
+            RADIX_TRACE_STOP(tid, RADIX_PH_TASK, pass - 1, t_task);
+        }
+    }
+
+    if (done || pass == 0) return;
+    for (uint32_t d = 0; d < B; d++) {   // the next calls only use the bounds of lower positions
+        size_t b_lo = d ? end[d - 1] : 0, m = end[d] - b_lo;
+        if (m > st->big) omp_flag(st, a + b_lo * elem, m, pass - 1);
+    }
+}
+
+int radix_omp_sort_inplace(void *a, size_t n, radix_key_type type, int bits) {
+    radix_plan plan;
+    if (radix_plan_init(&plan, type, bits, 0) != 0) return -1;
+    int threads = omp_get_max_threads();
+    if (threads == 1 || n <= RADIX_OMP_INPLACE_SEQ) return radix_sort_inplace(a, n, type, bits);
+
+    int width = radix_key_width(type);
+    uint64_t mn = UINT64_MAX, mx = 0;
+    #pragma omp parallel for num_threads(threads) reduction(min:mn) reduction(max:mx)
+    for (int t = 0; t < threads; t++) {
+        size_t lo = n * (size_t)t / threads, hi = n * (size_t)(t + 1) / threads;
+        uint64_t a_mn, a_mx;
+        if (width == 32) {
+            uint32_t mn32, mx32;
+            radix_key_minmax32((const uint32_t *)a, lo, hi, &plan, &mn32, &mx32);
+            a_mn = mn32; a_mx = mx32;
+        } else {
+            radix_key_minmax64((const uint64_t *)a, lo, hi, &plan, &a_mn, &a_mx);
+        }
+        if (a_mn < mn) mn = a_mn;
+        if (a_mx > mx) mx = a_mx;
+    }
+    radix_plan_init(&plan, type, bits, mx);
+    int top = plan.passes - 1;           // highest digit position where the keys differ
+    while (top >= 0) {
+        uint64_t place = bits == RADIX_DECIMAL ? plan.pow10[top] : 0;
+        if (place ? mn / place != mx / place : (mn >> (top * bits)) != (mx >> (top * bits))) break;
+        top--;
+    }
+    if (top < 0) return 0;               // all keys are equal
+
+    omp_flag_state st;
+    size_t B = plan.buckets, T = (size_t)threads;
+    st.plan     = plan;
+    st.threads  = threads;
+    st.big      = n / T > RADIX_OMP_INPLACE_SEQ ? n / T : RADIX_OMP_INPLACE_SEQ;
+    st.work_row = 2 * B * (size_t)(top + 1);
+    st.rows   = malloc(T * B * sizeof(size_t));
+    st.head   = malloc(T * B * sizeof(size_t));
+    st.tail   = malloc(T * B * sizeof(size_t));
+    st.bounds = malloc(3 * B * (size_t)(top + 1) * sizeof(size_t));
+    st.work   = malloc(T * st.work_row * sizeof(size_t));
+    int rc = -1;
+    if (st.rows && st.head && st.tail && st.bounds && st.work) {
+        omp_flag(&st, a, n, top);
+        rc = 0;
+    }
+    free(st.rows);
+    free(st.head);
+    free(st.tail);
+    free(st.bounds);
+    free(st.work);
+    return rc;
+}
+
+// Same levels as select_job in radix_select.c: per-thread digit histograms of the candidates,
+// the bucket of the k-th one picked by one thread, then every thread copies its candidates in
+// that bucket to its slots of the next buffer (two buffers in turn).
+int radix_omp_select_key(const void *a, size_t n, radix_key_type type, size_t k, uint64_t *key) {
+    if (k >= n) return -1;
+    int threads = omp_get_max_threads();
+    if (threads == 1 || n <= RADIX_OMP_SELECT_SEQ) return radix_select_key(a, n, type, k, key);
+
+    radix_plan plan;
+    radix_plan_init(&plan, type, 8, 0);   // key transform for the min/max scan
+    int width = radix_key_width(type);
+    size_t elem = (size_t)width / 8;
+    uint64_t mn = UINT64_MAX, mx = 0;
+    #pragma omp parallel for num_threads(threads) reduction(min:mn) reduction(max:mx)
+    for (int t = 0; t < threads; t++) {
+        size_t lo = n * (size_t)t / threads, hi = n * (size_t)(t + 1) / threads;
+        if (lo == hi) continue;
+        uint64_t a_mn, a_mx;
+        if (width == 32) {
+            uint32_t mn32, mx32;
+            radix_key_minmax32((const uint32_t *)a, lo, hi, &plan, &mn32, &mx32);
+            a_mn = mn32; a_mx = mx32;
+        } else {
+            radix_key_minmax64((const uint64_t *)a, lo, hi, &plan, &a_mn, &a_mx);
+        }
+        if (a_mn < mn) mn = a_mn;
+        if (a_mx > mx) mx = a_mx;
+    }
+
+    // Few distinct values: one count row per thread, summed by radix_select_bucket
+    if (mx - mn < n / threads && mx - mn < RADIX_COUNT_MAX_RANGE) {
+        size_t range = (size_t)(mx - mn) + 1;
+        size_t *rows = malloc((size_t)threads * range * sizeof(size_t));
+        if (!rows) return -1;
+        #pragma omp parallel num_threads(threads)
+        {
+            int tid = omp_get_thread_num();
+            size_t lo = n * (size_t)tid / threads, hi = n * (size_t)(tid + 1) / threads;
+            size_t *row = rows + (size_t)tid * range;
+            memset(row, 0, range * sizeof(size_t));
+            if (width == 32) radix_count_range32((const uint32_t *)a, lo, hi, &plan, (uint32_t)mn, row);
+            else             radix_count_range64((const uint64_t *)a, lo, hi, &plan, mn, row);
+        }
+        uint32_t v;
+        radix_select_bucket(rows, threads, (uint32_t)range, &k, NULL, &v);
+        free(rows);
+        *key = mn + v;
+        return 0;
+    }
+
+    uint64_t prefix;
+    radix_select_plan(&plan, type, mn, mx, &prefix);
+
+    size_t *rows = malloc(((size_t)threads << RADIX_SELECT_BITS) * sizeof(size_t));
+    size_t *at   = malloc((size_t)threads * sizeof(size_t));
+    if (!rows || !at) { free(rows); free(at); return -1; }
+    const char *src = a;
+    char *buf[2] = { NULL, NULL }, *dst = NULL;
+    size_t buf_n[2] = { 0, 0 }, m = n;
+    int next = 0, pass = plan.passes - 1, failed = 0;
+    uint32_t d = 0;
+
+    #pragma omp parallel num_threads(threads)
+    {
+        int tid = omp_get_thread_num();
+        int nt  = omp_get_num_threads();
+        size_t *row = rows + (size_t)tid * plan.buckets;
+        while (pass >= 0 && m > RADIX_OMP_SELECT_SEQ && !failed) {
+            size_t lo = m * (size_t)tid / nt, hi = m * (size_t)(tid + 1) / nt;
+            const char *from = src;
+            int level = pass;
+
+            RADIX_TRACE_START(t_hist);
+            memset(row, 0, plan.buckets * sizeof(size_t));
+            if (width == 32) radix_histogram32((const uint32_t *)from, lo, hi, &plan, level, RADIX_PASS_FIRST, row);
+            else             radix_histogram64((const uint64_t *)from, lo, hi, &plan, level, RADIX_PASS_FIRST, row);
+            RADIX_TRACE_STOP(tid, RADIX_PH_HISTOGRAM, level, t_hist);
+            #pragma omp barrier
+            #pragma omp single
+            {
+                size_t kept = radix_select_bucket(rows, nt, plan.buckets, &k, at, &d);
+                prefix |= (uint64_t)d << (level * plan.bits);
+                dst = NULL;
+                if (level > 0 && kept < m) {
+                    if (buf_n[next] < kept) {
+                        free(buf[next]);
+                        buf[next] = malloc(kept * elem);
+                        buf_n[next] = buf[next] ? kept : 0;
+                    }
+                    if (buf[next]) {
+                        dst = buf[next];
+                        src = dst;
+                        next ^= 1;
+                        m = kept;
+                    } else {
+                        failed = 1;
+                    }
+                }
+                pass--;
+            }                            // implicit barrier: bucket, slots and target are known
+
+            if (dst) {
+                RADIX_TRACE_START(t_copy);
+                char *out = dst + at[tid] * elem;
+                size_t mine = row[d];
+                if (width == 32)
+                    radix_filter_digit32((const uint32_t *)from, lo, hi, &plan, level, d, (uint32_t *)out, mine);
+                else
+                    radix_filter_digit64((const uint64_t *)from, lo, hi, &plan, level, d, (uint64_t *)out, mine);
+                RADIX_TRACE_STOP(tid, RADIX_PH_SCATTER, level, t_copy);
+                #pragma omp barrier
+            }
+        }
+    }
+
+    int rc = 0;
+    if (failed)        rc = -1;
+    else if (pass < 0) *key = prefix;
+    else               rc = radix_select_key(src, m, type, k, key);   // few left: finish alone
+    free(buf[0]);
+    free(buf[1]);
+    free(rows);
+    free(at);
+    return rc;
+}
+
+int radix_omp_select(const void *a, size_t n, radix_key_type type, size_t k, void *out) {
+    uint64_t key;
+    if (radix_omp_select_key(a, n, type, k, &key) != 0) return -1;
+    if (radix_key_width(type) == 32) *(uint32_t *)out = radix_raw32(type, (uint32_t)key);
+    else                             *(uint64_t *)out = radix_raw64(type, key);
+    return 0;
+}
+
+// Count, then copy, the elements before the k-th one in every thread's slice, then sort them.
+int radix_omp_topk(const void *a, size_t n, radix_key_type type, size_t k, int largest, void *out) {
+    if (k > n) return -1;
+    if (k == 0) return 0;
+    int threads = omp_get_max_threads();
+    if (threads == 1 || n <= RADIX_OMP_SELECT_SEQ) return radix_topk(a, n, type, k, largest, out);
+
+    uint64_t t;
+    if (radix_omp_select_key(a, n, type, largest ? n - k : k - 1, &t) != 0) return -1;
+    radix_plan plan;
+    radix_plan_init(&plan, type, 8, 0);   // key transform only
+    int width = radix_key_width(type);
+    size_t elem = (size_t)width / 8;
+    size_t *at = malloc((size_t)threads * sizeof(size_t)), taken = 0;
+    if (!at) return -1;
+
+    #pragma omp parallel num_threads(threads)
+    {
+        int tid = omp_get_thread_num();
+        int nt  = omp_get_num_threads();
+        size_t lo = n * (size_t)tid / nt, hi = n * (size_t)(tid + 1) / nt;
+        RADIX_TRACE_START(t_count);
+        if (width == 32) at[tid] = radix_take32((const uint32_t *)a, lo, hi, &plan, (uint32_t)t, largest, NULL, 0);
+        else             at[tid] = radix_take64((const uint64_t *)a, lo, hi, &plan, t, largest, NULL, 0);
+        RADIX_TRACE_STOP(tid, RADIX_PH_HISTOGRAM, -1, t_count);
+        #pragma omp barrier
+
+        RADIX_TRACE_START(t_copy);
+        size_t slot = 0;
+        for (int u = 0; u < tid; u++) slot += at[u];
+        char *dst = (char *)out + slot * elem;
+        if (width == 32) radix_take32((const uint32_t *)a, lo, hi, &plan, (uint32_t)t, largest, (uint32_t *)dst, at[tid]);
+        else             radix_take64((const uint64_t *)a, lo, hi, &plan, t, largest, (uint64_t *)dst, at[tid]);
+        RADIX_TRACE_STOP(tid, RADIX_PH_SCATTER, -1, t_copy);
+        if (tid == nt - 1) taken = slot + at[tid];
+    }
+    free(at);
+    if (radix_omp_sort(out, taken, type, 11) != 0) return -1;
+    radix_topk_finish(out, taken, k, type, t, largest);
+    return 0;
+}
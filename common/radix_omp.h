@@ -0,0 +1,39 @@
+// radix_omp.h - OpenMP LSD engine with the same entry points as the sequential core
+#ifndef RADIX_OMP_H
+#define RADIX_OMP_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "radix_core.h"
+
+// Parallel versions of radix_sort / radix_sort_scratch / radix_sort_pairs / radix_argsort. All
+// passes run in one parallel region: per-thread histograms, a (digit, thread) scan, then a stable
+// scatter of each thread's slice into the other buffer. Uses omp_get_max_threads() threads.
+// Same return values as the sequential calls.
+int radix_omp_sort(void *a, size_t n, radix_key_type type, int bits);
+int radix_omp_sort_scratch(void *a, void *scratch, size_t n, radix_key_type type, int bits);
+int radix_omp_sort_pairs(void *keys, uint32_t *values, size_t n, radix_key_type type, int bits);
+int radix_omp_argsort(const void *keys, uint32_t *perm, size_t n, radix_key_type type, int bits);
+
+// Parallel radix_count_sort: keys of a[0, n) all in [min_key, max_key], same return values.
+int radix_omp_sort_counting(void *a, size_t n, radix_key_type type, uint64_t min_key, uint64_t max_key);
+
+// Parallel radix_sort_segments: segments are dealt out in dynamic chunks, each thread sorting
+// them with its own scratch; segments holding more than n / threads keys are then sorted one
+// after the other by radix_omp_sort.
+int radix_omp_sort_segments(void *a, const size_t *offsets, size_t segments, radix_key_type type, int bits);
+
+// Parallel radix_sort_inplace: ranges larger than n / threads are partitioned by the whole
+// team in striped rounds (radix_ctx_sort_inplace), smaller buckets are dealt out in dynamic
+// chunks and sorted alone with radix_flag_sort. No n-element scratch buffer.
+#define RADIX_OMP_INPLACE_SEQ  2000
+int radix_omp_sort_inplace(void *a, size_t n, radix_key_type type, int bits);
+
+// Parallel radix_select_key / radix_select / radix_topk: the levels of radix_ctx_select_key
+// in one parallel region, until at most RADIX_OMP_SELECT_SEQ candidates are left.
+#define RADIX_OMP_SELECT_SEQ  2000
+int radix_omp_select_key(const void *a, size_t n, radix_key_type type, size_t k, uint64_t *key);
+int radix_omp_select(const void *a, size_t n, radix_key_type type, size_t k, void *out);
+int radix_omp_topk(const void *a, size_t n, radix_key_type type, size_t k, int largest, void *out);
+
+#endif
@@ -0,0 +1,128 @@
+// radix_perf.c - per-thread perf_event_open counter groups and the registry that sums them
+#include <pthread.h>
+#include <stdatomic.h>
+#include <string.h>
+#include <unistd.h>
+#include "radix_perf.h"
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#endif
+
+static const char *NAMES[RADIX_PERF_COUNT] = {
+    "cycles", "instructions", "cache-misses", "dtlb-misses", "branch-misses"
+};
+
+const char *radix_perf_name(radix_perf_counter c) { return NAMES[c]; }
+
+// One counter group per registered thread: the first counter that opens leads,
+// the others join it, so one read() returns them all at the same instant.
+typedef struct {
+    int leader;                       // -1: nothing opened
+    int nr;                           // counters in the group
+    int which[RADIX_PERF_COUNT];      // group position -> radix_perf_counter
+} perf_group;
+
+static perf_group groups[RADIX_PERF_MAX_THREADS];
+static atomic_int group_count;
+static atomic_uint opened_mask;
+static pthread_mutex_t register_lock = PTHREAD_MUTEX_INITIALIZER;
+static __thread int my_slot = -1;     // -2: this thread could not get a slot
+
+#ifdef __linux__
+static int open_counter(radix_perf_counter c, int group_fd) {
+    struct perf_event_attr a;
+    memset(&a, 0, sizeof(a));
+    a.size           = sizeof(a);
+    a.exclude_kernel = 1;
+    a.exclude_hv     = 1;
+    a.read_format    = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    a.type           = PERF_TYPE_HARDWARE;
+    switch (c) {
+    case RADIX_PERF_CYCLES:        a.config = PERF_COUNT_HW_CPU_CYCLES; break;
+    case RADIX_PERF_INSTRUCTIONS:  a.config = PERF_COUNT_HW_INSTRUCTIONS; break;
+    case RADIX_PERF_CACHE_MISSES:  a.config = PERF_COUNT_HW_CACHE_MISSES; break;
+    case RADIX_PERF_BRANCH_MISSES: a.config = PERF_COUNT_HW_BRANCH_MISSES; break;
+    case RADIX_PERF_DTLB_MISSES:
+        a.type   = PERF_TYPE_HW_CACHE;
+        a.config = PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                   ((uint64_t)PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+        break;
+    default: return -1;
+    }
+    // pid 0, cpu -1: this thread, on whatever CPU it runs
+    return (int)syscall(SYS_perf_event_open, &a, 0, -1, group_fd, 0);
+}
+
+static void open_group(perf_group *g) {
+    g->leader = -1;
+    g->nr = 0;
+    for (int c = 0; c < RADIX_PERF_COUNT; c++) {
+        int fd = open_counter((radix_perf_counter)c, g->leader);
+        if (fd < 0) continue;
+        if (g->leader < 0) g->leader = fd;
+        g->which[g->nr++] = c;
+    }
+}
+
+static void read_group(const perf_group *g, radix_perf_sample *s) {
+    memset(s, 0, sizeof(*s));
+    if (g->leader < 0) return;
+    uint64_t buf[3 + RADIX_PERF_COUNT];   // nr, time enabled, time running, values
+    if (read(g->leader, buf, sizeof(buf)) < (ssize_t)(3 * sizeof(uint64_t))) return;
+    uint64_t nr = buf[0], enabled = buf[1], running = buf[2];
+    double scale = (running > 0 && running < enabled) ? (double)enabled / running : 1.0;
+    for (uint64_t i = 0; i < nr && i < (uint64_t)g->nr; i++)
+        s->v[g->which[i]] = (uint64_t)(buf[3 + i] * scale);
+}
+#else
+static void open_group(perf_group *g) { g->leader = -1; g->nr = 0; }
+static void read_group(const perf_group *g, radix_perf_sample *s) { (void)g; memset(s, 0, sizeof(*s)); }
+#endif
+
+unsigned radix_perf_thread_init(void) {
+    if (my_slot == -2) return 0;
+    if (my_slot < 0) {
+        pthread_mutex_lock(&register_lock);
+        int slot = atomic_load(&group_count);
+        if (slot < RADIX_PERF_MAX_THREADS) {
+            open_group(&groups[slot]);
+            atomic_store(&group_count, slot + 1);   // published after the group is complete
+            my_slot = slot;
+        } else {
+            my_slot = -2;
+        }
+        pthread_mutex_unlock(&register_lock);
+        if (my_slot < 0) return 0;
+    }
+
+    unsigned mask = 0;
+    for (int i = 0; i < groups[my_slot].nr; i++) mask |= 1u << groups[my_slot].which[i];
+    atomic_fetch_or(&opened_mask, mask);
+    return mask;
+}
+
+void radix_perf_read(radix_perf_sample *s) {
+    radix_perf_thread_init();
+    if (my_slot < 0) { memset(s, 0, sizeof(*s)); return; }
+    read_group(&groups[my_slot], s);
+}
+
+void radix_perf_read_all(radix_perf_sample *s) {
+    memset(s, 0, sizeof(*s));
+    int n = atomic_load(&group_count);
+    for (int t = 0; t < n; t++) {
+        radix_perf_sample one;
+        read_group(&groups[t], &one);     // a counter fd can be read from any thread
+        for (int c = 0; c < RADIX_PERF_COUNT; c++) s->v[c] += one.v[c];
+    }
+}
+
+unsigned radix_perf_mask(void) { return atomic_load(&opened_mask); }
+
+void radix_perf_delta(radix_perf_sample *d, const radix_perf_sample *after, const radix_perf_sample *before) {
+    for (int c = 0; c < RADIX_PERF_COUNT; c++)
+        d->v[c] = after->v[c] >= before->v[c] ? after->v[c] - before->v[c] : 0;
+}
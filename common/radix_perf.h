@@ -0,0 +1,46 @@
+// radix_perf.h - per-thread hardware counters (Linux perf_event_open) with a timing-only fallback
+#ifndef RADIX_PERF_H
+#define RADIX_PERF_H
+
+#include <stdint.h>
+
+// Counted in user space for the calling thread only. Whichever of these the kernel
+// refuses (no PMU in a VM or container, perf_event_paranoid, not Linux) reads as 0
+// and is left out of radix_perf_mask(); with none at all callers report time only.
+typedef enum {
+    RADIX_PERF_CYCLES,
+    RADIX_PERF_INSTRUCTIONS,
+    RADIX_PERF_CACHE_MISSES,     // last-level cache misses
+    RADIX_PERF_DTLB_MISSES,      // data TLB read misses
+    RADIX_PERF_BRANCH_MISSES,
+    RADIX_PERF_COUNT
+} radix_perf_counter;
+
+typedef struct {
+    uint64_t v[RADIX_PERF_COUNT];
+} radix_perf_sample;
+
+#define RADIX_PERF_MAX_THREADS  256   // threads past this many are not counted
+
+// Opens the counters of the calling thread on its first call (later calls return at once).
+// Returns the mask (1 << radix_perf_counter) of counters running for this thread.
+unsigned radix_perf_thread_init(void);
+
+// Counters of the calling thread since its radix_perf_thread_init (called here if needed).
+// Values are scaled up when the kernel had to multiplex the counters.
+void radix_perf_read(radix_perf_sample *s);
+
+// Sum over every thread that has opened counters so far (pool workers included,
+// as long as they are registered; a thread that has exited keeps its final counts).
+void radix_perf_read_all(radix_perf_sample *s);
+
+// Counters that opened in at least one thread; 0 means timing only.
+unsigned radix_perf_mask(void);
+
+// d = after - before, counter by counter.
+void radix_perf_delta(radix_perf_sample *d, const radix_perf_sample *after, const radix_perf_sample *before);
+
+// "cycles", "instructions", "cache-misses", "dtlb-misses", "branch-misses"
+const char *radix_perf_name(radix_perf_counter c);
+
+#endif
@@ -0,0 +1,146 @@
+// radix_report.c - timing statistics and CSV / JSON result rows
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sys/resource.h>
+#include "radix_report.h"
+
+double radix_now(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec + t.tv_nsec / 1e9;
+}
+
+static int cmp_double(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+void radix_time_stats_compute(double *t, int reps, radix_time_stats *s) {
+    memset(s, 0, sizeof(*s));
+    if (reps <= 0) return;
+    qsort(t, (size_t)reps, sizeof(double), cmp_double);
+
+    s->median = (reps % 2) ? t[reps / 2] : (t[reps / 2 - 1] + t[reps / 2]) / 2;
+    int rank = (95 * reps + 99) / 100;   // ceil(0.95 * reps), at least 1
+    s->p95  = t[rank - 1];
+    s->min  = t[0];
+    for (int i = 0; i < reps; i++) s->mean += t[i];
+    s->mean /= reps;
+}
+
+int radix_peak_rss_reset(void) {
+    FILE *f = fopen("/proc/self/clear_refs", "w");
+    if (!f) return -1;
+    int ok = fputs("5", f) >= 0;
+    if (fclose(f) != 0) ok = 0;
+    return ok ? 0 : -1;
+}
+
+size_t radix_peak_rss_kb(void) {
+    size_t kb = 0;
+    char line[256];
+    FILE *f = fopen("/proc/self/status", "r");
+    while (f && fgets(line, sizeof(line), f))
+        if (sscanf(line, "VmHWM: %zu kB", &kb) == 1) break;
+    if (f) fclose(f);
+    struct rusage ru;
+    if (kb == 0 && getrusage(RUSAGE_SELF, &ru) == 0) kb = (size_t)ru.ru_maxrss;   // kB on Linux
+    return kb;
+}
+
+int radix_report_parse_format(const char *s, radix_report_format *fmt) {
+    if (strcmp(s, "csv") == 0)  { *fmt = RADIX_REPORT_CSV;  return 0; }
+    if (strcmp(s, "json") == 0) { *fmt = RADIX_REPORT_JSON; return 0; }
+    return -1;
+}
+
+static const char *COLUMNS =
+    "timestamp,tool,backend,dataset,n,elem_bytes,threads,bits,reps,"
+    "median_s,p95_s,min_s,mean_s,elems_per_s,gb_per_s,speedup,efficiency,"
+    "cycles,instructions,ipc,cache_misses,dtlb_misses,branch_misses,peak_rss_kb";
+
+void radix_report_header(FILE *f, radix_report_format fmt) {
+    if (fmt == RADIX_REPORT_CSV) fprintf(f, "%s\n", COLUMNS);
+}
+
+FILE *radix_report_open(const char *path, radix_report_format fmt) {
+    FILE *f = fopen(path, "a");
+    if (!f) return NULL;
+    fseek(f, 0, SEEK_END);
+    if (ftell(f) == 0) radix_report_header(f, fmt);
+    return f;
+}
+
+// Text field: CSV quotes it when needed, JSON always quotes and escapes.
+static void put_str(FILE *f, radix_report_format fmt, const char *s) {
+    if (!s) s = "";
+    if (fmt == RADIX_REPORT_CSV && !strpbrk(s, ",\"\n")) { fputs(s, f); return; }
+    fputc('"', f);
+    for (; *s; s++) {
+        if (*s == '"')                                   fputs(fmt == RADIX_REPORT_CSV ? "\"\"" : "\\\"", f);
+        else if (fmt == RADIX_REPORT_JSON && *s == '\\') fputs("\\\\", f);
+        else if (fmt == RADIX_REPORT_JSON && (unsigned char)*s < 0x20) fprintf(f, "\\u%04x", *s);
+        else                                             fputc(*s, f);
+    }
+    fputc('"', f);
+}
+
+// Counter columns in COLUMNS order, IPC between instructions and cache misses.
+static void put_counters(FILE *f, radix_report_format fmt, const radix_report_row *r) {
+    static const char *KEYS[RADIX_PERF_COUNT] = { "cycles", "instructions", "cache_misses", "dtlb_misses", "branch_misses" };
+    unsigned ipc_mask = (1u << RADIX_PERF_CYCLES) | (1u << RADIX_PERF_INSTRUCTIONS);
+    for (int c = 0; c < RADIX_PERF_COUNT; c++) {
+        int have = (r->counter_mask >> c) & 1;
+        if (fmt == RADIX_REPORT_CSV) {
+            if (have) fprintf(f, ",%.0f", r->counters[c]);
+            else      fputc(',', f);
+        } else {
+            if (have) fprintf(f, ", \"%s\": %.0f", KEYS[c], r->counters[c]);
+            else      fprintf(f, ", \"%s\": null", KEYS[c]);
+        }
+        if (c != RADIX_PERF_INSTRUCTIONS) continue;
+        int ipc = (r->counter_mask & ipc_mask) == ipc_mask && r->counters[RADIX_PERF_CYCLES] > 0;
+        double v = ipc ? r->counters[RADIX_PERF_INSTRUCTIONS] / r->counters[RADIX_PERF_CYCLES] : 0;
+        if (fmt == RADIX_REPORT_CSV) { if (ipc) fprintf(f, ",%.3f", v); else fputc(',', f); }
+        else                         { if (ipc) fprintf(f, ", \"ipc\": %.3f", v); else fputs(", \"ipc\": null", f); }
+    }
+}
+
+void radix_report_write(FILE *f, radix_report_format fmt, const radix_report_row *r) {
+    double eps = r->t.median > 0 ? r->n / r->t.median : 0;
+    double gbs = eps * r->elem_bytes / 1e9;
+    double eff = (r->speedup > 0 && r->threads > 0) ? r->speedup / r->threads : 0;
+    long long ts = (long long)time(NULL);
+
+    if (fmt == RADIX_REPORT_CSV) {
+        fprintf(f, "%lld,", ts);
+        put_str(f, fmt, r->tool);    fputc(',', f);
+        put_str(f, fmt, r->backend); fputc(',', f);
+        put_str(f, fmt, r->dataset);
+        fprintf(f, ",%zu,%d,%d,%d,%d,%.9f,%.9f,%.9f,%.9f,%.0f,%.4f,%.4f,%.4f",
+                r->n, r->elem_bytes, r->threads, r->bits, r->reps,
+                r->t.median, r->t.p95, r->t.min, r->t.mean, eps, gbs, r->speedup, eff);
+        put_counters(f, fmt, r);
+        if (r->peak_rss_kb) fprintf(f, ",%zu", r->peak_rss_kb);
+        else                fputc(',', f);
+        fputc('\n', f);
+    } else {
+        fprintf(f, "{\"timestamp\": %lld, \"tool\": ", ts);
+        put_str(f, fmt, r->tool);
+        fputs(", \"backend\": ", f);
+        put_str(f, fmt, r->backend);
+        fputs(", \"dataset\": ", f);
+        put_str(f, fmt, r->dataset);
+        fprintf(f, ", \"n\": %zu, \"elem_bytes\": %d, \"threads\": %d, \"bits\": %d, \"reps\": %d, "
+                   "\"median_s\": %.9f, \"p95_s\": %.9f, \"min_s\": %.9f, \"mean_s\": %.9f, "
+                   "\"elems_per_s\": %.0f, \"gb_per_s\": %.4f, \"speedup\": %.4f, \"efficiency\": %.4f",
+                r->n, r->elem_bytes, r->threads, r->bits, r->reps,
+                r->t.median, r->t.p95, r->t.min, r->t.mean, eps, gbs, r->speedup, eff);
+        put_counters(f, fmt, r);
+        if (r->peak_rss_kb) fprintf(f, ", \"peak_rss_kb\": %zu", r->peak_rss_kb);
+        else                fputs(", \"peak_rss_kb\": null", f);
+        fputs("}\n", f);
+    }
+    fflush(f);
+}
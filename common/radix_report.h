@@ -0,0 +1,66 @@
+// radix_report.h - timing statistics and CSV / JSON result rows shared by the drivers
+#ifndef RADIX_REPORT_H
+#define RADIX_REPORT_H
+
+#include <stddef.h>
+#include <stdio.h>
+#include "radix_perf.h"
+
+// Monotonic wall clock in seconds.
+double radix_now(void);
+
+/* ---------- Repetition statistics ---------- */
+typedef struct {
+    double median;
+    double p95;          // nearest rank: the ceil(0.95 * reps)-th fastest time
+    double min;
+    double mean;
+} radix_time_stats;
+
+// Sorts t[0, reps) in place and summarizes it (all zero when reps is 0).
+void radix_time_stats_compute(double *t, int reps, radix_time_stats *s);
+
+/* ---------- Peak memory ---------- */
+// Peak resident set size of this process in kB: VmHWM from /proc/self/status, or getrusage's
+// ru_maxrss where that is missing (0 if neither is). radix_peak_rss_reset starts the peak over
+// from the current RSS (writes "5" to /proc/self/clear_refs); returns -1 where the kernel does
+// not allow it, and the peak then covers the whole run so far.
+int    radix_peak_rss_reset(void);
+size_t radix_peak_rss_kb(void);
+
+/* ---------- Result rows ---------- */
+// CSV gets a header line when the file is new; JSON is one object per line (JSON Lines),
+// so both formats can be appended to run after run.
+typedef enum { RADIX_REPORT_CSV, RADIX_REPORT_JSON } radix_report_format;
+
+typedef struct {
+    const char *tool;       // program that measured the row
+    const char *backend;    // seq, pthreads, pthreads-msd, omp, python, ...
+    const char *dataset;
+    size_t n;
+    int    elem_bytes;      // 4 for the int32 datasets
+    int    threads;         // 1 for sequential backends
+    int    bits;            // digit width (0 = decimal)
+    int    reps;            // timed repetitions (warmups not included)
+    radix_time_stats t;
+    double speedup;         // seq median / this median, both measured here on the same data (0 = none)
+    unsigned counter_mask;  // radix_perf counters below that were measured (0 = timing only)
+    double counters[RADIX_PERF_COUNT];   // per sort, summed over all threads
+    size_t peak_rss_kb;     // peak RSS of the process while the row was measured (0 = not measured)
+} radix_report_row;
+
+// "csv" or "json". Returns -1 on anything else.
+int radix_report_parse_format(const char *s, radix_report_format *fmt);
+
+// Opens path for appending (CSV header written if the file is empty). Returns NULL on error.
+FILE *radix_report_open(const char *path, radix_report_format fmt);
+
+void radix_report_header(FILE *f, radix_report_format fmt);
+
+// One row. Elements/s and GB/s are derived from the median: n / median and
+// n * elem_bytes / median / 1e9 (bytes sorted, not memory traffic). Counters outside
+// counter_mask are left empty (CSV) or null (JSON); IPC is instructions / cycles. So is
+// peak_rss_kb when it is 0.
+void radix_report_write(FILE *f, radix_report_format fmt, const radix_report_row *r);
+
+#endif
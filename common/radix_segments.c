@@ -0,0 +1,79 @@
+// radix_segments.c - batched segmented sort on the radix_ctx pool
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include "radix_ctx_impl.h"
+#include "radix_trace.h"
+
+typedef struct {
+    void  *a;
+    const size_t *offsets;
+    size_t segments;
+    size_t big;                // larger segments are left for the whole pool afterwards
+    size_t largest;            // largest of the others: the scratch every thread needs
+    size_t chunk;              // segments claimed at a time
+    atomic_size_t next;        // first segment nobody has claimed yet
+} seg_state;
+
+// Claim chunks of segments until none are left. A thread that cannot get its scratch claims
+// nothing, so the others sort its share.
+static void seg_job(radix_ctx *ctx, int tid) {
+    seg_state *st = ctx->job_data;
+    const radix_plan *p = &ctx->plan;
+    void   *scratch = malloc(st->largest * ctx->elem);
+    size_t *hist    = malloc((size_t)p->passes * p->buckets * sizeof(size_t));
+    (void)tid;
+    while (scratch && hist) {
+        size_t first = atomic_fetch_add_explicit(&st->next, st->chunk, memory_order_relaxed);
+        if (first >= st->segments) break;
+        size_t last = first + st->chunk < st->segments ? first + st->chunk : st->segments;
+        RADIX_TRACE_START(t0);
+        for (size_t i = first; i < last; i++) {
+            size_t lo = st->offsets[i], n = st->offsets[i + 1] - lo;
+            if (n > st->big) continue;
+            if (p->width == 32) radix_sort_segment32((uint32_t *)st->a + lo, scratch, n, p, hist);
+            else                radix_sort_segment64((uint64_t *)st->a + lo, scratch, n, p, hist);
+        }
+        RADIX_TRACE_STOP(tid, RADIX_PH_TASK, -1, t0);
+    }
+    free(scratch);
+    free(hist);
+}
+
+int radix_ctx_sort_segments(radix_ctx *ctx, void *a, const size_t *offsets, size_t segments,
+                            radix_key_type type, int bits) {
+    radix_plan plan;
+    if (radix_plan_init(&plan, type, bits, radix_key_max(type)) != 0) return -1;
+    size_t total = segments ? offsets[segments] - offsets[0] : 0;
+    if (total <= ctx->seq_cutoff || ctx->threads == 1)
+        return radix_sort_segments(a, offsets, segments, type, bits);
+
+    // A segment holding more than a thread's share of the keys would leave the others idle
+    seg_state st = { a, offsets, segments, total / ctx->threads, 0, 0, 0 };
+    if (st.big < ctx->seq_cutoff) st.big = ctx->seq_cutoff;
+    for (size_t i = 0; i < segments; i++) {
+        size_t n = offsets[i + 1] - offsets[i];
+        if (n <= st.big && n > st.largest) st.largest = n;
+    }
+    st.chunk = segments / ((size_t)ctx->threads * 16);   // about 16 claims per thread
+    if (st.chunk < 1)  st.chunk = 1;
+    if (st.chunk > 64) st.chunk = 64;
+
+    if (st.largest > 1) {
+        pthread_mutex_lock(&ctx->sort_lock);
+        ctx->plan = plan;
+        ctx->elem = (size_t)plan.width / 8;
+        ctx->job_data = &st;
+        radix_ctx_run(ctx, seg_job);
+        ctx->job_data = NULL;
+        pthread_mutex_unlock(&ctx->sort_lock);
+        if (atomic_load(&st.next) < segments) return -1;   // no thread got its scratch
+    }
+
+    size_t elem = (size_t)plan.width / 8;
+    for (size_t i = 0; i < segments; i++) {
+        size_t n = offsets[i + 1] - offsets[i];
+        if (n > st.big && radix_ctx_sort(ctx, (char *)a + offsets[i] * elem, n, type, bits) != 0) return -1;
+    }
+    return 0;
+}
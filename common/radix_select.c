@@ -0,0 +1,225 @@
+// radix_select.c - radix-select and top-k on the radix_ctx pool
+#include <stdlib.h>
+#include <string.h>
+#include "radix_ctx_impl.h"
+#include "radix_trace.h"
+
+typedef struct {
+    radix_plan plan;         // RADIX_SELECT_BITS digits over the bits in which the keys differ
+    uint64_t prefix;         // key bits fixed so far
+    const char *src;         // candidates of this level: the caller's array, then buf[0] / buf[1]
+    char   *buf[2];          // written in turn: in place, one slice's output could overrun the next one's input
+    size_t  buf_n[2];        // elements each can hold
+    int     next;            // buffer the next copy goes to
+    char   *dst;             // this level's copy target, NULL when every candidate stays
+    size_t  k;               // rank of the wanted element among the candidates
+    int     pass;            // digit position of the next level (-1: key complete)
+    uint32_t d;              // bucket kept
+    int     done;
+    int     failed;          // out of memory
+    size_t *rows;            // per thread: digit histogram (or value counts) of my slice
+    size_t *at;              // per thread: my first slot in dst / my count for take_job
+    uint64_t t;              // take_job: key of the k-th element, taken from arr into dst
+    int     above;
+    uint64_t min_key;        // range_job: values counted from here
+    size_t  range;
+} select_state;
+
+// Few distinct values: count my slice per value, as radix_ctx_sort_counting does
+static void range_job(radix_ctx *ctx, int tid) {
+    select_state *st = ctx->job_data;
+    const radix_plan *p = &ctx->plan;
+    size_t *row = st->rows + (size_t)tid * st->range, lo, hi;
+    radix_ctx_slice(ctx, tid, &lo, &hi);
+    RADIX_TRACE_START(t0);
+    memset(row, 0, st->range * sizeof(size_t));
+    if (p->width == 32) radix_count_range32((const uint32_t *)ctx->arr, lo, hi, p, (uint32_t)st->min_key, row);
+    else                radix_count_range64((const uint64_t *)ctx->arr, lo, hi, p, st->min_key, row);
+    RADIX_TRACE_STOP(tid, RADIX_PH_HISTOGRAM, -1, t0);
+}
+
+// tid 0 between the histogram and the copy of a level: keep the bucket of the k-th candidate,
+// and stop once the key is complete or few enough candidates are left for one thread.
+static void select_pick(radix_ctx *ctx, select_state *st) {
+    const radix_plan *p = &st->plan;
+    size_t m = ctx->n;
+    size_t kept = radix_select_bucket(st->rows, ctx->threads, p->buckets, &st->k, st->at, &st->d);
+    st->prefix |= (uint64_t)st->d << (st->pass * p->bits);
+    st->dst = NULL;
+    if (st->pass > 0 && kept < m) {
+        int b = st->next;
+        if (st->buf_n[b] < kept) {           // only the first use of each buffer allocates
+            free(st->buf[b]);
+            st->buf[b] = malloc(kept * ctx->elem);
+            st->buf_n[b] = st->buf[b] ? kept : 0;
+        }
+        if (!st->buf[b]) { st->failed = 1; st->done = 1; return; }
+        st->dst = st->buf[b];
+        st->src = st->dst;               // every thread has taken this level's source already
+        st->next ^= 1;
+        ctx->n = kept;
+    }
+    st->pass--;
+    st->done = st->pass < 0 || ctx->n <= ctx->seq_cutoff;
+}
+
+// Every level: 1. histogram my slice of the candidates  2. tid 0 picks the bucket
+// 3. copy my candidates in it to their slots in the next buffer
+static void select_job(radix_ctx *ctx, int tid) {
+    select_state *st = ctx->job_data;
+    const radix_plan *p = &st->plan;
+    size_t *row = st->rows + (size_t)tid * p->buckets;
+    while (!st->done) {
+        size_t lo, hi;
+        radix_ctx_slice(ctx, tid, &lo, &hi);
+        const char *src = st->src;
+        int pass = st->pass;
+
+        RADIX_TRACE_START(t0);
+        memset(row, 0, p->buckets * sizeof(size_t));
+        if (p->width == 32) radix_histogram32((const uint32_t *)src, lo, hi, p, pass, RADIX_PASS_FIRST, row);
+        else                radix_histogram64((const uint64_t *)src, lo, hi, p, pass, RADIX_PASS_FIRST, row);
+        RADIX_TRACE_STOP(tid, RADIX_PH_HISTOGRAM, pass, t0);
+        RADIX_TRACE_START(t_wait1);
+        radix_ctx_wait(ctx);             // every row is complete
+        if (tid == 0) select_pick(ctx, st);
+        radix_ctx_wait(ctx);             // bucket, slots and target are known
+        RADIX_TRACE_STOP(tid, RADIX_PH_BARRIER, pass, t_wait1);
+
+        if (st->dst) {
+            RADIX_TRACE_START(t1);
+            char *dst = st->dst + st->at[tid] * ctx->elem;
+            size_t mine = row[st->d];
+            if (p->width == 32)
+                radix_filter_digit32((const uint32_t *)src, lo, hi, p, pass, st->d, (uint32_t *)dst, mine);
+            else
+                radix_filter_digit64((const uint64_t *)src, lo, hi, p, pass, st->d, (uint64_t *)dst, mine);
+            RADIX_TRACE_STOP(tid, RADIX_PH_SCATTER, pass, t1);
+            RADIX_TRACE_START(t_wait2);
+            radix_ctx_wait(ctx);         // the next level reads what the others copied
+            RADIX_TRACE_STOP(tid, RADIX_PH_BARRIER, pass, t_wait2);
+        }
+    }
+}
+
+// 1. count my elements before the k-th one  2. copy them to my slots of dst
+static void take_job(radix_ctx *ctx, int tid) {
+    select_state *st = ctx->job_data;
+    const radix_plan *p = &st->plan;
+    size_t lo, hi;
+    radix_ctx_slice(ctx, tid, &lo, &hi);
+    RADIX_TRACE_START(t0);
+    if (p->width == 32) st->at[tid] = radix_take32((const uint32_t *)ctx->arr, lo, hi, p, (uint32_t)st->t, st->above, NULL, 0);
+    else                st->at[tid] = radix_take64((const uint64_t *)ctx->arr, lo, hi, p, st->t, st->above, NULL, 0);
+    RADIX_TRACE_STOP(tid, RADIX_PH_HISTOGRAM, -1, t0);
+    radix_ctx_wait(ctx);
+
+    RADIX_TRACE_START(t1);
+    size_t at = 0;
+    for (int t = 0; t < tid; t++) at += st->at[t];
+    char *dst = st->dst + at * ctx->elem;
+    size_t mine = st->at[tid];
+    if (p->width == 32) radix_take32((const uint32_t *)ctx->arr, lo, hi, p, (uint32_t)st->t, st->above, (uint32_t *)dst, mine);
+    else                radix_take64((const uint64_t *)ctx->arr, lo, hi, p, st->t, st->above, (uint64_t *)dst, mine);
+    RADIX_TRACE_STOP(tid, RADIX_PH_SCATTER, -1, t1);
+}
+
+int radix_ctx_select_key(radix_ctx *ctx, const void *a, size_t n, radix_key_type type, size_t k,
+                         uint64_t *key) {
+    if (k >= n) return -1;
+    if (n <= ctx->seq_cutoff || ctx->threads == 1) return radix_select_key(a, n, type, k, key);
+
+    select_state st;
+    memset(&st, 0, sizeof(st));
+    pthread_mutex_lock(&ctx->sort_lock);
+    uint64_t mn, mx;
+    radix_ctx_key_range(ctx, a, n, type, &mn, &mx);   // also points the pool at a[0, n)
+
+    // Few distinct values: one count row per thread, summed by radix_select_bucket
+    if (mx - mn < n / ctx->threads && mx - mn < RADIX_COUNT_MAX_RANGE) {
+        st.min_key = mn;
+        st.range = (size_t)(mx - mn) + 1;
+        st.rows = malloc((size_t)ctx->threads * st.range * sizeof(size_t));
+        if (st.rows) {
+            ctx->job_data = &st;
+            radix_ctx_run(ctx, range_job);
+            ctx->job_data = NULL;
+        }
+        pthread_mutex_unlock(&ctx->sort_lock);
+        if (!st.rows) return -1;
+        uint32_t v;
+        radix_select_bucket(st.rows, ctx->threads, (uint32_t)st.range, &k, NULL, &v);
+        free(st.rows);
+        *key = mn + v;
+        return 0;
+    }
+
+    st.rows = malloc(((size_t)ctx->threads << RADIX_SELECT_BITS) * sizeof(size_t));
+    st.at   = malloc((size_t)ctx->threads * sizeof(size_t));
+    if (!st.rows || !st.at) {
+        pthread_mutex_unlock(&ctx->sort_lock);
+        free(st.rows); free(st.at);
+        return -1;
+    }
+    radix_select_plan(&st.plan, type, mn, mx, &st.prefix);
+    st.src  = a;
+    st.k    = k;
+    st.pass = st.plan.passes - 1;
+    st.done = st.pass < 0;
+    ctx->job_data = &st;
+    radix_ctx_run(ctx, select_job);
+    ctx->job_data = NULL;
+    size_t m = ctx->n;
+    pthread_mutex_unlock(&ctx->sort_lock);
+
+    int rc = 0;
+    if (st.failed)       rc = -1;
+    else if (st.pass < 0) *key = st.prefix;
+    else                  rc = radix_select_key(st.src, m, type, st.k, key);   // few left: finish alone
+    free(st.buf[0]);
+    free(st.buf[1]);
+    free(st.rows);
+    free(st.at);
+    return rc;
+}
+
+int radix_ctx_select(radix_ctx *ctx, const void *a, size_t n, radix_key_type type, size_t k, void *out) {
+    uint64_t key;
+    if (radix_ctx_select_key(ctx, a, n, type, k, &key) != 0) return -1;
+    if (radix_key_width(type) == 32) *(uint32_t *)out = radix_raw32(type, (uint32_t)key);
+    else                             *(uint64_t *)out = radix_raw64(type, key);
+    return 0;
+}
+
+int radix_ctx_topk(radix_ctx *ctx, const void *a, size_t n, radix_key_type type, size_t k, int largest,
+                   void *out) {
+    if (k > n) return -1;
+    if (k == 0) return 0;
+    if (n <= ctx->seq_cutoff || ctx->threads == 1) return radix_topk(a, n, type, k, largest, out);
+
+    select_state st;
+    memset(&st, 0, sizeof(st));
+    if (radix_ctx_select_key(ctx, a, n, type, largest ? n - k : k - 1, &st.t) != 0) return -1;
+    st.at = malloc((size_t)ctx->threads * sizeof(size_t));
+    if (!st.at) return -1;
+    radix_plan_init(&st.plan, type, 8, 0);   // key transform only
+    st.above = largest;
+    st.dst = out;
+
+    pthread_mutex_lock(&ctx->sort_lock);
+    ctx->arr  = (void *)a;
+    ctx->lo   = 0;
+    ctx->n    = n;
+    ctx->elem = (size_t)radix_key_width(type) / 8;
+    ctx->job_data = &st;
+    radix_ctx_run(ctx, take_job);
+    ctx->job_data = NULL;
+    pthread_mutex_unlock(&ctx->sort_lock);
+
+    size_t taken = 0;
+    for (int t = 0; t < ctx->threads; t++) taken += st.at[t];
+    free(st.at);
+    if (radix_ctx_sort(ctx, out, taken, type, 11) != 0) return -1;
+    radix_topk_finish(out, taken, k, type, st.t, largest);
+    return 0;
+}
@@ -0,0 +1,420 @@
+// radix_stream.c - pipelined text sort: reader and writer threads around the radix_ctx pool
+#include <errno.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/uio.h>
+#include "radix_stream.h"
+#include "radix_bin.h"
+#include "radix_ctx_impl.h"
+#include "radix_io.h"
+#include "radix_trace.h"
+
+#define STREAM_CARRY       64        // room in front of a block for the unfinished number of the one before
+#define STREAM_SPLIT_BITS  11        // digits counted during the input; the partition uses one of them
+#define STREAM_MIN_BLOCK   4096
+#define STREAM_WINDOW      4         // output blocks of values sorted per radix_ctx_sort_segments call
+
+void radix_stream_config_init(radix_stream_config *cfg) {
+    cfg->threads     = RADIX_CTX_DEFAULT_THREADS;
+    cfg->bits        = 11;
+    cfg->block_bytes = RADIX_STREAM_DEFAULT_BLOCK;
+    cfg->out_format  = RADIX_STREAM_TEXT;
+}
+
+static double now_secs(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec + t.tv_nsec / 1e9;
+}
+
+// Bytes a block must not be cut after: the token may go on in the next block
+static inline int in_token(unsigned char c) {
+    return !(c == ' ' || c == '\n' || c == '\r' || c == '\t' || c == '\v' || c == '\f');
+}
+
+// Full write (short transfers are retried). Returns 0 or -1 with errno set.
+static int write_full(int fd, const char *p, size_t bytes) {
+    while (bytes > 0) {
+        ssize_t k = write(fd, p, bytes);
+        if (k < 0 && errno == EINTR) continue;
+        if (k <= 0) { if (k == 0) errno = EIO; return -1; }
+        p += k; bytes -= (size_t)k;
+    }
+    return 0;
+}
+
+/* ---------- Reader and writer threads ---------- */
+// Two slots per thread, used in turn. The reader fills a slot and marks it full, the parser
+// marks it empty once done with it; the writer drains slots the sorter filled the same way.
+typedef struct {
+    char  *buf;            // reader: STREAM_CARRY bytes of room, then the block
+    size_t len;            // reader: bytes read
+    struct iovec *iov;     // writer: pieces written in order
+    int    iovcnt;
+    int    full;
+    int    eof;            // reader: last block (end of input or a read error)
+} stream_slot;
+
+typedef struct {
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t  cond;
+    int    fd;
+    size_t block;
+    stream_slot slot[2];
+    int    stop;
+    int    err;            // first errno seen
+    double io_secs;        // inside read() / write()
+} stream_pipe;
+
+static void *reader_main(void *arg) {
+    stream_pipe *sp = (stream_pipe *)arg;
+    for (int s = 0;; s ^= 1) {
+        stream_slot *sl = &sp->slot[s];
+        pthread_mutex_lock(&sp->lock);
+        while (sl->full && !sp->stop) pthread_cond_wait(&sp->cond, &sp->lock);
+        int stop = sp->stop;
+        pthread_mutex_unlock(&sp->lock);
+        if (stop) break;
+
+        // A whole block unless the input ends: pipes hand out a few KB per read
+        double t0 = now_secs();
+        char *dst = sl->buf + STREAM_CARRY;
+        size_t got = 0;
+        int eof = 0, err = 0;
+        while (got < sp->block) {
+            ssize_t k = read(sp->fd, dst + got, sp->block - got);
+            if (k < 0 && errno == EINTR) continue;
+            if (k < 0) err = errno;
+            if (k <= 0) { eof = 1; break; }
+            got += (size_t)k;
+        }
+        double t1 = now_secs();
+
+        pthread_mutex_lock(&sp->lock);
+        sp->io_secs += t1 - t0;
+        if (err && !sp->err) sp->err = err;
+        sl->len  = got;
+        sl->eof  = eof;
+        sl->full = 1;
+        pthread_cond_broadcast(&sp->cond);
+        pthread_mutex_unlock(&sp->lock);
+        if (eof) break;
+    }
+    return NULL;
+}
+
+// Slots are filled in the order they are written, so an empty one means nothing else is queued.
+static void *writer_main(void *arg) {
+    stream_pipe *sp = (stream_pipe *)arg;
+    for (int s = 0;; s ^= 1) {
+        stream_slot *sl = &sp->slot[s];
+        pthread_mutex_lock(&sp->lock);
+        while (!sl->full && !sp->stop) pthread_cond_wait(&sp->cond, &sp->lock);
+        int failed = sp->err;
+        pthread_mutex_unlock(&sp->lock);
+        if (!sl->full) break;
+
+        double t0 = now_secs();
+        int err = 0;
+        for (int i = 0; i < sl->iovcnt && !failed && !err; i++)
+            if (write_full(sp->fd, sl->iov[i].iov_base, sl->iov[i].iov_len) != 0) err = errno;
+        double t1 = now_secs();
+
+        pthread_mutex_lock(&sp->lock);
+        sp->io_secs += t1 - t0;
+        if (err && !sp->err) sp->err = err;
+        sl->full = 0;
+        pthread_cond_broadcast(&sp->cond);
+        pthread_mutex_unlock(&sp->lock);
+    }
+    return NULL;
+}
+
+static int pipe_start(stream_pipe *sp, void *(*fn)(void *)) {
+    pthread_mutex_init(&sp->lock, NULL);
+    pthread_cond_init(&sp->cond, NULL);
+    if (pthread_create(&sp->thread, NULL, fn, sp) != 0) {
+        pthread_mutex_destroy(&sp->lock);
+        pthread_cond_destroy(&sp->cond);
+        return -1;
+    }
+    return 0;
+}
+
+// The writer finishes every queued slot first; the reader its current block.
+static void pipe_stop(stream_pipe *sp) {
+    pthread_mutex_lock(&sp->lock);
+    sp->stop = 1;
+    pthread_cond_broadcast(&sp->cond);
+    pthread_mutex_unlock(&sp->lock);
+    pthread_join(sp->thread, NULL);
+    pthread_mutex_destroy(&sp->lock);
+    pthread_cond_destroy(&sp->cond);
+}
+
+// Waits until slot s is full (or empty). Returns the pipe's errno so far.
+static int slot_wait(stream_pipe *sp, int s, int full) {
+    pthread_mutex_lock(&sp->lock);
+    while (sp->slot[s].full != full) pthread_cond_wait(&sp->cond, &sp->lock);
+    int err = sp->err;
+    pthread_mutex_unlock(&sp->lock);
+    return err;
+}
+
+static void slot_set(stream_pipe *sp, int s, int full) {
+    pthread_mutex_lock(&sp->lock);
+    sp->slot[s].full = full;
+    pthread_cond_broadcast(&sp->cond);
+    pthread_mutex_unlock(&sp->lock);
+}
+
+/* ---------- Pool jobs ---------- */
+typedef struct {
+    const uint32_t *src;   // parsed values, block after block
+    uint32_t *dst;
+    const size_t *blk_lo;  // block b holds src[blk_lo[b], blk_lo[b + 1])
+    size_t *off;           // per block: its next slot in dst for every bucket
+    size_t  blocks;
+    radix_plan plan;
+    int     pass;
+} split_state;
+
+// Every block's counts were taken while it was parsed, so its slots are known up front:
+// threads scatter whole blocks, without a histogram pass or a barrier.
+static void split_job(radix_ctx *ctx, int tid) {
+    split_state *st = ctx->job_data;
+    RADIX_TRACE_START(t0);
+    for (size_t b = (size_t)tid; b < st->blocks; b += (size_t)ctx->threads)
+        radix_scatter32(st->src, st->dst, st->blk_lo[b], st->blk_lo[b + 1], &st->plan, st->pass,
+                        RADIX_PASS_FIRST | RADIX_PASS_LAST, st->off + b * st->plan.buckets);
+    RADIX_TRACE_STOP(tid, RADIX_PH_SCATTER, st->pass, t0);
+}
+
+typedef struct {
+    const int32_t *src;    // values of this write
+    char *text;            // my text starts at text + lo * RADIX_TEXT_MAX_I32
+    struct iovec *iov;     // per thread: my text, written in tid order
+} format_state;
+
+static void format_job(radix_ctx *ctx, int tid) {
+    format_state *st = ctx->job_data;
+    size_t lo, hi;
+    radix_ctx_slice(ctx, tid, &lo, &hi);
+    RADIX_TRACE_START(t0);
+    char *out = st->text + lo * RADIX_TEXT_MAX_I32;
+    st->iov[tid].iov_base = out;
+    st->iov[tid].iov_len  = radix_format_i32(st->src + lo, hi - lo, out);
+    RADIX_TRACE_STOP(tid, RADIX_PH_COPY, -1, t0);
+}
+
+static void run_job(radix_ctx *ctx, radix_job job, void *data, size_t n) {
+    pthread_mutex_lock(&ctx->sort_lock);
+    ctx->lo = 0;
+    ctx->n  = n;
+    ctx->job_data = data;
+    radix_ctx_run(ctx, job);
+    ctx->job_data = NULL;
+    pthread_mutex_unlock(&ctx->sort_lock);
+}
+
+/* ---------- Sort ---------- */
+int radix_stream_sort(int in_fd, int out_fd, const radix_stream_config *cfg, radix_stream_stats *st) {
+    radix_stream_config def;
+    if (!cfg) { radix_stream_config_init(&def); cfg = &def; }
+    radix_stream_stats stats;
+    memset(&stats, 0, sizeof(stats));
+    double t_start = now_secs();
+
+    size_t block = cfg->block_bytes < STREAM_MIN_BLOCK ? STREAM_MIN_BLOCK : cfg->block_bytes;
+    int text_out = cfg->out_format == RADIX_STREAM_TEXT;
+    size_t piece = block / (text_out ? RADIX_TEXT_MAX_I32 : sizeof(int32_t));   // values per write
+
+    radix_plan hp;                       // every 11-bit digit of the key, counted per block
+    radix_plan_init(&hp, RADIX_I32, STREAM_SPLIT_BITS, UINT32_MAX);
+    size_t row = (size_t)hp.passes * hp.buckets;
+
+    radix_ctx_config cc;
+    radix_ctx_config_init(&cc);
+    cc.threads = cfg->threads;
+    radix_ctx *ctx = radix_ctx_create(&cc);
+
+    stream_pipe in, out;
+    memset(&in, 0, sizeof(in));
+    memset(&out, 0, sizeof(out));
+    int in_on = 0, out_on = 0, err = ENOMEM;
+    int32_t *arr = NULL;
+    uint32_t *sorted = NULL;
+    size_t cap = 0, nblk = 0, blk_cap = 0;
+    size_t *blk_lo = NULL, *hist = NULL, *total = NULL, *off = NULL, *bstart = NULL;
+    radix_load_stats ls = { 0, INT32_MAX, INT32_MIN };
+
+    /* 1. Input: parse and count one block while the reader fills the other */
+    in.fd    = in_fd;
+    in.block = block;
+    for (int s = 0; s < 2; s++) in.slot[s].buf = malloc(STREAM_CARRY + block);
+    if (!ctx || !in.slot[0].buf || !in.slot[1].buf) goto done;
+    if (pipe_start(&in, reader_main) != 0) { err = errno ? errno : EAGAIN; goto done; }
+    in_on = 1;
+
+    size_t carry = 0;                    // bytes of an unfinished number in front of the block
+    for (int s = 0;; s ^= 1) {
+        slot_wait(&in, s, 1);
+        stream_slot *sl = &in.slot[s];
+        char  *data = sl->buf + STREAM_CARRY - carry;
+        size_t len  = carry + sl->len, cut = len;
+        if (!sl->eof)                    // the last number may go on in the next block
+            while (cut > 0 && in_token((unsigned char)data[cut - 1]) && len - cut < STREAM_CARRY) cut--;
+        stats.in_bytes += sl->len;
+
+        if (nblk + 2 > blk_cap) {
+            size_t want = blk_cap ? blk_cap * 2 : 64;
+            size_t *lo = realloc(blk_lo, want * sizeof(size_t));
+            if (lo) blk_lo = lo;
+            size_t *h = lo ? realloc(hist, want * row * sizeof(size_t)) : NULL;
+            if (!h) goto done;
+            hist = h;
+            blk_cap = want;
+        }
+        blk_lo[nblk] = ls.n;
+        if (radix_parse_i32(data, cut, cfg->threads, &arr, &cap, &ls) != 0) { err = errno; goto done; }
+        size_t *h = hist + nblk * row;
+        memset(h, 0, row * sizeof(size_t));
+        radix_histogram_all32((const uint32_t *)arr, blk_lo[nblk], ls.n, &hp, RADIX_PASS_FIRST, h);
+        nblk++;
+
+        int eof = sl->eof;
+        carry = len - cut;
+        if (!eof) memcpy(in.slot[s ^ 1].buf + STREAM_CARRY - carry, data + cut, carry);
+        slot_set(&in, s, 0);
+        if (eof) break;
+    }
+    blk_lo[nblk] = ls.n;
+    pipe_stop(&in);
+    in_on = 0;
+    if (in.err) { err = in.err; goto done; }
+    size_t n = ls.n;
+    stats.count  = n;
+    stats.blocks = nblk;
+    double t_in = now_secs();
+
+    /* 2. Partition on the top digit position where the keys differ */
+    uint32_t nb = 1;
+    total  = calloc(row, sizeof(size_t));
+    bstart = malloc(((size_t)hp.buckets + 1) * sizeof(size_t));
+    if (!total || !bstart) goto done;
+    for (size_t b = 0; b < nblk; b++)
+        for (size_t i = 0; i < row; i++) total[i] += hist[b * row + i];
+    radix_plan_skip_trivial(&hp, total, n);
+    int top = hp.passes - 1;
+    while (top >= 0 && radix_pass_skipped(&hp, top)) top--;
+
+    if (top < 0) {                       // at most one distinct value: already in order
+        sorted = (uint32_t *)arr;
+        arr = NULL;
+        bstart[0] = 0;
+        bstart[1] = n;
+    } else {
+        nb = hp.buckets;
+        sorted = malloc((n ? n : 1) * sizeof(uint32_t));
+        off = malloc(nblk * hp.buckets * sizeof(size_t));
+        if (!sorted || !off) goto done;
+        size_t pos = 0;
+        for (uint32_t d = 0; d < nb; d++) {
+            bstart[d] = pos;
+            for (size_t b = 0; b < nblk; b++) {
+                off[b * hp.buckets + d] = pos;
+                pos += hist[b * row + (size_t)top * hp.buckets + d];
+            }
+        }
+        bstart[nb] = n;
+        split_state sp = { (const uint32_t *)arr, sorted, blk_lo, off, nblk, hp, top };
+        run_job(ctx, split_job, &sp, n);
+        free(arr);
+        arr = NULL;
+    }
+    double t_split = now_secs();
+
+    /* 3. Output: sort a window of buckets, format it in parallel, queue it, go on with the next */
+    out.fd    = out_fd;
+    out.block = block;
+    for (int s = 0; s < 2; s++) {
+        out.slot[s].iov = malloc((size_t)(text_out ? ctx->threads : 1) * sizeof(struct iovec));
+        if (text_out) out.slot[s].buf = malloc(piece * RADIX_TEXT_MAX_I32);
+        if (!out.slot[s].iov || (text_out && !out.slot[s].buf)) goto done;
+    }
+    if (!text_out) {
+        radix_bin_header h;
+        uint64_t mm[2] = { (uint32_t)ls.min, (uint32_t)ls.max };
+        radix_bin_header_init(&h, RADIX_I32, n, n ? mm : NULL);
+        double t0 = now_secs();
+        if (write_full(out_fd, (const char *)&h, sizeof(h)) != 0) { err = errno; goto done; }
+        out.io_secs += now_secs() - t0;
+        stats.out_bytes += sizeof(h);
+    }
+    if (pipe_start(&out, writer_main) != 0) { err = errno ? errno : EAGAIN; goto done; }
+    out_on = 1;
+
+    int s = 0;
+    for (uint32_t d = 0; d < nb;) {
+        uint32_t e = d + 1;
+        while (e < nb && bstart[e + 1] - bstart[d] <= STREAM_WINDOW * piece) e++;
+        if (radix_ctx_sort_segments(ctx, sorted, bstart + d, e - d, RADIX_I32, cfg->bits) != 0) {
+            err = EINVAL;
+            goto done;
+        }
+        for (size_t pos = bstart[d], m; pos < bstart[e]; pos += m) {
+            m = bstart[e] - pos < piece ? bstart[e] - pos : piece;
+            if ((err = slot_wait(&out, s, 0)) != 0) goto done;
+            stream_slot *sl = &out.slot[s];
+            if (text_out) {
+                format_state fs = { (const int32_t *)sorted + pos, sl->buf, sl->iov };
+                run_job(ctx, format_job, &fs, m);
+                sl->iovcnt = ctx->threads;
+                for (int t = 0; t < ctx->threads; t++) stats.out_bytes += sl->iov[t].iov_len;
+            } else {
+                sl->iov[0].iov_base = sorted + pos;
+                sl->iov[0].iov_len  = m * sizeof(uint32_t);
+                sl->iovcnt = 1;
+                stats.out_bytes += m * sizeof(uint32_t);
+            }
+            slot_set(&out, s, 1);
+            s ^= 1;
+        }
+        d = e;
+    }
+    pipe_stop(&out);
+    out_on = 0;
+    err = out.err;
+    double t_end = now_secs();
+
+    stats.input_secs     = t_in - t_start;
+    stats.partition_secs = t_split - t_in;
+    stats.output_secs    = t_end - t_split;
+    stats.total_secs     = t_end - t_start;
+    stats.read_secs      = in.io_secs;
+    stats.write_secs     = out.io_secs;
+    if (st) *st = stats;
+
+done:
+    if (in_on) pipe_stop(&in);
+    if (out_on) pipe_stop(&out);
+    for (int i = 0; i < 2; i++) {
+        free(in.slot[i].buf);
+        free(out.slot[i].buf);
+        free(out.slot[i].iov);
+    }
+    free(arr);
+    free(sorted);
+    free(blk_lo);
+    free(hist);
+    free(total);
+    free(off);
+    free(bstart);
+    if (ctx) radix_ctx_destroy(ctx);
+    if (err) { errno = err; return -1; }
+    return 0;
+}
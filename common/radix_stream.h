@@ -0,0 +1,49 @@
+// radix_stream.h - pipelined text sort: read, parse, sort and write overlap instead of running one after the other
+#ifndef RADIX_STREAM_H
+#define RADIX_STREAM_H
+
+#include <stddef.h>
+
+typedef enum {
+    RADIX_STREAM_TEXT,     // one decimal value per line
+    RADIX_STREAM_BIN       // a RADIX_I32 binary dataset (radix_bin.h), header included
+} radix_stream_format;
+
+typedef struct {
+    int    threads;        // radix_ctx pool and parser threads
+    int    bits;           // digit width of the bucket sorts (RADIX_DECIMAL, 8, 11, 16)
+    size_t block_bytes;    // input read per block, also the size of one output write
+    radix_stream_format out_format;
+} radix_stream_config;
+
+#define RADIX_STREAM_DEFAULT_BLOCK  ((size_t)8 << 20)
+
+typedef struct {
+    size_t count;          // values sorted
+    size_t blocks;         // input blocks
+    size_t in_bytes, out_bytes;
+    double input_secs;     // first read to last block parsed and counted
+    double partition_secs; // scatter on the top digit that differs
+    double output_secs;    // bucket sorts and formatting while the writer drains
+    double total_secs;
+    double read_secs;      // inside read() on the reader thread
+    double write_secs;     // inside write() on the writer thread
+} radix_stream_stats;
+
+// Fills *cfg with: 4 threads, 11-bit digits, RADIX_STREAM_DEFAULT_BLOCK, text output.
+void radix_stream_config_init(radix_stream_config *cfg);
+
+// Reads decimal int32 values (radix_load_i32 syntax) from in_fd until end of input and
+// writes them sorted to out_fd. Pipes and terminals work as well as files.
+//   1. A reader thread fills two blocks in turn. While it reads one, the other is parsed
+//      in parallel and its keys are counted at every 11-bit digit position.
+//   2. At end of input those counts give the top digit position where keys differ, and
+//      the pool scatters every block to its buckets on that digit in one pass.
+//   3. Buckets are sorted in windows of a few output blocks (radix_ctx_sort_segments);
+//      each block is formatted in parallel and handed to a writer thread, which writes it
+//      while the next one is formatted or the next window sorted.
+// All values are held in memory (about 2 x 4 bytes each). cfg and st may be NULL.
+// Returns 0, or -1 with errno set.
+int radix_stream_sort(int in_fd, int out_fd, const radix_stream_config *cfg, radix_stream_stats *st);
+
+#endif
@@ -0,0 +1,135 @@
+// radix_topo.c - online CPUs, package and core ids from sysfs; placement plans and pinning
+#define _GNU_SOURCE
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "radix_topo.h"
+
+#define SYS_CPU  "/sys/devices/system/cpu"
+
+typedef struct {
+    int cpu;
+    int package;     // physical_package_id (0 if unknown)
+    int core;        // core_id within the package (the cpu number if unknown)
+    int sibling;     // 0 for the first hardware thread of its core, 1 for the next, ...
+} cpu_info;
+
+const char *radix_pin_name(radix_pin_kind kind) {
+    return kind == RADIX_PIN_COMPACT ? "compact" : kind == RADIX_PIN_SPREAD ? "spread" : "none";
+}
+
+int radix_pin_parse(const char *name, radix_pin_kind *kind) {
+    if (strcmp(name, "none") == 0)    { *kind = RADIX_PIN_NONE;    return 0; }
+    if (strcmp(name, "compact") == 0) { *kind = RADIX_PIN_COMPACT; return 0; }
+    if (strcmp(name, "spread") == 0)  { *kind = RADIX_PIN_SPREAD;  return 0; }
+    return -1;
+}
+
+static int read_int(const char *path, int fallback) {
+    FILE *f = fopen(path, "r");
+    int v;
+    if (!f) return fallback;
+    if (fscanf(f, "%d", &v) != 1) v = fallback;
+    fclose(f);
+    return v;
+}
+
+static int by_placement(const void *a, const void *b) {
+    const cpu_info *x = a, *y = b;
+    if (x->package != y->package) return x->package - y->package;
+    if (x->sibling != y->sibling) return x->sibling - y->sibling;
+    if (x->core != y->core)       return x->core - y->core;
+    return x->cpu - y->cpu;
+}
+
+// Usable CPUs in placement order: package by package, first hardware thread of every core
+// before the SMT siblings. Returns how many (0 if neither sysfs nor the affinity mask is readable).
+static int load_cpus(cpu_info *c) {
+    cpu_set_t allowed;
+    int masked = sched_getaffinity(0, sizeof(allowed), &allowed) == 0;
+    int n = 0;
+
+    // "online" is a list like 0-3,8-11
+    char list[4096];
+    FILE *f = fopen(SYS_CPU "/online", "r");
+    if (f) {
+        if (!fgets(list, sizeof(list), f)) list[0] = '\0';
+        fclose(f);
+        for (char *s = list; *s && *s != '\n'; ) {
+            char *end;
+            long lo = strtol(s, &end, 10), hi = lo;
+            if (end == s) break;
+            if (*end == '-') hi = strtol(end + 1, &end, 10);
+            for (long cpu = lo; cpu <= hi && cpu < CPU_SETSIZE; cpu++)
+                if (!masked || CPU_ISSET(cpu, &allowed)) c[n++].cpu = (int)cpu;
+            s = (*end == ',') ? end + 1 : end;
+        }
+    }
+    if (n == 0 && masked)            // no sysfs: every CPU of the mask, one package
+        for (int cpu = 0; cpu < CPU_SETSIZE; cpu++)
+            if (CPU_ISSET(cpu, &allowed)) c[n++].cpu = cpu;
+
+    for (int i = 0; i < n; i++) {
+        char path[128];
+        snprintf(path, sizeof(path), SYS_CPU "/cpu%d/topology/physical_package_id", c[i].cpu);
+        c[i].package = read_int(path, 0);
+        snprintf(path, sizeof(path), SYS_CPU "/cpu%d/topology/core_id", c[i].cpu);
+        c[i].core = read_int(path, c[i].cpu);
+        c[i].sibling = 0;
+        for (int j = 0; j < i; j++)
+            if (c[j].package == c[i].package && c[j].core == c[i].core) c[i].sibling++;
+    }
+    qsort(c, (size_t)n, sizeof(cpu_info), by_placement);
+    return n;
+}
+
+int radix_topo_cpus(void) {
+    cpu_info c[CPU_SETSIZE];
+    int n = load_cpus(c);
+    if (n > 0) return n;
+    long online = sysconf(_SC_NPROCESSORS_ONLN);
+    return online > 0 ? (int)online : 1;
+}
+
+int radix_topo_packages(void) {
+    cpu_info c[CPU_SETSIZE];
+    int n = load_cpus(c), packages = n > 0 ? 1 : 0;
+    for (int i = 1; i < n; i++) packages += c[i].package != c[i - 1].package;   // sorted by package
+    return packages > 0 ? packages : 1;
+}
+
+int radix_topo_assign(radix_pin_kind kind, int threads, int *cpu) {
+    if (kind == RADIX_PIN_NONE || threads < 1) return -1;
+    cpu_info c[CPU_SETSIZE];
+    int n = load_cpus(c);
+    if (n == 0) return -1;
+
+    if (kind == RADIX_PIN_COMPACT) {
+        for (int t = 0; t < threads; t++) cpu[t] = c[t % n].cpu;
+        return 0;
+    }
+
+    // Spread: one contiguous run of tids per package, as even as possible
+    int start[CPU_SETSIZE], size[CPU_SETSIZE], packages = 0;
+    for (int i = 0; i < n; i++) {
+        if (i == 0 || c[i].package != c[i - 1].package) { start[packages] = i; size[packages++] = 0; }
+        size[packages - 1]++;
+    }
+    int t = 0;
+    for (int g = 0; g < packages; g++) {
+        int share = threads / packages + (g < threads % packages);
+        for (int k = 0; k < share; k++) cpu[t++] = c[start[g] + k % size[g]].cpu;
+    }
+    return 0;
+}
+
+int radix_pin_self(int cpu) {
+    if (cpu < 0 || cpu >= CPU_SETSIZE) return -1;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0 ? 0 : -1;
+}
@@ -0,0 +1,31 @@
+// radix_topo.h - CPU topology from /sys/devices/system/cpu and thread pinning
+#ifndef RADIX_TOPO_H
+#define RADIX_TOPO_H
+
+// How participant t of a pool is placed. Participants with neighbouring tids sort
+// neighbouring slices, so both policies keep a run of tids on one package.
+typedef enum {
+    RADIX_PIN_NONE,        // the scheduler decides (default)
+    RADIX_PIN_COMPACT,     // fill package 0 core by core, then package 1, ...
+    RADIX_PIN_SPREAD       // tids split into one contiguous group per package, for memory bandwidth
+} radix_pin_kind;
+
+const char *radix_pin_name(radix_pin_kind kind);
+// "none", "compact" or "spread" -> kind. Returns -1 for anything else.
+int radix_pin_parse(const char *name, radix_pin_kind *kind);
+
+// CPUs this process may run on (online and in its affinity mask); at least 1.
+int radix_topo_cpus(void);
+
+// Distinct physical packages (sockets) among those CPUs; at least 1.
+int radix_topo_packages(void);
+
+// cpu[t] for t < threads under 'kind'. Within a package every core gets one thread
+// before any SMT sibling does; more threads than CPUs wrap around. Returns 0, or -1 for
+// RADIX_PIN_NONE / when the topology cannot be read (cpu is left untouched).
+int radix_topo_assign(radix_pin_kind kind, int threads, int *cpu);
+
+// Pins the calling thread to one CPU. Returns 0, or -1 (the thread keeps its affinity).
+int radix_pin_self(int cpu);
+
+#endif
@@ -0,0 +1,168 @@
+// radix_trace.c - event storage and Chrome trace output for radix_trace.h (only with -DRADIX_TRACE / -DRADIX_PERF)
+#include "radix_trace.h"
+
+#ifdef RADIX_TRACE
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <time.h>
+
+typedef struct {
+    double t0, t1;
+    int    phase;
+    int    pass;
+#ifdef RADIX_PERF
+    radix_perf_sample c;   // counter deltas over the span
+#endif
+} trace_event;
+
+typedef struct {
+    trace_event *ev;
+    size_t n, cap;
+} trace_list;
+
+static trace_list lists[RADIX_TRACE_MAX_THREADS];   // lists[tid] is only touched by thread tid
+static double epoch;
+static pthread_once_t epoch_once = PTHREAD_ONCE_INIT;
+
+static const char *PHASE_NAMES[RADIX_PH_COUNT] = {
+    "max", "histogram", "scan", "scatter", "copy", "barrier", "task"
+};
+
+static double mono(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec + t.tv_nsec / 1e9;
+}
+
+static void epoch_init(void) { epoch = mono(); }
+
+static double now(void) {
+    pthread_once(&epoch_once, epoch_init);
+    return mono() - epoch;
+}
+
+void radix_trace_begin(radix_trace_mark *m) {
+#ifdef RADIX_PERF
+    radix_perf_read(&m->c);          // opens this thread's counters on its first span
+#endif
+    m->t = now();
+}
+
+void radix_trace_end(int tid, radix_trace_phase ph, int pass, const radix_trace_mark *m) {
+    double t1 = now();
+#ifdef RADIX_PERF
+    radix_perf_sample c;
+    radix_perf_read(&c);
+#endif
+    if (tid < 0 || tid >= RADIX_TRACE_MAX_THREADS) return;
+    trace_list *l = &lists[tid];
+    if (l->n == l->cap) {
+        size_t cap = l->cap ? 2 * l->cap : 1024;
+        trace_event *grown = realloc(l->ev, cap * sizeof(trace_event));
+        if (!grown) return;          // out of memory: the event is lost, the sort goes on
+        l->ev  = grown;
+        l->cap = cap;
+    }
+    trace_event *e = &l->ev[l->n++];
+    e->t0    = m->t;
+    e->t1    = t1;
+    e->phase = (int)ph;
+    e->pass  = pass;
+#ifdef RADIX_PERF
+    radix_perf_delta(&e->c, &c, &m->c);
+#endif
+}
+
+void radix_trace_reset(void) {
+    pthread_once(&epoch_once, epoch_init);
+    for (int t = 0; t < RADIX_TRACE_MAX_THREADS; t++) lists[t].n = 0;
+    epoch = mono();
+}
+
+int radix_trace_dump(const char *path) {
+    FILE *f = fopen(path, "w");
+    if (!f) return -1;
+
+    fprintf(f, "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [\n");
+    int first = 1;
+    for (int t = 0; t < RADIX_TRACE_MAX_THREADS; t++) {
+        const trace_list *l = &lists[t];
+        if (l->n == 0) continue;
+        fprintf(f, "%s{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 0, \"tid\": %d, "
+                   "\"args\": {\"name\": \"tid %d%s\"}}", first ? "" : ",\n", t, t, t == 0 ? " (caller)" : "");
+        first = 0;
+        for (size_t i = 0; i < l->n; i++) {
+            const trace_event *e = &l->ev[i];
+            // Chrome expects microseconds
+            fprintf(f, ",\n{\"name\": \"%s\", \"cat\": \"radix\", \"ph\": \"X\", \"pid\": 0, \"tid\": %d, "
+                       "\"ts\": %.3f, \"dur\": %.3f, \"args\": {\"pass\": %d",
+                    PHASE_NAMES[e->phase], t, e->t0 * 1e6, (e->t1 - e->t0) * 1e6, e->pass);
+#ifdef RADIX_PERF
+            for (int c = 0; c < RADIX_PERF_COUNT; c++)
+                if (radix_perf_mask() & (1u << c))
+                    fprintf(f, ", \"%s\": %llu", radix_perf_name((radix_perf_counter)c), (unsigned long long)e->c.v[c]);
+#endif
+            fprintf(f, "}}");
+        }
+    }
+    fprintf(f, "\n]}\n");
+    return fclose(f) == 0 ? 0 : -1;
+}
+
+#ifdef RADIX_PERF
+// One line per (thread, phase) that has spans: counter totals and IPC.
+static void perf_summary(FILE *f) {
+    unsigned mask = radix_perf_mask();
+    if (mask == 0) {
+        fprintf(f, "hardware counters unavailable (perf_event_open refused): timing only\n");
+        return;
+    }
+    fprintf(f, "%-6s %-10s", "tid", "phase");
+    for (int c = 0; c < RADIX_PERF_COUNT; c++) fprintf(f, " %14s", radix_perf_name((radix_perf_counter)c));
+    fprintf(f, " %6s\n", "IPC");
+
+    for (int t = 0; t < RADIX_TRACE_MAX_THREADS; t++) {
+        const trace_list *l = &lists[t];
+        for (int p = 0; p < RADIX_PH_COUNT; p++) {
+            radix_perf_sample sum = { { 0 } };
+            size_t spans = 0;
+            for (size_t i = 0; i < l->n; i++) {
+                if (l->ev[i].phase != p) continue;
+                for (int c = 0; c < RADIX_PERF_COUNT; c++) sum.v[c] += l->ev[i].c.v[c];
+                spans++;
+            }
+            if (spans == 0) continue;
+            fprintf(f, "%-6d %-10s", t, PHASE_NAMES[p]);
+            for (int c = 0; c < RADIX_PERF_COUNT; c++) {
+                if (mask & (1u << c)) fprintf(f, " %14llu", (unsigned long long)sum.v[c]);
+                else                  fprintf(f, " %14s", "n/a");
+            }
+            uint64_t cyc = sum.v[RADIX_PERF_CYCLES], ins = sum.v[RADIX_PERF_INSTRUCTIONS];
+            if (cyc > 0 && (mask & (1u << RADIX_PERF_INSTRUCTIONS))) fprintf(f, " %6.2f\n", (double)ins / cyc);
+            else                                                      fprintf(f, " %6s\n", "n/a");
+        }
+    }
+}
+#endif
+
+void radix_trace_summary(FILE *f) {
+    fprintf(f, "%-6s", "tid");
+    for (int p = 0; p < RADIX_PH_COUNT; p++) fprintf(f, " %12s", PHASE_NAMES[p]);
+    fprintf(f, "   (ms)\n");
+
+    for (int t = 0; t < RADIX_TRACE_MAX_THREADS; t++) {
+        const trace_list *l = &lists[t];
+        if (l->n == 0) continue;
+        double sum[RADIX_PH_COUNT] = { 0 };
+        for (size_t i = 0; i < l->n; i++) sum[l->ev[i].phase] += l->ev[i].t1 - l->ev[i].t0;
+        fprintf(f, "%-6d", t);
+        for (int p = 0; p < RADIX_PH_COUNT; p++) fprintf(f, " %12.3f", sum[p] * 1e3);
+        fprintf(f, "\n");
+    }
+#ifdef RADIX_PERF
+    perf_summary(f);
+#endif
+}
+
+#endif
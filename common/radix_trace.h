@@ -0,0 +1,73 @@
+// radix_trace.h - optional per-thread phase timestamps of the parallel engines (Chrome trace JSON)
+#ifndef RADIX_TRACE_H
+#define RADIX_TRACE_H
+
+#include <stdio.h>
+
+// Build with -DRADIX_TRACE and common/radix_trace.c to record. Without it the
+// macros below are empty and the engines carry no timing code at all.
+// -DRADIX_PERF (plus common/radix_perf.c) implies RADIX_TRACE and also charges the
+// hardware counters of radix_perf.h to every span.
+//
+// Every thread appends to its own event list (indexed by the engine's tid), so
+// recording takes no lock. One traced sort at a time: two sorts running at once
+// would share tid slots.
+
+typedef enum {
+    RADIX_PH_MAX,          // largest-key scan that sizes the digit plan
+    RADIX_PH_HISTOGRAM,    // counting my slice
+    RADIX_PH_SCAN,         // exclusive scan of the (digit, thread) counts
+    RADIX_PH_SCATTER,
+    RADIX_PH_COPY,         // copy-back of my slice
+    RADIX_PH_BARRIER,      // blocked waiting for the other threads
+    RADIX_PH_TASK,         // one MSD bucket task (radix_msd.c)
+    RADIX_PH_COUNT
+} radix_trace_phase;
+
+#define RADIX_TRACE_MAX_THREADS  256   // events of higher tids are dropped
+
+#if defined(RADIX_PERF) && !defined(RADIX_TRACE)
+#define RADIX_TRACE
+#endif
+
+#ifdef RADIX_TRACE
+
+#ifdef RADIX_PERF
+#include "radix_perf.h"
+#endif
+
+// Start of a span on the calling thread.
+typedef struct {
+    double t;                // seconds since the last radix_trace_reset
+#ifdef RADIX_PERF
+    radix_perf_sample c;     // this thread's counters at the same moment
+#endif
+} radix_trace_mark;
+
+void radix_trace_begin(radix_trace_mark *m);
+
+// Records the span from m to now for thread tid. pass is the digit position (-1 if none).
+void radix_trace_end(int tid, radix_trace_phase ph, int pass, const radix_trace_mark *m);
+
+// Drops every recorded event and restarts the clock.
+void radix_trace_reset(void);
+
+// Writes the events as Chrome trace-event JSON (chrome://tracing, ui.perfetto.dev):
+// one "X" event per phase, one track per tid. Returns 0, or -1 with errno set.
+int radix_trace_dump(const char *path);
+
+// Table of the time every thread spent in every phase, summed over all passes. With
+// RADIX_PERF a second table gives the counters, IPC and misses per thread and phase.
+void radix_trace_summary(FILE *f);
+
+#define RADIX_TRACE_START(m)                radix_trace_mark m; radix_trace_begin(&m)
+#define RADIX_TRACE_STOP(tid, ph, pass, m)  radix_trace_end((tid), (ph), (pass), &(m))
+
+#else
+
+#define RADIX_TRACE_START(m)
+#define RADIX_TRACE_STOP(tid, ph, pass, m)  ((void)0)
+
+#endif
+
+#endif
@@ -0,0 +1,108 @@
+// radix_tune.c - load, save and look up the per-host tuning profile
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "radix_tune.h"
+
+const char *radix_tune_backend_name(radix_tune_backend b) {
+    return b == RADIX_TUNE_PTHREADS ? "pthreads" : b == RADIX_TUNE_OMP ? "omp" : "seq";
+}
+
+int radix_tune_backend_parse(const char *name, radix_tune_backend *b) {
+    if (strcmp(name, "seq") == 0)      { *b = RADIX_TUNE_SEQ;      return 0; }
+    if (strcmp(name, "pthreads") == 0) { *b = RADIX_TUNE_PTHREADS; return 0; }
+    if (strcmp(name, "omp") == 0)      { *b = RADIX_TUNE_OMP;      return 0; }
+    return -1;
+}
+
+static int valid_bits(int bits) { return bits == 8 || bits == 11 || bits == 16; }
+
+int radix_tune_load(const char *path, radix_tune_profile *p) {
+    FILE *fp = fopen(path, "r");
+    if (!fp) return -1;
+    memset(p, 0, sizeof(*p));
+    p->threads = RADIX_CTX_DEFAULT_THREADS;
+    p->seq_cutoff = RADIX_CTX_DEFAULT_SEQ_CUTOFF;
+
+    char line[256];
+    int bad = 0;
+    while (!bad && fgets(line, sizeof(line), fp)) {
+        char *hash = strchr(line, '#');
+        if (hash) *hash = '\0';
+        char key[32], name[32];
+        unsigned long long v;
+        int range, bits;
+        double secs = 0;
+        if (sscanf(line, "%31s", key) != 1) continue;           // blank or comment
+        if (strcmp(key, "entry") == 0) {
+            radix_tune_entry *e = &p->entry[p->count];
+            int got = sscanf(line, "%*s %llu %d %31s %d %lf", &v, &range, name, &bits, &secs);
+            if (got < 4 || p->count == RADIX_TUNE_MAX_ENTRIES || v == 0 || range < 0 || range > 64 ||
+                radix_tune_backend_parse(name, &e->backend) != 0 || !valid_bits(bits)) {
+                bad = 1;
+                break;
+            }
+            e->max_n = (size_t)v;
+            e->range_bits = range;
+            e->bits = bits;
+            e->secs = secs;
+            p->count++;
+        } else if (sscanf(line, "%*s %llu", &v) == 1) {
+            if (strcmp(key, "cpus") == 0)            p->cpus = (int)v;
+            else if (strcmp(key, "threads") == 0)    p->threads = v > 0 ? (int)v : 1;
+            else if (strcmp(key, "seq_cutoff") == 0) p->seq_cutoff = (size_t)v;
+            // unknown settings are left for newer versions
+        } else {
+            bad = 1;
+        }
+    }
+    fclose(fp);
+    if (bad) { errno = EINVAL; return -1; }
+    return 0;
+}
+
+int radix_tune_save(const char *path, const radix_tune_profile *p) {
+    FILE *fp = fopen(path, "w");
+    if (!fp) return -1;
+    fprintf(fp, "# radix_tune profile - written by tools/radix_tune, read with radix_tune_load\n");
+    fprintf(fp, "cpus %d\nthreads %d\nseq_cutoff %zu\n", p->cpus, p->threads, p->seq_cutoff);
+    fprintf(fp, "# entry max_n range_bits backend bits seconds\n");
+    for (int i = 0; i < p->count; i++) {
+        const radix_tune_entry *e = &p->entry[i];
+        fprintf(fp, "entry %zu %d %s %d %.9f\n", e->max_n, e->range_bits,
+                radix_tune_backend_name(e->backend), e->bits, e->secs);
+    }
+    if (fclose(fp) != 0) return -1;
+    return 0;
+}
+
+int radix_tune_range_bits(uint64_t min_key, uint64_t max_key) {
+    uint64_t diff = min_key ^ max_key;
+    int bits = 0;
+    while (diff) { bits++; diff >>= 1; }
+    return bits;
+}
+
+const radix_tune_entry *radix_tune_pick(const radix_tune_profile *p, size_t n, int range_bits) {
+    if (p->count == 0) return NULL;
+
+    // Size class: smallest max_n >= n, else the largest one
+    size_t size = 0, largest = 0;
+    for (int i = 0; i < p->count; i++) {
+        size_t m = p->entry[i].max_n;
+        if (m > largest) largest = m;
+        if (m >= n && (size == 0 || m < size)) size = m;
+    }
+    if (size == 0) size = largest;
+
+    // Range class within it: smallest range_bits >= range_bits, else the widest one
+    const radix_tune_entry *best = NULL, *widest = NULL;
+    for (int i = 0; i < p->count; i++) {
+        const radix_tune_entry *e = &p->entry[i];
+        if (e->max_n != size) continue;
+        if (!widest || e->range_bits > widest->range_bits) widest = e;
+        if (e->range_bits >= range_bits && (!best || e->range_bits < best->range_bits)) best = e;
+    }
+    return best ? best : widest;
+}
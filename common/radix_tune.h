@@ -0,0 +1,62 @@
+// radix_tune.h - per-host tuning profile: engine, thread count, digit width and sequential cutoff
+#ifndef RADIX_TUNE_H
+#define RADIX_TUNE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "radix_core.h"
+#include "radix_ctx.h"
+
+// tools/radix_tune measures the engines on this machine and writes a profile; the
+// programs load it and look up what to run for n keys of a given key range.
+typedef enum { RADIX_TUNE_SEQ, RADIX_TUNE_PTHREADS, RADIX_TUNE_OMP } radix_tune_backend;
+
+#define RADIX_TUNE_MAX_ENTRIES  64
+#define RADIX_TUNE_DEFAULT_PATH "radix_tune.profile"
+
+typedef struct {
+    size_t max_n;        // covers n up to max_n (the largest size class also covers larger n)
+    int    range_bits;   // ... whose keys differ only in their lowest range_bits bits
+    radix_tune_backend backend;
+    int    bits;         // digit width (8, 11 or 16)
+    double secs;         // median measured at max_n (informational)
+} radix_tune_entry;
+
+typedef struct {
+    int    cpus;         // usable CPUs when it was calibrated
+    int    threads;      // pool / team size for the parallel backends
+    size_t seq_cutoff;   // n <= seq_cutoff: sequential core (largest size the sequential core won)
+    int    count;
+    radix_tune_entry entry[RADIX_TUNE_MAX_ENTRIES];
+} radix_tune_profile;
+
+const char *radix_tune_backend_name(radix_tune_backend b);
+// "seq", "pthreads" or "omp" -> b. Returns -1 for anything else.
+int radix_tune_backend_parse(const char *name, radix_tune_backend *b);
+
+// Text file, one "key value" setting or "entry max_n range_bits backend bits secs" per line,
+// '#' comments. Both return 0, or -1 with errno set (EINVAL for a malformed profile).
+int radix_tune_load(const char *path, radix_tune_profile *p);
+int radix_tune_save(const char *path, const radix_tune_profile *p);
+
+// Bits that vary between the smallest and the largest key (0 when all keys are equal).
+// Digit positions above them are skipped anyway, so this is what decides the pass count.
+int radix_tune_range_bits(uint64_t min_key, uint64_t max_key);
+
+// The entry for the smallest size class >= n, and in it the smallest range class >= range_bits
+// (the largest ones when n or range_bits exceed every class). NULL for an empty profile.
+const radix_tune_entry *radix_tune_pick(const radix_tune_profile *p, size_t n, int range_bits);
+
+/* ---------- Dispatch (radix_tune_sort.c) ---------- */
+// Fills *cfg for the pool radix_tune_sort runs on: p->threads threads, p->seq_cutoff.
+void radix_tune_ctx_config(const radix_tune_profile *p, radix_ctx_config *cfg);
+
+// Sorts a[0, n) with what the profile picks for n and the key range [min_key, max_key]
+// (radix_key32/64 of the smallest and largest value; 0 and radix_key_max(type) when unknown).
+// Pool backends run on ctx; OpenMP entries need radix_tune_sort.c built with -fopenmp
+// (and radix_omp.c), otherwise they run on the pool too. *used (may be NULL) gets the
+// entry, or NULL when the profile is empty and the pool sorted with 11-bit digits.
+int radix_tune_sort(const radix_tune_profile *p, radix_ctx *ctx, void *a, size_t n, radix_key_type type,
+                    uint64_t min_key, uint64_t max_key, const radix_tune_entry **used);
+
+#endif
@@ -0,0 +1,32 @@
+// radix_tune_sort.c - run the engine a tuning profile picks (pool, sequential core or OpenMP)
+#ifdef _OPENMP
+#include <omp.h>
+#include "radix_omp.h"
+#endif
+#include "radix_tune.h"
+
+void radix_tune_ctx_config(const radix_tune_profile *p, radix_ctx_config *cfg) {
+    radix_ctx_config_init(cfg);
+    cfg->threads = p->threads > 0 ? p->threads : RADIX_CTX_DEFAULT_THREADS;
+    cfg->seq_cutoff = p->seq_cutoff;
+}
+
+int radix_tune_sort(const radix_tune_profile *p, radix_ctx *ctx, void *a, size_t n, radix_key_type type,
+                    uint64_t min_key, uint64_t max_key, const radix_tune_entry **used) {
+    const radix_tune_entry *e = radix_tune_pick(p, n, radix_tune_range_bits(min_key, max_key));
+    if (used) *used = e;
+    int bits = e ? e->bits : 11;
+    radix_tune_backend backend = e ? e->backend : RADIX_TUNE_PTHREADS;
+
+    if (backend == RADIX_TUNE_SEQ || n <= p->seq_cutoff) return radix_sort(a, n, type, bits);
+#ifdef _OPENMP
+    if (backend == RADIX_TUNE_OMP) {
+        int prev = omp_get_max_threads();
+        omp_set_num_threads(p->threads);
+        int rc = radix_omp_sort(a, n, type, bits);
+        omp_set_num_threads(prev);
+        return rc;
+    }
+#endif
+    return radix_ctx_sort_bounded(ctx, a, n, type, bits, max_key);
+}
@@ -4,22 +4,63 @@
 #include <stdlib.h>
 #include <limits.h>
 #include <time.h>
+#include <unistd.h>
 #include <omp.h>                    //Include OpenMP header.
-#define MAX_NUMS 2000000            //Maximum number of integers the program can store in the dynamic array.
+#include "../../common/radix_core.h"        //Shared digit plans and counting-sort kernels.
+#include "../../common/radix_omp.h"         //OpenMP in-place MSD (-m inplace) and counting sort (-m auto).
+#include "../../common/radix_io.h"          //Shared loader: parallel text parser, mapped binary datasets.
+#include "../../common/radix_report.h"      //Shared CSV / JSON result rows.
+#include "../../common/radix_trace.h"       //Per-thread phase spans, only recorded in a -DRADIX_TRACE build.
+#include "../../common/radix_topo.h"        //CPU list and packages from /sys/devices/system/cpu, thread pinning.
+#include "../../common/radix_tune.h"        //Per-host profile written by tools/radix_tune (-u).
 
 
 
-// -------- Load sequential time based on filename --------
-double get_sequential_time(const char *fname) {
-    if (strcmp(fname, "input_small.txt") == 0)   return 0.008;
-    if (strcmp(fname, "input_medium.txt") == 0)  return 0.011;
-    if (strcmp(fname, "input_large.txt") == 0)   return 0.014;
-    if (strcmp(fname, "input_mixed_10000.txt") == 0)    return 0.001;
-    if (strcmp(fname, "input_mixed_100000.txt") == 0)   return 0.020;
-    if (strcmp(fname, "input_mixed_1000000.txt") == 0)  return 0.109;
+// -------- Sequential baseline --------
+double time_sequential_sort(const int *arr, int n, int digit_bits, int inplace, const uint64_t *count_keys) {   //Times the sequential core on a copy of the same data, on this machine.
+    int *copy = malloc((n > 0 ? n : 1) * sizeof(int));                 //The parallel sort still needs the unsorted array afterwards.
+    if (!copy) {
+        fprintf(stderr, "Memory allocation failed in time_sequential_sort\n");
+        exit(1);
+    }
+    memcpy(copy, arr, n * sizeof(int));
+    double start = omp_get_wtime();
+    if (count_keys)
+        radix_count_sort(copy, n, RADIX_I32, count_keys[0], count_keys[1]);   //-m auto, counting path: the same counting sort on one thread.
+    else if (inplace)
+        radix_sort_inplace(copy, n, RADIX_I32, digit_bits);             //-m inplace -s: the same in-place sort on one thread.
+    else
+        radix_sort(copy, n, RADIX_I32, digit_bits);                     //Same digit width (and -S scatter) as the parallel run.
+    double t = omp_get_wtime() - start;
+    free(copy);
+    return t;
+}
+
+
+// ---------- Thread placement ----------
+void pin_threads(radix_pin_kind kind) {                          //Pins OpenMP thread t to the CPU radix_topo_assign picks for it.
+    int P = omp_get_max_threads();
+    int *cpu = malloc(P * sizeof(int));                          //cpu[t] = CPU of thread t.
+    if (!cpu || radix_topo_assign(kind, P, cpu) != 0) {
+        printf("Pinning: CPU topology not readable, threads left unpinned\n");
+        free(cpu);
+        return;
+    }
+    #pragma omp parallel num_threads(P)                          //The runtime keeps these threads for every later region of P threads, so pinning once is enough.
+    radix_pin_self(cpu[omp_get_thread_num()]);
+    printf("Pinning: %s over %d CPU(s) in %d package(s), CPU per thread:", radix_pin_name(kind), radix_topo_cpus(), radix_topo_packages());
+    for (int t = 0; t < P; t++)
+        printf(" %d", cpu[t]);
+    printf("\n");
+    free(cpu);
+}
+
 
-    // default fallback
-    return 0.0;
+// ---------- First touch ----------
+void first_touch(int *dst, const int *src, int n) {             //Copies src into dst (zeros when src is NULL) with the same static split as the counting loop,
+    #pragma omp parallel for schedule(static)                    //so every page is first written, and allocated, by the thread that reads it later.
+    for (int i = 0; i < n; i++)
+        dst[i] = src ? src[i] : 0;
 }
 
 
@@ -34,98 +75,168 @@ void print_array(const char *label, int *arr, int n) {         //This Function i
     printf("]\n");
 }
 
+// ---------- Function to print an array of radix keys ----------
+void print_keys(const char *label, int *arr, int n) {          //Between passes every number has its sign bit flipped; flip it back to print the value.
+    printf("%s[", label);
+    for (int i = 0; i < n; i++) {
+        if (i > 0)
+            printf(", ");
+        printf("%d", (int)((uint32_t)arr[i] ^ 0x80000000u));   //Undoing the sign-bit flip of the I32 key.
+    }
+    printf("]\n");
+}
 
 
-// ---------- Counting sort ----------
-void counting_sort(int *arr, int n, int exp) {                //Sort array elements based on the digit represented by exp (1, 10, 100...).
-    int *output = malloc(n * sizeof(int));                 //Creating a temporary array to store the sorted result for this digit.
-    if (!output) {
-        fprintf(stderr, "Memory allocation failed in counting_sort\n");
-        exit(1);
+
+// ---------- PARALLEL COUNTING OF EVERY DIGIT USING REDUCTION ----------
+void count_all_digits(const int *arr, int n, const radix_plan *plan, size_t *count) {   //count[pass * buckets + d] = how many numbers have digit d at position pass.
+    int rows = plan->passes * (int)plan->buckets;          //One row of counts per digit position.
+    memset(count, 0, rows * sizeof(size_t));
+    #pragma omp parallel reduction(+:count[:rows])            //One read of the array counts all positions; the private counts are merged at the end of the region.
+    {
+        RADIX_TRACE_START(t_hist);
+        int t = omp_get_thread_num(), P = omp_get_num_threads();
+        size_t base = (size_t)n / P, rem = (size_t)n % P;       //Same split as schedule(static), so every thread reads the part it placed in first_touch.
+        size_t lo = t * base + ((size_t)t < rem ? (size_t)t : rem);
+        size_t hi = lo + base + ((size_t)t < rem ? 1 : 0);
+        radix_histogram_all32((const uint32_t *)arr, lo, hi, plan, RADIX_PASS_FIRST, count);   //Core kernel: AVX2 digits and 4 sub-histograms where the CPU has them,
+        RADIX_TRACE_STOP(t, RADIX_PH_HISTOGRAM, -1, t_hist);                                   //so a digit repeated in a row (narrow data) does not wait on its own counter.
     }
+}
 
-    int count[10] = {0};                                      //Array to count occurrences of each digit (0–9) initialized to zero.
 
-    // ---------- PARALLEL COUNTING USING REDUCTION ----------
-    #pragma omp parallel for reduction(+:count[:10])
-    for (int i = 0; i < n; i++) {
-        int digit = (arr[i] / exp) % 10;
-        count[digit]++;
-    }
+// ---------- Counting sort ----------
+void counting_sort(const int *arr, int *output, int n, const radix_plan *plan, int pass, size_t *count, void *wc) {   //Sort arr[] into output[] by one digit of the plan (a decimal place or a bit field).
+    int nb = (int)plan->buckets;                           //10 buckets for decimal digits, 2^bits otherwise.
+    int flags = radix_pass_flags(plan, pass);              //First pass turns numbers into keys (sign bit flipped), last pass turns them back.
 
+    //1)count[] already holds this digit's counts (count_all_digits did every pass in one read).
+
+    if (wc) {                                                 //-S wc: starting positions, then a left-to-right placement through one cache line per digit.
+        RADIX_TRACE_START(t_wc);                              //Full lines go to output[] at once instead of one item into each of up to 65536 places.
+        radix_pass_counted32((const uint32_t *)arr, (uint32_t *)output, n, plan, pass, flags, count, wc);
+        RADIX_TRACE_STOP(0, RADIX_PH_SCATTER, pass, t_wc);
+        return;
+    }
 
      //2)Converting counts into 1-based ending positions for each digit.
-    for (int i = 1; i < 10; i++) {                            //Looping through the count array starting from index 1 to 9.
-            int prev = count[i - 1];                          //Storing the cumulative count of all digits less than the current digit i.
-            int curr = count[i];                             //Storing the current count of the digit i.
+    RADIX_TRACE_START(t_scan);                                //Steps 2 and 3 run on the master thread only.
+    for (int i = 1; i < nb; i++) {                            //Looping through the count array starting from index 1.
+            size_t prev = count[i - 1];                       //Storing the cumulative count of all digits less than the current digit i.
+            size_t curr = count[i];                          //Storing the current count of the digit i.
             count[i] = curr + prev;                          //Updating count[i] to be the total number of elements with a digit value <= i.
         }
+    RADIX_TRACE_STOP(0, RADIX_PH_SCAN, pass, t_scan);
 
     //3)Placing items into output[] from right to left using those positions.
+    RADIX_TRACE_START(t_scatter);
     for (int i = n - 1; i >= 0; i--) {                        //Traversing the array backward to maintain sorting stability.
-        int d = (arr[i] / exp) % 10;                          //Extracting the current digit again.
-        int pos = count[d] - 1;                               //Converting last 1-based position to 0-based index.
-        output[pos] = arr[i];                                  //Placing the element into that exact position in the output array for this digit.
+        uint32_t key = radix_in32(plan, (uint32_t)arr[i], flags);  //Key of the element (sign bit flipped on the first pass).
+        int d = (int)radix_digit32(plan, key, pass);          //Extracting the current digit again.
+        size_t pos = count[d] - 1;                            //Converting last 1-based position to 0-based index.
+        output[pos] = (int)radix_out32(plan, key, flags);      //Placing the element (as a number again on the last pass) into its position for this digit.
         count[d]--;                                            //Decreasing the count so the next same digit element goes to the left.
     }
+    RADIX_TRACE_STOP(0, RADIX_PH_SCATTER, pass, t_scatter);
 
-
-    //4)Copying the partially sorted result back to the main array arr[].
-    #pragma omp parallel for                                  //Splitting the loop among threads for faster copying.
-    for (int i = 0; i < n; i++)                               //Copying the sorted elements from output[] back to arr[].
-        arr[i] = output[i];                                   //Updating the original array with partially sorted result.
-
-
-    free(output);
-
+    //No copy back: the next pass reads output[] and writes into arr[] (the two arrays take turns).
 }
 
 
 // ---------- Main ----------
 int main(int argc, char *argv[]) {
-  // --- Check that exactly one argument (input file name) is provided ---
-    if (argc != 2) {                                           //If user didn’t pass exactly one extra argument notify them the correct format.
-        printf("Usage: %s <input.txt>\n", argv[0]);
-        return 1;                                              //Exiting with error.
+  // --- Parse options: -b selects the digit width (0 = decimal, 8, 11 or 16 bits) ---
+    int digit_bits = RADIX_DECIMAL;                            //Decimal digits by default, same as before.
+    radix_bin_mode bin_mode = RADIX_BIN_PRIVATE;              //Binary inputs are sorted in a private mapping unless -w is given.
+    radix_report_format log_format = RADIX_REPORT_CSV;        //Results are appended as CSV rows unless -f json is given.
+    const char *log_path = "OpenMP_results.csv";              //-o picks another results file.
+    const char *trace_path = NULL;                            //-T: Chrome trace of the parallel sort (-DRADIX_TRACE builds).
+    radix_scatter_kind scatter = RADIX_SCATTER_DIRECT;         //-S wc: write-combining scatter instead of writing every item directly.
+    radix_pin_kind pin = RADIX_PIN_NONE;                       //-P compact|spread: pin every thread to one CPU.
+    const char *tune_path = NULL;                              //-u: tuning profile (threads, sequential cutoff, digits and engine per size).
+    int bits_given = 0, threads_given = 0;                     //-b and -t win over the profile.
+    int use_auto = 0;                                          //-m auto: a narrow value range is sorted by direct counting instead of digit passes.
+    int use_inplace = 0;                                       //-m inplace: American flag MSD inside the array, no second array of n numbers.
+    int inplace_baseline = 0;                                  //-s: with -m inplace, time the sequential baseline too (on a copy of n numbers).
+    int opt;
+    while ((opt = getopt(argc, argv, "b:wf:o:T:S:t:P:u:m:s")) != -1) {
+        if (opt == 'b') {
+            digit_bits = atoi(optarg);
+            bits_given = 1;
+        } else if (opt == 'w') {
+            bin_mode = RADIX_BIN_INPLACE;                      //-w: a binary input file is sorted in place (written back).
+        } else if (opt == 'f' && radix_report_parse_format(optarg, &log_format) == 0) {
+            //-f csv|json: format of the rows in the results file.
+        } else if (opt == 'o') {
+            log_path = optarg;
+        } else if (opt == 'T') {
+            trace_path = optarg;
+        } else if (opt == 'S' && radix_scatter_parse(optarg, &scatter) == 0) {
+            radix_set_scatter(scatter);                        //"direct" or "wc", the sequential baseline uses it too.
+        } else if (opt == 't' && atoi(optarg) >= 0) {
+            omp_set_num_threads(atoi(optarg) > 0 ? atoi(optarg) : radix_topo_cpus());   //-t 0: one thread per usable CPU.
+            threads_given = 1;
+        } else if (opt == 'P' && radix_pin_parse(optarg, &pin) == 0) {
+            //"none", "compact" or "spread"
+        } else if (opt == 'u') {
+            tune_path = optarg;
+        } else if (opt == 'm' && (strcmp(optarg, "lsd") == 0 || strcmp(optarg, "auto") == 0 || strcmp(optarg, "inplace") == 0)) {
+            use_auto = strcmp(optarg, "auto") == 0;
+            use_inplace = strcmp(optarg, "inplace") == 0;
+        } else if (opt == 's') {
+            inplace_baseline = 1;
+        } else {
+            printf("Usage: %s [-b 0|8|11|16] [-w] [-f csv|json] [-o results] [-T trace.json] [-S direct|wc] [-t threads] [-P none|compact|spread] [-u profile] [-m lsd|auto|inplace] [-s] <input.txt|input.bin>\n", argv[0]);
+            return 1;
+        }
     }
 
-    // --- Open the input file ---
-    FILE *f = fopen(argv[1], "r");                             //Trying to open the file given as the first argument in read mode.
-    if (!f) {                                                  //If fopen failed print the system error message.
-        perror("fopen");
+  // --- Check that exactly one argument (input file name) is provided ---
+    if (argc - optind != 1) {                                  //If user didn’t pass exactly one extra argument notify them the correct format.
+        printf("Usage: %s [-b 0|8|11|16] [-w] [-f csv|json] [-o results] [-T trace.json] [-S direct|wc] [-t threads] [-P none|compact|spread] [-u profile] [-m lsd|auto|inplace] [-s] <input.txt|input.bin>\n", argv[0]);
         return 1;                                              //Exiting with error.
     }
+    const char *input_name = argv[optind];                     //Dataset path (also written to the results file).
+
+    // --- Tuning profile ---
+    radix_tune_profile tune;
+    if (tune_path) {
+        if (radix_tune_load(tune_path, &tune) != 0) {          //Written by tools/radix_tune on this machine.
+            perror(tune_path);
+            return 1;
+        }
+        if (!threads_given)
+            omp_set_num_threads(tune.threads);                 //Team size that was fastest when calibrated.
+    }
 
     // --- Reading the array from file ---
-    int *arr = malloc(MAX_NUMS * sizeof(int));              //Declaring a dynamic array to hold all integers read from the file.
-    if (!arr) {
-        fprintf(stderr, "Memory allocation failed (arr)\n");
-        fclose(f);
-        return 1;
-    }
-    int n = 0;                                          //Initializing a counter that keeps track of how many integers have been successfully read.
-    int x;                                              //Declaring a temporary variable used to store each integer read from the file.
-     int min = INT_MAX;                                 //Initializing a variable to track the smallest value seen so far, initialized to the largest int.
-    int max_read = INT_MIN;   // Track max while reading
-
-    while (fscanf(f, "%d", &x) == 1 && n < MAX_NUMS) {    //Keep reading integers from the file while read is successful and array is not full.
-        arr[n] = x;                                      //Storing the new integer at the current index n.
-        n++;                                             //Moving n to the next position for the next read.
-        if (x < min)
-            min = x;                            //If this value is smaller than the current minimum, update min.
-        if (x > max_read)
-            max_read = x;
+    radix_dataset ds;                                          //Text files are parsed in parallel chunks, binary files are mapped and sorted where they lie.
+    if (radix_dataset_open(&ds, input_name, bin_mode, omp_get_max_threads()) != 0) {   //Count, min and max come back with the data, no extra pass needed.
+        perror("radix_dataset_open");                          //If the file could not be opened or read print the system error message.
+        return 1;                                              //Exiting with error.
     }
+    int *arr = ds.data;                                        //The numbers to sort (no copy for binary files).
+    int n = (int)ds.stats.n;                                   //Number of integers in the file.
+    int min = ds.stats.min;                                    //Smallest value.
+    int max_read = ds.stats.max;                               //Largest value.
 
     if (n == 0) {                                        //If no integers were read (n stayed 0)...
         fprintf(stderr, "Error: no integers found.\n");   //Print an error message to the standard error stream.
-        fclose(f);                                       //Close the file before exiting.
-        free(arr);
+        radix_dataset_close(&ds);
         return 1;                                        //Exit the program with an error status.
     }
-    fclose(f);
 
     printf("Number of threads: %d\n", omp_get_max_threads());
+    if (pin != RADIX_PIN_NONE)
+        pin_threads(pin);                                      //Before first_touch, so the pages go where the threads now run.
+
+    // --- Placing the data: every thread writes its own part of a fresh copy ---
+    int *loaded = arr;                                         //The loaded (or mapped) numbers; -w writes the result back there.
+    int *placed = use_inplace ? NULL : malloc(n * sizeof(int));   //-m inplace sorts the loaded numbers where they are.
+    if (placed) {
+        first_touch(placed, loaded, n);
+        arr = placed;
+    }
 
     // --- Print unsorted array or summary ---
      // ---- Make a copy of unsorted array for logging ----
@@ -143,44 +254,130 @@ int main(int argc, char *argv[]) {
         printf("\n");
     }
 
-    // --- Shift negatives (Sequential)---
-        int shift = 0;                                              //Initializing a variable that stores how much we need to add to each number.
-        if (min < 0)                                                //Checking if the smallest number in the array is negative.
-            shift = -min;                                           //If yes, make shift equal to its positive value (so negatives become zero or more).
+    // --- Negatives need no shift ---
+    // The core flips the sign bit of every number inside the first radix pass and flips it back
+    // inside the last one, so negatives sort before positives without an extra pass over the array.
+    uint32_t max_key = radix_key32(RADIX_I32, (uint32_t)max_read);   //Key of the largest value = largest key (the flip keeps the order).
+
+    // --- Digits and engine from the profile (-u) ---
+    int tuned_seq = 0;                                         //1: the sequential core sorts instead of the team.
+    if (tune_path) {
+        uint32_t min_key = radix_key32(RADIX_I32, (uint32_t)min);
+        const radix_tune_entry *e = radix_tune_pick(&tune, (size_t)n, radix_tune_range_bits(min_key, max_key));
+        if (e && !bits_given)
+            digit_bits = e->bits;                              //Fastest digit width for this many numbers over this key range.
+        tuned_seq = (size_t)n <= tune.seq_cutoff || (e && e->backend == RADIX_TUNE_SEQ);
+    }
 
-        if (shift > 0) {                                            //If shifting is needed (there were negative numbers).
-            for (int i = 0; i < n; i++)                             //Looping through every element in the array.
-                arr[i] = arr[i] + shift;                            //Adding 'shift' to each element to make all numbers non negative
-        }
 
+    // --- Build the digit plan ---
+    radix_plan plan;
+    if (radix_plan_init(&plan, RADIX_I32, digit_bits, max_key) != 0) {   //Rejecting digit widths the core does not support.
+        fprintf(stderr, "Error: digit bits must be 0 (decimal), 8, 11 or 16.\n");
+        radix_dataset_close(&ds);
+        return 1;
+    }
+
+    // --- Path (-m auto) ---
+    int counting = 0;                                          //1: direct counting sort instead of the digit passes.
+    if (use_auto) {
+        double share = 0;
+        radix_path path = radix_choose_path(arr, n, RADIX_I32, digit_bits, radix_key32(RADIX_I32, (uint32_t)min), max_key, &share);
+        counting = path == RADIX_PATH_COUNTING;               //Fewer distinct values than numbers (and few enough to count them all).
+        printf("Path: %s (%lld values from %d to %d, top digit share in a sample %.2f)%s\n", radix_path_name(path),
+               (long long)max_read - min + 1, min, max_read, share,
+               path == RADIX_PATH_MSD ? ", no MSD engine in this program: LSD passes" : "");
+        if (counting)
+            tuned_seq = 0;                                     //The profile was calibrated for digit passes only.
+    }
 
-    // --- Find maximum (Sequential) ---
-    int max = arr[0];                                           //Assuming the first element is the largest number.
-    for (int i = 1; i < n; i++)                                 //Looping through the rest of the array from index 1 to 19.
-        if (arr[i] > max)                                       //If the current number is larger than the current 'max'.
-            max = arr[i];                                       //Updating 'max' to store this new larger number.
+    // --- Sequential baseline on the same data (before the array is sorted) ---
+    int seq_run = !use_inplace || inplace_baseline;           //-m inplace keeps only the input in memory: its baseline needs -s.
+    uint64_t count_keys[2] = { radix_key32(RADIX_I32, (uint32_t)min), max_key };   //Key range of the counting path.
+    double T_seq = seq_run ? time_sequential_sort(arr, n, digit_bits, use_inplace, counting ? count_keys : NULL) : 0;
+
+    // --- Buffers for the passes, allocated once ---
+    int *output = use_inplace ? NULL : malloc(n * sizeof(int));   //Second array: every pass reads one array and writes the other.
+    size_t *count = malloc(((size_t)plan.passes * plan.buckets + 1) * sizeof(size_t));   //Occurrences of each digit, one row per pass.
+    void *wc = scatter == RADIX_SCATTER_WC ? radix_wc_alloc(plan.buckets, 1) : NULL;   //One cache line per digit for -S wc.
+    if ((!use_inplace && !output) || !count || (scatter == RADIX_SCATTER_WC && !wc)) {
+        fprintf(stderr, "Memory allocation failed\n");
+        exit(1);
+    }
+    if (output)
+        first_touch(output, NULL, n);                          //output[] is placed the same way as arr[].
 
     // --- Start timing ---
+#ifdef RADIX_TRACE
+    radix_trace_reset();                                       //Only the parallel sort below is traced.
+#endif
     double start = omp_get_wtime();
 
-    // --- Radix sort (with partial outputs) ---
-    for (int exp = 1; max / exp > 0; exp *= 10) {               //Looping over each digit place: 1 (ones), 10 (tens), 100 (hundreds),etc.
-        counting_sort(arr, n, exp);                             //Sorting the array based on the current digit using counting sort.
+    int skipped = 0;
+    if (counting) {                                            //-m auto on a narrow range: one count per value, one write pass.
+        if (radix_omp_sort_counting(arr, n, RADIX_I32, count_keys[0], count_keys[1]) != 0) {
+            fprintf(stderr, "Memory allocation failed\n");
+            exit(1);
+        }
+    } else if (use_inplace) {                                  //-m inplace: no output[], the numbers are swapped into their buckets.
+        int rc = tuned_seq ? radix_sort_inplace(arr, n, RADIX_I32, digit_bits) : radix_omp_sort_inplace(arr, n, RADIX_I32, digit_bits);
+        if (rc != 0) {
+            fprintf(stderr, "Memory allocation failed\n");
+            exit(1);
+        }
+    } else if (tuned_seq) {                                           //-u: for this n and key range one thread beat the team when calibrated,
+        radix_sort(arr, n, RADIX_I32, digit_bits);             //so the sequential core sorts (small inputs no longer pay for starting the team).
+    } else {
+        // --- Counting every digit in one read ---
+        count_all_digits(arr, n, &plan, count);
+        skipped = radix_plan_skip_trivial(&plan, count, n);     //A digit that is the same in every number would not move anything: its pass is skipped.
+
+        // --- Radix sort (with partial outputs) ---
+        int *src = arr, *dst = output;                             //src holds the data before the pass, dst after it.
+        for (int pass = 0; pass < plan.passes; pass++) {            //Looping over each digit: ones, tens, hundreds... or each bit field.
+            int skip = radix_pass_skipped(&plan, pass);
+            if (!skip) {
+                counting_sort(src, dst, n, &plan, pass, count + (size_t)pass * plan.buckets, wc);   //Sorting the array based on the current digit using counting sort.
+                int *t = src; src = dst; dst = t;                   //Swapping: the result of this pass is the input of the next one.
+            }
+
+        if (n <= 100) {
+            if (plan.bits == RADIX_DECIMAL)
+                printf("\n After pass for exp = %llu:\n", (unsigned long long)plan.pow10[pass]);   //Printing which digit place we just sorted.
+            else
+                printf("\n After pass for bits %d-%d:\n", pass * plan.bits,   //The last field stops at the key's top bit.
+                           (pass + 1) * plan.bits < plan.width ? (pass + 1) * plan.bits - 1 : plan.width - 1);
+            if (skip)                                           printf(" (skipped: every number has the same digit here)\n");
+            else if (radix_pass_flags(&plan, pass) & RADIX_PASS_LAST) print_array("", src, n); //Printing the array after this pass.
+            else                                                print_keys("", src, n);  //Between passes the array holds keys.
+        }
+        }
 
-    if (n <= 100) {
-        printf("\n After pass for exp = %d:\n", exp);         //Printing which digit place we just sorted.
-        print_array("", arr, n);                              //Printing the array after this pass.
-    }
+        //Odd number of passes: the result ended in output[], copy it back once.
+        if (src != arr) {
+            #pragma omp parallel
+            {
+                RADIX_TRACE_START(t_copy);
+                #pragma omp for schedule(static) nowait           //Splitting the loop among threads for faster copying.
+                for (int i = 0; i < n; i++)
+                    arr[i] = src[i];
+                RADIX_TRACE_STOP(omp_get_thread_num(), RADIX_PH_COPY, -1, t_copy);
+            }
+        }
     }
 
     // --- End timing ---
     double end = omp_get_wtime();
     double time_taken = end - start;                            //Calculating how long the sorting took in seconds.
 
-    // --- Shift back (restore negatives) ---
-    if (shift != 0)                                             //If shift is not zero, meaning we actually shifted earlier
-        for (int i = 0; i < n; i++)                             //Looping through every element in the array.
-            arr[i] -= shift;                                    //Subtracting the same shift value to return numbers to their original range.
+#ifdef RADIX_TRACE
+    radix_trace_summary(stdout);                                //Time every thread spent in every phase (summed over passes).
+    if (trace_path && radix_trace_dump(trace_path) != 0)        //Open the file in chrome://tracing or ui.perfetto.dev.
+        perror(trace_path);
+#else
+    if (trace_path)
+        fprintf(stderr, "-T ignored: rebuild with -DRADIX_TRACE and common/radix_trace.c\n");
+#endif
 
     // --- Final output ---
      if (n <= 100) {
@@ -188,79 +385,69 @@ int main(int argc, char *argv[]) {
     }
 
     // === Performance Profiling ===
-    // Manually enter the sequential time from your sequential program
-    double T_seq = get_sequential_time(argv[1]);
+    // T_seq was measured above with the sequential core, so both times come from the same machine and data
     double T_par = time_taken;
 
     // Compute speedup: S = T_seq / T_par
     double speedup = (T_seq > 0) ? (T_seq / T_par) : 0;
 
     // Compute efficiency: E = S / P
-    int P = omp_get_max_threads();
+    int P = tuned_seq ? 1 : omp_get_max_threads();
     double efficiency = (P > 0) ? (speedup / P) : 0;
 
-    //Estimating parallel fraction alpha.
-    double alpha = (P > 1) ? ((speedup - 1.0) / (P - 1.0)) : 0.0;
-
-    //Amdahl predicted speedup using estimated alpha
-    double amdahl_speedup = 1.0 / ((1.0 - alpha) + (alpha / P));
-
 
+    if (counting)
+        printf("\nDirect counting sort over %lld values (no digit passes)\n", (long long)max_read - min + 1);
+    else if (use_inplace)
+        printf("\nIn-place MSD (American flag sort), %s\n", tuned_seq ? "sequential core (profile)" : "whole team");
+    else if (tuned_seq)
+        printf("\nTuned: sequential core with %d-bit digits (profile %s)\n", digit_bits, tune_path);
+    else
+        printf("\nDigit passes: %d run, %d skipped (same digit in every number)\n", plan.passes - skipped, skipped);
+    printf("Scatter: %s\n", radix_scatter_name(scatter));
     printf("\n===== Performance Profiling =====\n");
-    printf("\nSequential Time (T_seq): %.6f s\n", T_seq);
-    printf("Parallel Time   (T_par): %.6f s\n", T_par);
-    printf("Speedup         (S = T_seq / T_par): %.4f\n", speedup);
-    printf("Efficiency      (E = S / P): %.4f\n", efficiency);
-    printf("Amdahl Predicted Speedup: %.4f\n", amdahl_speedup);
+    if (seq_run) {
+        printf("\nSequential Time (T_seq): %.6f s\n", T_seq);
+        printf("Parallel Time   (T_par): %.6f s\n", T_par);
+        printf("Speedup         (S = T_seq / T_par): %.4f\n", speedup);
+        printf("Efficiency      (E = S / P): %.4f\n", efficiency);
+    } else {
+        printf("\nSequential Time (T_seq): not measured (-s times it on a copy)\n");
+        printf("Parallel Time   (T_par): %.6f s\n", T_par);
+    }
     printf("\n=================================\n\n");
 
-    // === Save output to file ===
-    FILE *out = fopen("OpenMP_output_log3.txt", "a");
+    // === Save results ===
+    // One row per engine (single run each; tools/radix_bench repeats runs and reports median/p95).
+    FILE *out = radix_report_open(log_path, log_format);
     if (!out) {
-        perror("fopen");
+        perror(log_path);
     } else {
-
-        fprintf(out, "=============================================\n");
-        fprintf(out, "Run for input file: %s\n", argv[1]);
-        fprintf(out, "=============================================\n\n");
-
-        // ---- Case 1: Small arrays: print full unsorted & sorted ----
-        if (n <= 100) {
-            fprintf(out, "Unsorted Array:\n");
-            for (int i = 0; i < n; i++) {
-                fprintf(out, "%d ", unsorted_copy[i]);   // use copy here
-            }
-            fprintf(out, "\n\n");
-
-            fprintf(out, "Sorted Array:\n");
-            for (int i = 0; i < n; i++) {
-                fprintf(out, "%d ", arr[i]);             // sorted result
-            }
-            fprintf(out, "\n\n");
-        }
-        // ---- Case 2: Large arrays: print only summary ----
-        else {
-            fprintf(out, "Unsorted array is too large to print.\n");
-            fprintf(out, "  Number of elements: %d\n", n);
-            fprintf(out, "  Minimum value:      %d\n", min);
-            fprintf(out, "  Maximum value:      %d\n\n", max_read);
-        }
-
-        // ---- Performance Profiling ----
-        fprintf(out, "===== Performance Profiling =====\n");
-        fprintf(out, "Sequential Time (T_seq): %.6f s\n", T_seq);
-        fprintf(out, "Parallel Time   (T_par): %.6f s\n", T_par);
-        fprintf(out, "Speedup         (S): %.4f\n", speedup);
-        fprintf(out, "Efficiency      (E): %.4f\n", efficiency);
-        fprintf(out,"Amdahl Predicted Speedup: %.4f\n", amdahl_speedup);
-        fprintf(out, "=============================================\n\n");
-
+        int wc_run = scatter == RADIX_SCATTER_WC;             //Rows of -S wc runs are told apart by the backend name.
+        radix_report_row row = { "openmp", counting ? "seq-counting" : use_inplace ? "seq-inplace" : wc_run ? "seq-wc" : "seq", input_name, (size_t)n,
+                                 sizeof(int), 1, plan.bits, 1, { T_seq, T_seq, T_seq, T_seq }, 1.0, 0, { 0 }, 0 };
+        if (seq_run)
+            radix_report_write(out, log_format, &row);         //Sequential baseline.
+        row.backend = counting ? "omp-counting" : use_inplace ? "omp-inplace" : wc_run ? "omp-wc" : "omp";
+        row.threads = P;
+        row.t       = (radix_time_stats){ T_par, T_par, T_par, T_par };
+        row.speedup = speedup;
+        radix_report_write(out, log_format, &row);             //This run.
         fclose(out);
+        printf("Results appended to %s\n", log_path);
     }
 
+    if (arr != loaded) {
+        if (ds.mapped && bin_mode == RADIX_BIN_INPLACE)        //-w: the file gets the sorted numbers.
+            memcpy(loaded, arr, n * sizeof(int));
+        free(arr);
+    }
     if (unsorted_copy)
         free(unsorted_copy);
+    free(output);
+    free(count);
+    free(wc);
 
-    free(arr);
+    radix_dataset_close(&ds);
     return 0;
 }
@@ -2,9 +2,12 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <limits.h>
 #include <time.h>
-#define MAX_NUMS 2000000            //Maximum number of integers the program can store in the static array.
+#include <unistd.h>
+#include "../../common/radix_core.h"        //Shared digit plans and counting-sort kernels.
+#include "../../common/radix_io.h"          //Shared loader: parallel text parser, mapped binary datasets.
 
 // ---------- Function to print an array ----------
 void print_array(const char *label, int *arr, int n) {         //This Function is used to print a label followed by all array elements.
@@ -17,86 +20,74 @@ void print_array(const char *label, int *arr, int n) {         //This Function i
     printf("]\n");
 }
 
-
-// ---------- Counting sort  ----------
-void counting_sort(int *arr, int n, int exp) {                //Sort array elements based on the digit represented by exp (1, 10, 100...).
-    int *output = malloc(n * sizeof(int));                      //Creating a temporary array to store the sorted result for this digit.
-    int count[10] = {0};                                      //Array to count occurrences of each digit (09) initialized to zero.
-
-    //1)Counting how many times each digit appears at this place.
-    for (int i = 0; i < n; i++) {                             //Looping through all elements in arr from index 0 to 19.
-        int digit = (arr[i] / exp) % 10;                      //Extracting the current digit.
-        count[digit]++;                                       //Increasing its count.
-    }
-
-     //2)Converting counts into 1-based ending positions for each digit.
-    for (int i = 1; i < 10; i++) {                            //Looping through the count array starting from index 1 to 9.
-            int prev = count[i - 1];                          //Storing the cumulative count of all digits less than the current digit i.
-            int curr = count[i];                             //Storing the current count of the digit i.
-            count[i] = curr + prev;                          //Updating count[i] to be the total number of elements with a digit value <= i.
-        }
-
-    //3)Placing items into output[] from right to left using those positions.
-    for (int i = n - 1; i >= 0; i--) {                        //Traversing the array backward to maintain sorting stability.
-        int d = (arr[i] / exp) % 10;                          //Extracting the current digit again.
-        int pos = count[d] - 1;                               //Converting last 1-based position to 0-based index.
-        output[pos] = arr[i];                                  //Placing the element into that exact position in the output array for this digit.
-        count[d]--;                                            //Decreasing the count so the next same digit element goes to the left.
+// ---------- Function to print an array of radix keys ----------
+void print_keys(const char *label, int *arr, int n) {          //Between passes every number has its sign bit flipped; flip it back to print the value.
+    printf("%s[", label);
+    for (int i = 0; i < n; i++) {
+        if (i > 0)
+            printf(", ");
+        printf("%d", (int)((uint32_t)arr[i] ^ 0x80000000u));   //Undoing the sign-bit flip of the I32 key.
     }
-
-    //4)Copying the partially sorted result back to the main array arr[].
-    for (int i = 0; i < n; i++)                               //Copying the sorted elements from output[] back to arr[].
-        arr[i] = output[i];                                   //Updating the original array with partially sorted result.
-
-    free(output);
+    printf("]\n");
+}
 
 
+// ---------- Counting sort  ----------
+void counting_sort(const int *arr, int *output, int n, const radix_plan *plan, int pass, size_t *count, void *wc) {   //Sort arr[] into output[] by one digit of the plan (a decimal place or a bit field).
+    //1) Counting each digit was done for every pass at once before the first one: count[] holds this digit's counts.
+    //2)-3) Turning counts into starting positions and placing items stably into output[].
+    //The first pass also turns each number into its key, the last pass turns keys back into numbers.
+    //With -S wc (wc != NULL) items are first collected in one cache line per digit and written a full line at a time.
+    radix_pass_counted32((const uint32_t *)arr, (uint32_t *)output, n, plan, pass, radix_pass_flags(plan, pass), count, wc);
+    //No copy back: the next pass reads output[] and writes into arr[] (the two arrays take turns).
 }
 
 
 // ---------- Main ----------
 int main(int argc, char *argv[]) {
-    // --- Check that exactly one argument (input file name) is provided ---
-    if (argc != 2) {                                           //If user didnt pass exactly one extra argument notify them the correct format.
-        printf("Usage: %s <input.txt>\n", argv[0]);
-        return 1;                                              //Exiting with error.
+    // --- Parse options: -b selects the digit width (0 = decimal, 8, 11 or 16 bits) ---
+    int digit_bits = RADIX_DECIMAL;                            //Decimal digits by default, same as before.
+    radix_bin_mode bin_mode = RADIX_BIN_PRIVATE;              //Binary inputs are sorted in a private mapping unless -w is given.
+    radix_scatter_kind scatter = RADIX_SCATTER_DIRECT;         //-S wc: write-combining scatter instead of writing every item directly.
+    int use_inplace = 0;                                       //-m inplace: sort inside the array, without output[].
+    int opt;
+    while ((opt = getopt(argc, argv, "b:wS:m:")) != -1) {
+        if (opt == 'b') {
+            digit_bits = atoi(optarg);
+        } else if (opt == 'w') {
+            bin_mode = RADIX_BIN_INPLACE;                      //-w: a binary input file is sorted in place (written back).
+        } else if (opt == 'S' && radix_scatter_parse(optarg, &scatter) == 0) {
+            //"direct" or "wc"
+        } else if (opt == 'm' && (strcmp(optarg, "lsd") == 0 || strcmp(optarg, "inplace") == 0)) {
+            use_inplace = strcmp(optarg, "inplace") == 0;
+        } else {
+            printf("Usage: %s [-b 0|8|11|16] [-w] [-S direct|wc] [-m lsd|inplace] <input.txt|input.bin>\n", argv[0]);
+            return 1;
+        }
     }
 
-    // --- Open the input file ---
-    FILE *f = fopen(argv[1], "r");                             //Trying to open the file given as the first argument in read mode.
-    if (!f) {                                                  //If fopen failed print the system error message.
-        perror("fopen");
+    // --- Check that exactly one argument (input file name) is provided ---
+    if (argc - optind != 1) {                                  //If user didnt pass exactly one extra argument notify them the correct format.
+        printf("Usage: %s [-b 0|8|11|16] [-w] [-S direct|wc] [-m lsd|inplace] <input.txt|input.bin>\n", argv[0]);
         return 1;                                              //Exiting with error.
     }
 
 // --- Reading the array from file ---
-    int *arr = malloc(MAX_NUMS * sizeof(int));            //Declaring a static array to hold all integers read from the file.
-    if (!arr) {
-        fprintf(stderr, "Memory allocation failed\n");
-        fclose(f);
-        return 1;
-}
-    int n = 0;                                          //Initializing a counter that keeps track of how many integers have been successfully read.
-    int x;                                              //Declaring a temporary variable used to store each integer read from the file.
-    int min = INT_MAX;                              //Initializing a variable to track the smallest value seen so far, initialized to the largest int.
-    int max_read = INT_MIN;      // NEW: track max while reading
-
-
-    while (fscanf(f, "%d", &x) == 1 && n < MAX_NUMS) {    //Keep reading integers from the file while read is successful and array is not full.
-        arr[n] = x;                                      //Storing the new integer at the current index n.
-        n++;                                             //Moving n to the next position for the next read.
-        if (x < min)
-            min = x;                                    //If this value is smaller than the current minimum, update min.
-        if (x > max_read)
-            max_read = x;   // NEW: update max_read
-        }
+    radix_dataset ds;                                          //Text files are parsed in parallel chunks, binary files are mapped and sorted where they lie.
+    if (radix_dataset_open(&ds, argv[optind], bin_mode, 0) != 0) {   //Count, min and max come back with the data, no extra pass needed.
+        perror("radix_dataset_open");                          //If the file could not be opened or read print the system error message.
+        return 1;                                              //Exiting with error.
+    }
+    int *arr = ds.data;                                        //The numbers to sort (no copy for binary files).
+    int n = (int)ds.stats.n;                                   //Number of integers in the file.
+    int min = ds.stats.min;                                    //Smallest value.
+    int max_read = ds.stats.max;                               //Largest value.
 
     if (n == 0) {                                        //If no integers were read (n stayed 0)...
         fprintf(stderr, "Error: no integers found.\n");   //Print an error message to the standard error stream.
-        fclose(f);                                       //Close the file before exiting.
+        radix_dataset_close(&ds);
         return 1;                                        //Exit the program with an error status.
     }
-    fclose(f);   //Closing the file after reading data.
 
 
 
@@ -112,51 +103,84 @@ int main(int argc, char *argv[]) {
     }
 
 
-    // --- Shift negatives ---
-    int shift = 0;                                              //Initializing a variable that stores how much we need to add to each number.
-    if (min < 0)                                                //Checking if the smallest number in the array is negative.
-        shift = -min;                                           //If yes, make shift equal to its positive value (so negatives become zero or more).
-
-    if (shift > 0) {                                            //If shifting is needed (there were negative numbers).
-        for (int i = 0; i < n; i++)                             //Looping through every element in the array.
-            arr[i] = arr[i] + shift;                            //Adding 'shift' to each element to make all numbers non negative
-    }
+    // --- Negatives need no shift ---
+    // The core flips the sign bit of every number inside the first radix pass and flips it back
+    // inside the last one, so negatives sort before positives without an extra pass over the array.
+    uint32_t max_key = radix_key32(RADIX_I32, (uint32_t)max_read);   //Key of the largest value = largest key (the flip keeps the order).
 
 
-    // --- Find maximum ---
-    int max = arr[0];                                           //Assuming the first element is the largest number.
-    for (int i = 1; i < n; i++)                                 //Looping through the rest of the array from index 1 to 19.
-        if (arr[i] > max)                                       //If the current number is larger than the current 'max'.
-            max = arr[i];                                       //Updating 'max' to store this new larger number.
+    // --- Build the digit plan ---
+    radix_plan plan;
+    if (radix_plan_init(&plan, RADIX_I32, digit_bits, max_key) != 0) {   //Rejecting digit widths the core does not support.
+        fprintf(stderr, "Error: digit bits must be 0 (decimal), 8, 11 or 16.\n");
+        radix_dataset_close(&ds);
+        return 1;
+    }
 
+    // --- Buffers for the passes, allocated once ---
+    int *output = use_inplace ? NULL : malloc(n * sizeof(int));   //Second array: every pass reads one array and writes the other.
+    size_t *count = calloc((size_t)plan.passes * plan.buckets + 1, sizeof(size_t));   //Occurrences of each digit, one row per pass.
+    void *wc = scatter == RADIX_SCATTER_WC ? radix_wc_alloc(plan.buckets, 1) : NULL;   //One cache line per digit for -S wc.
+    if ((!use_inplace && !output) || !count || (scatter == RADIX_SCATTER_WC && !wc)) {
+        fprintf(stderr, "Memory allocation failed\n");
+        radix_dataset_close(&ds);
+        return 1;
+    }
 
     // --- Start timing ---
     clock_t start = clock();
 
-    // --- Radix sort (with partial outputs) ---
-    for (int exp = 1; max / exp > 0; exp *= 10) {               //Looping over each digit place: 1 (ones), 10 (tens), 100 (hundreds),etc.
-        counting_sort(arr, n, exp);                             //Sorting the array based on the current digit using counting sort.
-
-        if (n <= 100) {
-            printf("\n After pass for exp = %d:\n", exp);     //Printing which digit place we just sorted.
-            print_array("", arr, n);                          //Printing the array after this pass.
+    int skipped = 0;
+    if (use_inplace) {                                         //-m inplace: American flag MSD, numbers are swapped into their buckets.
+        if (radix_sort_inplace(arr, n, RADIX_I32, digit_bits) != 0) {
+            fprintf(stderr, "Memory allocation failed\n");
+            radix_dataset_close(&ds);
+            return 1;
         }
+    } else {
+        // --- Counting every digit in one read ---
+        radix_histogram_all32((const uint32_t *)arr, 0, n, &plan, RADIX_PASS_FIRST, count);   //Row 'pass' of count[] = occurrences of each digit at that position.
+        skipped = radix_plan_skip_trivial(&plan, count, n);     //A digit that is the same in every number would not move anything: its pass is skipped.
+
+        // --- Radix sort (with partial outputs) ---
+        int *src = arr, *dst = output;                             //src holds the data before the pass, dst after it.
+        for (int pass = 0; pass < plan.passes; pass++) {            //Looping over each digit: ones, tens, hundreds... or each bit field.
+            int skip = radix_pass_skipped(&plan, pass);
+            if (!skip) {
+                counting_sort(src, dst, n, &plan, pass, count + (size_t)pass * plan.buckets, wc);   //Sorting the array based on the current digit using counting sort.
+                int *t = src; src = dst; dst = t;                   //Swapping: the result of this pass is the input of the next one.
+            }
+
+            if (n <= 100) {
+                if (plan.bits == RADIX_DECIMAL)
+                    printf("\n After pass for exp = %llu:\n", (unsigned long long)plan.pow10[pass]);   //Printing which digit place we just sorted.
+                else
+                    printf("\n After pass for bits %d-%d:\n", pass * plan.bits,   //The last field stops at the key's top bit.
+                           (pass + 1) * plan.bits < plan.width ? (pass + 1) * plan.bits - 1 : plan.width - 1);
+                if (skip)                                           printf(" (skipped: every number has the same digit here)\n");
+                else if (radix_pass_flags(&plan, pass) & RADIX_PASS_LAST) print_array("", src, n); //Printing the array after this pass.
+                else                                                print_keys("", src, n);  //Between passes the array holds keys.
+            }
 
+        }
+        if (src != arr)                                            //Odd number of passes: the result ended in output[].
+            memcpy(arr, src, n * sizeof(int));                     //The only copy of the whole sort.
     }
 
     // --- End timing ---
     clock_t end = clock();
     double s = (double)(end - start) / CLOCKS_PER_SEC;         //Calculating how long the sorting took in seconds.
 
-    // --- Shift back (restore negatives) ---
-    if (shift != 0)                                             //If shift is not zero, meaning we actually shifted earlier
-        for (int i = 0; i < n; i++)                             //Looping through every element in the array.
-            arr[i] -= shift;                                    //Subtracting the same shift value to return numbers to their original range.
-
     // --- Print sorted array and Time Taken ---
     if (n <= 100) print_array("\nSorted:", arr, n);
-    printf("\nSorting Time: %.6f s\n", s);
+    if (use_inplace) printf("\nIn-place MSD (American flag sort), no second array\n");
+    else             printf("\nDigit passes: %d run, %d skipped\n", plan.passes - skipped, skipped);
+    printf("Scatter: %s\n", radix_scatter_name(scatter));
+    printf("Sorting Time: %.6f s\n", s);
 
-    free(arr);
+    free(output);
+    free(count);
+    free(wc);
+    radix_dataset_close(&ds);
     return 0;
 }
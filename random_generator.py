@@ -6,6 +6,9 @@
 import random
 import time
 import os
+import sys
+import struct
+from array import array
 
 
 # FIXED RANGE GENERATOR
@@ -46,7 +49,30 @@ def save_to_file(filename, arr):
     print(f"Saved {len(arr)} integers to {filepath}")
 
 
+# BINARY SAVE FUNCTION (format in common/radix_bin.h)
+def save_to_binary(filename, arr):
+    script_dir = os.path.dirname(os.path.abspath(__file__))
+    filepath = os.path.join(script_dir, filename)
+
+    # 64-byte header: magic, version 1, type RADIX_I32 (1), count,
+    # flags (1 = min/max present), reserved, min and max as raw 32-bit values
+    lo = min(arr) & 0xFFFFFFFF if arr else 0
+    hi = max(arr) & 0xFFFFFFFF if arr else 0
+    header = struct.pack("<8sIIQIIQQ", b"RADIXBIN", 1, 1, len(arr), 1 if arr else 0, 0, lo, hi)
+    values = array("i", arr)
+    if sys.byteorder != "little":
+        values.byteswap()
+
+    with open(filepath, "wb") as f:
+        f.write(header.ljust(64, b"\0"))
+        f.write(values.tobytes())
+
+    print(f"Saved {len(arr)} integers to {filepath}")
+
+
 def main():
+    # --binary: also write input_mixed_<n>.bin next to every mixed .txt file
+    binary = "--binary" in sys.argv[1:]
     random.seed(time.time())
     print("=== DATA GENERATION STARTED ===\n")
 
@@ -70,6 +96,8 @@ def main():
         filename = f"input_mixed_{n}.txt"
         arr = generate_mixed_integers(n)
         save_to_file(filename, arr)
+        if binary:
+            save_to_binary(f"input_mixed_{n}.bin", arr)
 
     print("\nAll datasets generated successfully!")
 
@@ -0,0 +1,133 @@
+// radix_native.c - Python extension: the shared C radix core for sarah_multiprocessing_radix.py
+// Build (from the repo root):
+//   gcc -O2 -shared -fPIC $(python3-config --includes) sarah/radix_native.c common/radix_core.c
+//       common/radix_ctx.c common/radix_barrier.c common/radix_topo.c common/radix_msd.c common/radix_count.c
+//       -o sarah/radix_native$(python3-config --extension-suffix) -lpthread
+//
+// radix_native.sort(buf, threads=0, bits=11) sorts any writable 1-D buffer of 4 or 8-byte
+// integers or floats (array.array, memoryview, bytearray views, NumPy arrays) in place:
+// no copy and no conversion to Python ints. The GIL is released while the pool sorts, and
+// the buffer stays exported meanwhile, so Python code cannot resize it under the sort.
+// Returns the path that ran: "counting", "lsd" or "msd" (radix_ctx_sort_auto).
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+#include "../common/radix_core.h"
+#include "../common/radix_ctx.h"
+#include "../common/radix_topo.h"
+
+#define NATIVE_POOLS 4   // pools kept for this many thread counts; others get one for the call
+
+// Pools are only created and looked up with the GIL held, and only destroyed when the module
+// is freed, so a sort running without the GIL never sees its pool go away.
+static struct { int threads; radix_ctx *ctx; } pools[NATIVE_POOLS];
+
+static radix_ctx *make_pool(int threads) {
+    radix_ctx_config cfg;
+    radix_ctx_config_init(&cfg);
+    cfg.threads = threads;
+    return radix_ctx_create(&cfg);
+}
+
+// Pool for 'threads', cached when a slot is free; *temp = 1 when the caller must destroy it
+static radix_ctx *get_pool(int threads, int *temp) {
+    *temp = 0;
+    for (int i = 0; i < NATIVE_POOLS; i++) {
+        if (pools[i].ctx && pools[i].threads == threads) return pools[i].ctx;
+        if (!pools[i].ctx) {
+            pools[i].ctx = make_pool(threads);
+            pools[i].threads = threads;
+            return pools[i].ctx;
+        }
+    }
+    *temp = 1;
+    return make_pool(threads);
+}
+
+// Buffer format -> key type. Native or little-endian byte order only; the width comes from
+// itemsize, so 'l' and 'q' work whatever their size on this platform.
+static int buffer_type(const Py_buffer *v, radix_key_type *type) {
+    const char *f = v->format ? v->format : "B";
+    if (*f == '@' || *f == '=' || *f == '<') f++;
+    if (f[0] == '\0' || f[1] != '\0') return -1;
+    int wide = v->itemsize == 8;
+    if (v->itemsize != 4 && !wide) return -1;
+    switch (*f) {
+    case 'i': case 'l': case 'q': case 'n': *type = wide ? RADIX_I64 : RADIX_I32; return 0;
+    case 'I': case 'L': case 'Q': case 'N': *type = wide ? RADIX_U64 : RADIX_U32; return 0;
+    case 'f': if (wide) return -1; *type = RADIX_F32; return 0;
+    case 'd': if (!wide) return -1; *type = RADIX_F64; return 0;
+    default:  return -1;
+    }
+}
+
+static PyObject *native_sort(PyObject *self, PyObject *args, PyObject *kwargs) {
+    (void)self;
+    static char *kwlist[] = { "buf", "threads", "bits", NULL };
+    PyObject *obj;
+    int threads = 0, bits = 11;
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O|ii", kwlist, &obj, &threads, &bits)) return NULL;
+    if (threads < 0) { PyErr_SetString(PyExc_ValueError, "threads must be >= 0 (0 = every usable CPU)"); return NULL; }
+    if (bits != RADIX_DECIMAL && bits != 8 && bits != 11 && bits != 16) {
+        PyErr_SetString(PyExc_ValueError, "bits must be 0 (decimal), 8, 11 or 16");
+        return NULL;
+    }
+    if (threads == 0) threads = radix_topo_cpus();
+
+    Py_buffer view;
+    if (PyObject_GetBuffer(obj, &view, PyBUF_WRITABLE | PyBUF_FORMAT | PyBUF_C_CONTIGUOUS) != 0) return NULL;
+    radix_key_type type;
+    if (view.ndim != 1 || buffer_type(&view, &type) != 0) {
+        PyErr_Format(PyExc_TypeError, "expected a 1-D buffer of 4 or 8-byte integers or floats, got format '%s' (%zd-byte items, %d dimension(s))",
+                     view.format ? view.format : "B", view.itemsize, view.ndim);
+        PyBuffer_Release(&view);
+        return NULL;
+    }
+
+    int temp;
+    radix_ctx *ctx = get_pool(threads, &temp);
+    if (!ctx) {
+        PyBuffer_Release(&view);
+        return PyErr_NoMemory();
+    }
+    radix_path path = RADIX_PATH_LSD;
+    int rc;
+    Py_BEGIN_ALLOW_THREADS
+    rc = radix_ctx_sort_auto(ctx, view.buf, (size_t)view.shape[0], type, bits, NULL, &path);
+    if (temp) radix_ctx_destroy(ctx);
+    Py_END_ALLOW_THREADS
+    PyBuffer_Release(&view);
+    if (rc != 0) return PyErr_NoMemory();
+    return PyUnicode_FromString(radix_path_name(path));
+}
+
+static PyObject *native_cpus(PyObject *self, PyObject *unused) {
+    (void)self; (void)unused;
+    return PyLong_FromLong(radix_topo_cpus());
+}
+
+static void native_free(void *module) {
+    (void)module;
+    for (int i = 0; i < NATIVE_POOLS; i++) {
+        if (pools[i].ctx) radix_ctx_destroy(pools[i].ctx);
+        pools[i].ctx = NULL;
+    }
+}
+
+static PyMethodDef native_methods[] = {
+    { "sort", (PyCFunction)(void (*)(void))native_sort, METH_VARARGS | METH_KEYWORDS,
+      "sort(buf, threads=0, bits=11) -> path\n\n"
+      "Sorts a writable 1-D buffer of 4/8-byte integers or floats in place with the C radix core.\n"
+      "threads=0 uses every usable CPU, threads=1 sorts in the calling thread. bits: 0 (decimal),\n"
+      "8, 11 or 16. Returns the path that ran: 'counting', 'lsd' or 'msd'." },
+    { "cpus", native_cpus, METH_NOARGS, "cpus() -> usable CPUs (what threads=0 uses)" },
+    { NULL, NULL, 0, NULL }
+};
+
+static struct PyModuleDef native_module = {
+    PyModuleDef_HEAD_INIT, "radix_native", "Shared C radix core over the buffer protocol.", -1,
+    native_methods, NULL, NULL, NULL, native_free
+};
+
+PyMODINIT_FUNC PyInit_radix_native(void) {
+    return PyModule_Create(&native_module);
+}
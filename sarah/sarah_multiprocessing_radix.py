@@ -1,8 +1,18 @@
 import os
+import struct
+import sys
 import time
+from array import array
 from multiprocessing import Pool, cpu_count
 import heapq
 
+# C extension over the shared radix core (sarah/radix_native.c, build line in its header).
+# Optional: without it everything below runs in pure Python as before.
+try:
+    import radix_native
+except ImportError:
+    radix_native = None
+
 # -------------------------------------------------
 # Read integers from a .txt file (parent of sarah/)
 # -------------------------------------------------
@@ -21,13 +31,28 @@ def read_input(filename):
     # Full path to the file
     filepath = os.path.join(parent_dir, filename)
 
-    with open(filepath, "r") as f:
-        content = f.read().strip()
-
-    if not content:
-        return []
-
-    return [int(x) for x in content.split()]
+    # Read raw bytes and let int() parse each token in C:
+    # no text decoding and no per-number Python loop
+    with open(filepath, "rb") as f:
+        content = f.read()
+
+    # Binary dataset (common/radix_bin.h): 64-byte header, then 'count' little-endian values.
+    # Only int32 datasets (type RADIX_I32 = 1) hold what this script sorts.
+    if content[:8] == b"RADIXBIN":
+        if len(content) < 64:
+            raise ValueError(f"{filename}: truncated binary header")
+        _, version, kind, count = struct.unpack_from("<8sIIQ", content)
+        if version != 1 or kind != 1:
+            raise ValueError(f"{filename}: binary dataset version {version}, type {kind}; only int32 (type 1) is supported")
+        if len(content) < 64 + 4 * count:
+            raise ValueError(f"{filename}: {count} values announced, file too short")
+        values = array("i")
+        values.frombytes(content[64:64 + 4 * count])
+        if sys.byteorder != "little":
+            values.byteswap()
+        return values.tolist()
+
+    return list(map(int, content.split()))
 
 
 # ---------- RADIX SORT FUNCTIONS ----------
@@ -127,6 +152,78 @@ def parallel_radix_sort(arr, num_processes=None):
     return merged
 
 
+# ---------- C EXTENSION VERSION ----------
+
+def native_array(data):
+    """
+    Pack the numbers into an array the C core can sort in place:
+    32-bit ints when they fit (all datasets do), 64-bit otherwise.
+    """
+    try:
+        return array("i", data)
+    except OverflowError:
+        return array("q", data)
+
+
+def native_radix_sort(values, threads):
+    """
+    Sort a copy of 'values' (an array) with the C radix core.
+    The copy is a flat memcpy; the sort runs on its buffer directly,
+    with the GIL released, on 'threads' threads (1 = sequential core).
+    Returns the sorted array.
+    """
+    result = values[:]
+    radix_native.sort(result, threads=threads)
+    return result
+
+
+# ---------- BENCHMARK MODE ----------
+
+def bench(args):
+    """
+    Used by tools/radix_bench:
+      --bench FILE [--reps N] [--warmup W] [--processes P] [--seq] [--native]
+    Prints "time <seconds>" for every timed run, warmup runs are not printed.
+    Loading the file is not timed. --native sorts with the C extension
+    (P threads, or 1 with --seq) instead of the pure-Python sorts; only the
+    sort is timed, not the copy of the input it sorts.
+    """
+    opts = {"--reps": 10, "--warmup": 2, "--processes": cpu_count()}
+    filename = args[args.index("--bench") + 1]
+    for key in opts:
+        if key in args:
+            opts[key] = int(args[args.index(key) + 1])
+    sequential = "--seq" in args
+    native = "--native" in args
+    if native and radix_native is None:
+        print("--native: radix_native is not built (see sarah/radix_native.c)", file=sys.stderr)
+        sys.exit(1)
+
+    data = read_input(filename)
+    expected = sorted(data)
+    if native:
+        values = native_array(data)
+        expected = array(values.typecode, expected)
+        threads = 1 if sequential else opts["--processes"]
+    for run in range(-opts["--warmup"], opts["--reps"]):
+        if native:
+            result = values[:]
+            start = time.perf_counter()
+            radix_native.sort(result, threads=threads)
+        else:
+            start = time.perf_counter()
+            if sequential:
+                result = radix_sort(data)
+            else:
+                result = parallel_radix_sort(data, num_processes=opts["--processes"])
+        elapsed = time.perf_counter() - start
+        if result != expected:
+            print("WARNING: result is not sorted", file=sys.stderr)
+            sys.exit(1)
+        if run >= 0:
+            print(f"time {elapsed:.9f}", flush=True)
+
+
 # ---------- MAIN ----------
 
 def main():
@@ -142,6 +239,13 @@ def main():
 
     max_processes = cpu_count()
 
+    # C extension when it is built, unless --python asks for the pure-Python sorts
+    native = radix_native is not None and "--python" not in sys.argv[1:]
+    if native:
+        print("Engine: C radix core (radix_native), sorting array buffers in place")
+    else:
+        print("Engine: pure Python (build sarah/radix_native.c for the C core)")
+
     for filename in input_files:
         data = read_input(filename)
 
@@ -155,20 +259,33 @@ def main():
         # number of processes actually used for this dataset
         used_processes = max(1, min(max_processes, len(data)))
 
+        if native:
+            values = native_array(data)
+
         # ------- Sequential radix sort -------
         start = time.perf_counter()
-        seq_sorted = radix_sort(data)
+        if native:
+            seq_sorted = native_radix_sort(values, 1)
+        else:
+            seq_sorted = radix_sort(data)
         end = time.perf_counter()
         seq_time = end - start
         print(f"Sequential radix sort time:      {seq_time:.6f} seconds")
 
         # ------- Parallel radix sort -------
         start = time.perf_counter()
-        mp_sorted = parallel_radix_sort(data, num_processes=used_processes)
+        if native:
+            mp_sorted = native_radix_sort(values, used_processes)
+        else:
+            mp_sorted = parallel_radix_sort(data, num_processes=used_processes)
         end = time.perf_counter()
         mp_time = end - start
-        print(f"Multiprocessing radix sort time: {mp_time:.6f} seconds")
-        print(f"Processes used: {used_processes}")
+        if native:
+            print(f"Threaded radix sort time:        {mp_time:.6f} seconds")
+            print(f"Threads used: {used_processes}")
+        else:
+            print(f"Multiprocessing radix sort time: {mp_time:.6f} seconds")
+            print(f"Processes used: {used_processes}")
 
         # ------- Correctness check -------
         if seq_sorted == mp_sorted:
@@ -187,4 +304,7 @@ def main():
 
 
 if __name__ == "__main__":
-    main()
+    if "--bench" in sys.argv[1:]:
+        bench(sys.argv[1:])
+    else:
+        main()
@@ -0,0 +1,461 @@
+// radix_bench.c - one benchmark driver for every backend, on the same machine and the same data
+// Build: gcc -O2 -fopenmp tools/radix_bench.c common/radix_report.c common/radix_core.c common/radix_ctx.c
+//            common/radix_barrier.c common/radix_topo.c common/radix_msd.c common/radix_count.c common/radix_inplace.c
+//            common/radix_omp.c common/radix_io.c common/radix_bin.c common/radix_tune.c common/radix_tune_sort.c
+//            common/radix_check.c -o radix_bench -lpthread
+//        (without -fopenmp and common/radix_omp.c the omp backend is left out;
+//         with -DRADIX_PERF common/radix_perf.c common/radix_trace.c the rows get hardware counters)
+//        (the -wc backends run the same sorts with the write-combining scatter, radix_set_scatter)
+//        (-V scalar|avx2|avx512 picks the histogram / min-max kernels of every C backend, radix_set_simd)
+//        (the tuned backend, with -u, sorts with what a tools/radix_tune profile picks for the
+//         dataset's size and key range, on a pool of the profile's thread count)
+//        (the python-native backends need the sarah/radix_native.c extension built next to the script)
+//        (the -inplace backends sort without an n-element buffer; every row has the peak RSS of its runs)
+// Usage: ./radix_bench [-k seq,pthreads,omp] [-r 10] [-W 2] [-t 4] [-b 11] [-f csv|json] [-o results.csv]
+//                      [-P none|compact|spread] [-u radix_tune.profile] [-V scalar|avx2|avx512]
+//                      [-p sarah/sarah_multiprocessing_radix.py] dataset ...
+#include <limits.h>
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#ifdef _OPENMP
+#include <omp.h>
+#include "../common/radix_omp.h"
+#endif
+#include "../common/radix_check.h"
+#include "../common/radix_core.h"
+#include "../common/radix_ctx.h"
+#include "../common/radix_io.h"
+#include "../common/radix_report.h"
+#include "../common/radix_trace.h"
+#include "../common/radix_topo.h"
+#include "../common/radix_tune.h"
+
+#define MAX_BACKENDS 20
+
+typedef struct {
+    int reps, warmup, threads, bits;
+    const char *script;          // Python backend
+    radix_ctx *ctx;              // pthreads backends
+    const radix_tune_profile *tune;   // tuned backend (-u), NULL without a profile
+    radix_ctx *tune_ctx;              // its pool: the profile's threads and cutoff
+    uint64_t min_key, max_key;        // keys of the current dataset's smallest and largest value
+} bench_opts;
+
+/* ---------- C backends ---------- */
+// scratch holds n elements for the backends that take one, so none allocates its n-sized
+// buffer inside the timed region (the pthreads context keeps its own between sorts); it is
+// NULL for the others, which keeps it out of their peak RSS
+typedef int (*sort_fn)(const bench_opts *o, int32_t *a, int32_t *scratch, size_t n);
+
+static int sort_seq(const bench_opts *o, int32_t *a, int32_t *scratch, size_t n) {
+    return radix_sort_scratch(a, scratch, n, RADIX_I32, o->bits);
+}
+static int sort_pthreads(const bench_opts *o, int32_t *a, int32_t *scratch, size_t n) {
+    (void)scratch;
+    return radix_ctx_sort(o->ctx, a, n, RADIX_I32, o->bits);
+}
+static int sort_pthreads_msd(const bench_opts *o, int32_t *a, int32_t *scratch, size_t n) {
+    (void)scratch;
+    return radix_ctx_sort_msd(o->ctx, a, n, RADIX_I32, o->bits);
+}
+static int sort_seq_inplace(const bench_opts *o, int32_t *a, int32_t *scratch, size_t n) {
+    (void)scratch;
+    return radix_sort_inplace(a, n, RADIX_I32, o->bits);
+}
+static int sort_pthreads_inplace(const bench_opts *o, int32_t *a, int32_t *scratch, size_t n) {
+    (void)scratch;
+    return radix_ctx_sort_inplace(o->ctx, a, n, RADIX_I32, o->bits);
+}
+// Counting, LSD or MSD by key range and a sample (radix_choose_path), bounds from the loader
+static int sort_auto(const bench_opts *o, int32_t *a, int32_t *scratch, size_t n) {
+    (void)scratch;
+    uint64_t minmax[2] = { o->min_key, o->max_key };
+    return radix_ctx_sort_auto(o->ctx, a, n, RADIX_I32, o->bits, minmax, NULL);
+}
+static int sort_tuned(const bench_opts *o, int32_t *a, int32_t *scratch, size_t n) {
+    (void)scratch;
+    return radix_tune_sort(o->tune, o->tune_ctx, a, n, RADIX_I32, o->min_key, o->max_key, NULL);
+}
+#ifdef _OPENMP
+static int sort_omp(const bench_opts *o, int32_t *a, int32_t *scratch, size_t n) {
+    return radix_omp_sort_scratch(a, scratch, n, RADIX_I32, o->bits);
+}
+// The OpenMP engine has no MSD: counting where the range allows it, LSD otherwise
+static int sort_omp_auto(const bench_opts *o, int32_t *a, int32_t *scratch, size_t n) {
+    if (radix_choose_path(a, n, RADIX_I32, o->bits, o->min_key, o->max_key, NULL) == RADIX_PATH_COUNTING)
+        return radix_omp_sort_counting(a, n, RADIX_I32, o->min_key, o->max_key);
+    return radix_omp_sort_scratch(a, scratch, n, RADIX_I32, o->bits);
+}
+static int sort_omp_inplace(const bench_opts *o, int32_t *a, int32_t *scratch, size_t n) {
+    (void)scratch;
+    return radix_omp_sort_inplace(a, n, RADIX_I32, o->bits);
+}
+#endif
+
+// Every repetition sorts a fresh copy of src; only the sort itself is timed.
+// t gets o->reps times. In a RADIX_PERF build the counters of every thread that ran
+// part of the timed sorts are summed into row (per sort); the copy is not counted.
+// Returns 0, or -1 if a sort fails or its last result is not src sorted: ref is the
+// radix_check_sum of src, and the result must match it in count, checksum and order.
+static int run_c(const bench_opts *o, sort_fn fn, const int32_t *src, int32_t *work, int32_t *scratch,
+                 size_t n, double *t, radix_report_row *row, const radix_check_sum *ref) {
+#ifdef RADIX_PERF
+    radix_perf_sample total = { { 0 } };
+#endif
+    (void)row;
+    for (int r = -o->warmup; r < o->reps; r++) {
+        memcpy(work, src, n * sizeof(int32_t));
+#ifdef RADIX_PERF
+        radix_perf_sample before, after, d;
+        radix_perf_read_all(&before);
+#endif
+        double t0 = radix_now();
+        if (fn(o, work, scratch, n) != 0) return -1;
+        double t1 = radix_now();
+#ifdef RADIX_PERF
+        radix_perf_read_all(&after);
+        radix_perf_delta(&d, &after, &before);
+        for (int c = 0; r >= 0 && c < RADIX_PERF_COUNT; c++) total.v[c] += d.v[c];
+        radix_trace_reset();         // only the counters are wanted; keep the span lists short
+#endif
+        if (r >= 0) t[r] = t1 - t0;
+    }
+#ifdef RADIX_PERF
+    row->counter_mask = radix_perf_mask();
+    for (int c = 0; c < RADIX_PERF_COUNT; c++) row->counters[c] = (double)total.v[c] / o->reps;
+#endif
+    radix_check_sum got;
+    radix_check_sum_init(&got, RADIX_I32);
+    radix_check_sum_add(&got, work, n);
+    return radix_check_sum_compare(ref, &got) == 0 ? 0 : -1;
+}
+
+/* ---------- Python backend ---------- */
+// Runs "$PYTHON script --bench dataset ..." and reads one "time <secs>" line per timed
+// repetition. The script times its own sorts, so interpreter start-up and parsing are not included.
+static int run_python(const bench_opts *o, const char *path, int sequential, int native, double *t) {
+    char dataset[PATH_MAX];      // the script resolves relative names against the repo root
+    if (!realpath(path, dataset)) return -1;
+    int fd[2];
+    if (pipe(fd) != 0) return -1;
+    pid_t pid = fork();
+    if (pid < 0) { close(fd[0]); close(fd[1]); return -1; }
+    if (pid == 0) {
+        char reps[16], warmup[16], procs[16];
+        snprintf(reps, sizeof(reps), "%d", o->reps);
+        snprintf(warmup, sizeof(warmup), "%d", o->warmup);
+        snprintf(procs, sizeof(procs), "%d", o->threads);
+        const char *py = getenv("PYTHON") ? getenv("PYTHON") : "python3";
+        const char *engine = native ? "--native" : NULL;   // last argument, or the terminator
+        dup2(fd[1], STDOUT_FILENO);
+        close(fd[0]); close(fd[1]);
+        if (sequential)
+            execlp(py, py, o->script, "--bench", dataset, "--reps", reps, "--warmup", warmup, "--seq", engine, (char *)NULL);
+        else
+            execlp(py, py, o->script, "--bench", dataset, "--reps", reps, "--warmup", warmup,
+                   "--processes", procs, engine, (char *)NULL);
+        perror(py);
+        _exit(127);
+    }
+    close(fd[1]);
+
+    FILE *in = fdopen(fd[0], "r");
+    int got = 0;
+    char line[128];
+    while (in && fgets(line, sizeof(line), in))
+        if (got < o->reps && sscanf(line, "time %lf", &t[got]) == 1) got++;
+    if (in) fclose(in); else close(fd[0]);
+
+    int status;
+    if (waitpid(pid, &status, 0) < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0) return -1;
+    return got == o->reps ? 0 : -1;
+}
+
+/* ---------- Driver ---------- */
+typedef struct {
+    const char *name;
+    sort_fn fn;          // NULL: Python
+    int threads;         // 0: the -t value
+    int sequential;      // Python: single-process radix sort
+    int native;          // Python: the C extension sarah/radix_native.c (--native)
+    radix_scatter_kind scatter;   // C backends: LSD key scatter used while this backend runs
+    int scratch;         // C backends: sorts through the preallocated n-element scratch buffer
+} backend;
+
+static const backend BACKENDS[] = {
+    { "seq",               sort_seq,              1, 0, 0, RADIX_SCATTER_DIRECT, 1 },
+    { "seq-wc",            sort_seq,              1, 0, 0, RADIX_SCATTER_WC,     1 },
+    { "seq-inplace",       sort_seq_inplace,      1, 0, 0, RADIX_SCATTER_DIRECT, 0 },
+    { "pthreads",          sort_pthreads,         0, 0, 0, RADIX_SCATTER_DIRECT, 0 },
+    { "pthreads-wc",       sort_pthreads,         0, 0, 0, RADIX_SCATTER_WC,     0 },
+    { "pthreads-msd",      sort_pthreads_msd,     0, 0, 0, RADIX_SCATTER_DIRECT, 0 },
+    { "pthreads-inplace",  sort_pthreads_inplace, 0, 0, 0, RADIX_SCATTER_DIRECT, 0 },
+    { "auto",              sort_auto,             0, 0, 0, RADIX_SCATTER_DIRECT, 0 },
+    { "tuned",             sort_tuned,            0, 0, 0, RADIX_SCATTER_DIRECT, 0 },
+#ifdef _OPENMP
+    { "omp",               sort_omp,              0, 0, 0, RADIX_SCATTER_DIRECT, 1 },
+    { "omp-wc",            sort_omp,              0, 0, 0, RADIX_SCATTER_WC,     1 },
+    { "omp-auto",          sort_omp_auto,         0, 0, 0, RADIX_SCATTER_DIRECT, 1 },
+    { "omp-inplace",       sort_omp_inplace,      0, 0, 0, RADIX_SCATTER_DIRECT, 0 },
+#endif
+    { "python",            NULL,                  0, 0, 0, RADIX_SCATTER_DIRECT, 0 },
+    { "python-seq",        NULL,                  1, 1, 0, RADIX_SCATTER_DIRECT, 0 },
+    { "python-native",     NULL,                  0, 0, 1, RADIX_SCATTER_DIRECT, 0 },
+    { "python-native-seq", NULL,                  1, 1, 1, RADIX_SCATTER_DIRECT, 0 },
+};
+
+// Row name of an auto backend with the path it took, e.g. "auto-counting"
+static const char *path_backend_name(const char *name, radix_path path) {
+    static const char *names[2][3] = {
+        { "auto-counting", "auto-lsd", "auto-msd" },
+        { "omp-auto-counting", "omp-auto-lsd", "omp-auto-msd" },
+    };
+    return names[strcmp(name, "auto") != 0][path];
+}
+
+static const backend *find_backend(const char *name) {
+    for (size_t i = 0; i < sizeof(BACKENDS) / sizeof(BACKENDS[0]); i++)
+        if (strcmp(BACKENDS[i].name, name) == 0) return &BACKENDS[i];
+    return NULL;
+}
+
+// Measures every backend on one dataset; rows are written once the seq median is known.
+// Before each C backend the scratch buffers of the previous one are freed and the peak RSS
+// is reset, so a row's peak is the dataset, the copy being sorted and what this backend uses.
+// The Python backends run in a child process: their rows have no peak.
+static int bench_dataset(const bench_opts *opts, const backend **be, int nbe, const char *path,
+                         FILE *out, radix_report_format fmt) {
+    radix_dataset ds;
+    if (radix_dataset_open(&ds, path, RADIX_BIN_PRIVATE, opts->threads) != 0) { perror(path); return -1; }
+    size_t n = ds.stats.n;
+    bench_opts dataset_opts = *opts, *o = &dataset_opts;
+    o->min_key = n ? radix_key32(RADIX_I32, (uint32_t)ds.stats.min) : 0;
+    o->max_key = n ? radix_key32(RADIX_I32, (uint32_t)ds.stats.max) : 0;
+    int32_t *work    = malloc((n ? n : 1) * sizeof(int32_t));
+    int32_t *scratch = NULL;          // allocated for the backends that take it
+    radix_check_sum ref;              // every C backend's result is checked against it (no extra copy)
+    radix_check_sum_init(&ref, RADIX_I32);
+    radix_check_sum_add(&ref, ds.data, n);
+    double *t = malloc((size_t)o->reps * sizeof(double));
+    radix_report_row rows[MAX_BACKENDS];
+    int ok[MAX_BACKENDS], rc = 0;
+    double seq_median = 0;
+    if (!work || !t) {
+        perror("malloc");
+        free(work); free(t);
+        radix_dataset_close(&ds);
+        return -1;
+    }
+
+    for (int b = 0; b < nbe; b++) {
+        memset(&rows[b], 0, sizeof(rows[b]));
+        free(scratch);
+        scratch = NULL;
+        radix_ctx_release(o->ctx);
+        if (o->tune_ctx) radix_ctx_release(o->tune_ctx);
+        if (be[b]->scratch && !(scratch = malloc((n ? n : 1) * sizeof(int32_t)))) {
+            perror("malloc");
+            ok[b] = 0;
+            rc = -1;
+            continue;
+        }
+#ifdef __GLIBC__
+        malloc_trim(0);              // freed heap pages go back before the peak starts over
+#endif
+        radix_peak_rss_reset();
+        radix_set_scatter(be[b]->scatter);
+        int r = be[b]->fn ? run_c(o, be[b]->fn, ds.data, work, scratch, n, t, &rows[b], &ref)
+                          : run_python(o, path, be[b]->sequential, be[b]->native, t);
+        radix_set_scatter(RADIX_SCATTER_DIRECT);
+        if (be[b]->fn) rows[b].peak_rss_kb = radix_peak_rss_kb();
+        ok[b] = (r == 0);
+        if (!ok[b]) {
+            fprintf(stderr, "%s: backend %s failed or its result is not the dataset sorted\n", path, be[b]->name);
+            rc = -1;
+            continue;
+        }
+        rows[b].tool       = "radix_bench";
+        rows[b].backend    = be[b]->name;
+        rows[b].dataset    = path;
+        rows[b].n          = n;
+        rows[b].elem_bytes = sizeof(int32_t);
+        rows[b].threads    = be[b]->threads ? be[b]->threads : o->threads;
+        rows[b].bits       = be[b]->fn ? o->bits : RADIX_DECIMAL;   // the Python sort is decimal only
+        rows[b].reps       = o->reps;
+        if (be[b]->fn == sort_auto
+#ifdef _OPENMP
+            || be[b]->fn == sort_omp_auto
+#endif
+        ) {
+            double share;
+            radix_path route = radix_choose_path(ds.data, n, RADIX_I32, o->bits, o->min_key, o->max_key, &share);
+            if (route == RADIX_PATH_MSD && be[b]->fn != sort_auto) route = RADIX_PATH_LSD;
+            rows[b].backend = path_backend_name(be[b]->name, route);
+            fprintf(stderr, "%-28s %-13s picked %s (%llu key values, top digit share %.2f)\n", path,
+                    be[b]->name, radix_path_name(route), (unsigned long long)(o->max_key - o->min_key) + 1, share);
+        }
+        if (be[b]->fn == sort_tuned) {
+            const radix_tune_entry *e = radix_tune_pick(o->tune, n, radix_tune_range_bits(o->min_key, o->max_key));
+            radix_tune_backend picked = e ? e->backend : RADIX_TUNE_PTHREADS;   // as radix_tune_sort decides
+            if (n <= o->tune->seq_cutoff) picked = RADIX_TUNE_SEQ;
+            int seq = picked == RADIX_TUNE_SEQ;
+            rows[b].threads = seq ? 1 : o->tune->threads;
+            rows[b].bits    = e ? e->bits : 11;
+            fprintf(stderr, "%-28s %-13s picked %s, %d-bit digits (profile entry n <= %zu, %d-bit key range)\n",
+                    path, be[b]->name, radix_tune_backend_name(picked), rows[b].bits,
+                    e ? e->max_n : 0, e ? e->range_bits : 0);
+        }
+        radix_time_stats_compute(t, o->reps, &rows[b].t);
+        if (strcmp(be[b]->name, "seq") == 0) seq_median = rows[b].t.median;
+        fprintf(stderr, "%-28s %-13s median %.6f s  p95 %.6f s", path, be[b]->name,
+                rows[b].t.median, rows[b].t.p95);
+        if (rows[b].peak_rss_kb) fprintf(stderr, "  peak RSS %.1f MB", rows[b].peak_rss_kb / 1024.0);
+        fputc('\n', stderr);
+    }
+
+    for (int b = 0; b < nbe; b++) {
+        if (!ok[b]) continue;
+        if (seq_median > 0 && rows[b].t.median > 0) rows[b].speedup = seq_median / rows[b].t.median;
+        radix_report_write(out, fmt, &rows[b]);
+    }
+
+    free(t);
+    free(work);
+    free(scratch);
+    radix_dataset_close(&ds);
+    return rc;
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr, "Usage: %s [-k backend,...] [-r reps] [-W warmup] [-t threads] [-b 0|8|11|16]\n"
+                    "          [-f csv|json] [-o file] [-P none|compact|spread] [-u profile] [-V scalar|avx2|avx512]\n"
+                    "          [-p script.py] <dataset> ...\n"
+                    "Backends:", prog);
+    for (size_t i = 0; i < sizeof(BACKENDS) / sizeof(BACKENDS[0]); i++) fprintf(stderr, " %s", BACKENDS[i].name);
+    fprintf(stderr, "\n");
+}
+
+int main(int argc, char *argv[]) {
+    bench_opts o = { 10, 2, RADIX_CTX_DEFAULT_THREADS, 11, "sarah/sarah_multiprocessing_radix.py", NULL, NULL, NULL, 0, 0 };
+    char list[256] = "seq,pthreads";
+#ifdef _OPENMP
+    strcat(list, ",omp");
+#endif
+    radix_report_format fmt = RADIX_REPORT_CSV;
+    const char *out_path = NULL;
+    radix_pin_kind pin = RADIX_PIN_NONE;
+    radix_tune_profile tune;
+    const char *tune_path = NULL;
+    int list_given = 0;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "k:r:W:t:b:f:o:p:P:u:V:")) != -1) {
+        if (opt == 'k')      { snprintf(list, sizeof(list), "%s", optarg); list_given = 1; }
+        else if (opt == 'r') o.reps    = atoi(optarg);
+        else if (opt == 'W') o.warmup  = atoi(optarg);
+        else if (opt == 't') o.threads = atoi(optarg);
+        else if (opt == 'b') o.bits    = atoi(optarg);
+        else if (opt == 'o') out_path  = optarg;
+        else if (opt == 'p') o.script  = optarg;
+        else if (opt == 'u') tune_path = optarg;
+        else if (opt == 'V') {
+            radix_simd_kind simd;
+            if (radix_simd_parse(optarg, &simd) != 0) { fprintf(stderr, "kernels must be 'scalar', 'avx2' or 'avx512'\n"); return 1; }
+            radix_set_simd(simd);
+        }
+        else if (opt == 'P') {
+            if (radix_pin_parse(optarg, &pin) != 0) { fprintf(stderr, "pinning must be 'none', 'compact' or 'spread'\n"); return 1; }
+        }
+        else if (opt == 'f') {
+            if (radix_report_parse_format(optarg, &fmt) != 0) { fprintf(stderr, "format must be 'csv' or 'json'\n"); return 1; }
+        } else { usage(argv[0]); return 1; }
+    }
+    if (optind == argc || o.reps < 1 || o.warmup < 0 || o.threads < 1) { usage(argv[0]); return 1; }
+    if (o.bits != RADIX_DECIMAL && o.bits != 8 && o.bits != 11 && o.bits != 16) {
+        fprintf(stderr, "digit bits must be 0 (decimal), 8, 11 or 16\n");
+        return 1;
+    }
+
+#ifdef __GLIBC__
+    // Pinned, so large buffers stay mmap'ed: glibc would otherwise raise the threshold after
+    // the first free and keep later scratch buffers on the heap, raising the next rows' peak
+    mallopt(M_MMAP_THRESHOLD, 128 * 1024);
+#endif
+    fprintf(stderr, "kernels: %s (this CPU: up to %s)\n", radix_simd_name(radix_get_simd()),
+            radix_simd_name(radix_simd_detect()));
+    if (radix_peak_rss_reset() != 0)
+        fprintf(stderr, "peak RSS cannot be reset here: each row shows the peak of the run so far\n");
+
+    if (tune_path) {
+        if (radix_tune_load(tune_path, &tune) != 0) { perror(tune_path); return 1; }
+        o.tune = &tune;
+        if (!list_given) strcat(list, ",tuned");
+    }
+
+    const backend *be[MAX_BACKENDS];
+    int nbe = 0;
+    for (char *tok = strtok(list, ","); tok; tok = strtok(NULL, ",")) {
+        be[nbe] = find_backend(tok);
+        if (!be[nbe]) { fprintf(stderr, "unknown backend '%s'\n", tok); usage(argv[0]); return 1; }
+        if (be[nbe]->fn == sort_tuned && !o.tune) { fprintf(stderr, "backend 'tuned' needs -u profile\n"); return 1; }
+        if (++nbe == MAX_BACKENDS) break;
+    }
+
+    radix_ctx_config cfg;
+    radix_ctx_config_init(&cfg);
+    cfg.threads = o.threads;
+    cfg.pin     = pin;
+    o.ctx = radix_ctx_create(&cfg);
+    if (!o.ctx) { fprintf(stderr, "radix_ctx_create failed\n"); return 1; }
+    if (pin != RADIX_PIN_NONE && radix_ctx_cpu(o.ctx, 0) < 0)
+        fprintf(stderr, "CPU topology not readable: threads left unpinned\n");
+    if (o.tune) {
+        radix_tune_ctx_config(o.tune, &cfg);
+        cfg.pin = pin;
+        o.tune_ctx = radix_ctx_create(&cfg);
+        if (!o.tune_ctx) { fprintf(stderr, "radix_ctx_create failed\n"); radix_ctx_destroy(o.ctx); return 1; }
+        fprintf(stderr, "profile %s: %d threads, sequential up to n = %zu, %d entries\n", tune_path,
+                o.tune->threads, o.tune->seq_cutoff, o.tune->count);
+    }
+#ifdef _OPENMP
+    omp_set_num_threads(o.threads);
+    int cpu[o.threads];              // OpenMP threads get the same CPUs as the pool's tids
+    if (radix_topo_assign(pin, o.threads, cpu) == 0) {
+        #pragma omp parallel
+        radix_pin_self(cpu[omp_get_thread_num()]);
+    }
+#endif
+#ifdef RADIX_PERF
+    // Pool and OpenMP threads open their counters at their first traced phase (a warmup run)
+    if (radix_perf_thread_init() == 0)
+        fprintf(stderr, "hardware counters unavailable (perf_event_open refused): timing only\n");
+#endif
+
+    FILE *out = stdout;
+    if (out_path) {
+        out = radix_report_open(out_path, fmt);
+        if (!out) {
+            perror(out_path);
+            radix_ctx_destroy(o.ctx);
+            if (o.tune_ctx) radix_ctx_destroy(o.tune_ctx);
+            return 1;
+        }
+    } else {
+        radix_report_header(out, fmt);
+    }
+
+    int rc = 0;
+    for (int i = optind; i < argc; i++)
+        if (bench_dataset(&o, be, nbe, argv[i], out, fmt) != 0) rc = 1;
+
+    if (out != stdout) fclose(out);
+    radix_ctx_destroy(o.ctx);
+    if (o.tune_ctx) radix_ctx_destroy(o.tune_ctx);
+    return rc;
+}
@@ -0,0 +1,177 @@
+// radix_query.c - percentiles and top-k of an int32 dataset by radix-select, next to a full sort
+// Build: gcc -O2 -fopenmp tools/radix_query.c common/radix_core.c common/radix_ctx.c common/radix_barrier.c
+//            common/radix_topo.c common/radix_msd.c common/radix_count.c common/radix_select.c common/radix_omp.c
+//            common/radix_io.c common/radix_bin.c common/radix_report.c common/radix_check.c -o radix_query -lpthread -lm
+//        (without -fopenmp and common/radix_omp.c the omp column is left out)
+// Usage: ./radix_query [-q 50,99,99.9] [-k 1000] [-t 4] [-r 5] dataset
+//        Every answer is checked against a qsort of a copy (common/radix_check.h).
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#ifdef _OPENMP
+#include <omp.h>
+#include "../common/radix_omp.h"
+#endif
+#include "../common/radix_check.h"
+#include "../common/radix_core.h"
+#include "../common/radix_ctx.h"
+#include "../common/radix_io.h"
+#include "../common/radix_report.h"
+
+#define MAX_QUERIES 16
+
+enum { ENG_SEQ, ENG_PTHREADS, ENG_OMP, ENGINES };
+static const char *eng_name[ENGINES] = { "seq", "pthreads", "omp" };
+
+typedef struct {
+    const int32_t *a;
+    size_t n;
+    radix_ctx *ctx;
+    size_t k;            // rank (select) or count (top-k)
+    int largest;
+    int32_t *out;        // k elements for top-k, one for select
+} query;
+
+static int run_select(int eng, const query *q) {
+    if (eng == ENG_PTHREADS) return radix_ctx_select(q->ctx, q->a, q->n, RADIX_I32, q->k, q->out);
+#ifdef _OPENMP
+    if (eng == ENG_OMP) return radix_omp_select(q->a, q->n, RADIX_I32, q->k, q->out);
+#endif
+    return radix_select(q->a, q->n, RADIX_I32, q->k, q->out);
+}
+
+static int run_topk(int eng, const query *q) {
+    if (eng == ENG_PTHREADS) return radix_ctx_topk(q->ctx, q->a, q->n, RADIX_I32, q->k, q->largest, q->out);
+#ifdef _OPENMP
+    if (eng == ENG_OMP) return radix_omp_topk(q->a, q->n, RADIX_I32, q->k, q->largest, q->out);
+#endif
+    return radix_topk(q->a, q->n, RADIX_I32, q->k, q->largest, q->out);
+}
+
+// Median of reps runs of one query on one engine; -1 if it fails
+static double time_query(int (*fn)(int, const query *), int eng, const query *q, int reps) {
+    double t[reps];
+    for (int r = 0; r < reps; r++) {
+        double t0 = radix_now();
+        if (fn(eng, q) != 0) return -1;
+        t[r] = radix_now() - t0;
+    }
+    radix_time_stats s;
+    radix_time_stats_compute(t, reps, &s);
+    return s.median;
+}
+
+static int engines(void) {
+#ifdef _OPENMP
+    return ENGINES;
+#else
+    return ENG_OMP;
+#endif
+}
+
+int main(int argc, char *argv[]) {
+    double pct[MAX_QUERIES] = { 50, 99 };
+    int npct = 2, threads = 4, reps = 5;
+    size_t topk = 1000;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "q:k:t:r:")) != -1) {
+        if (opt == 'q') {
+            npct = 0;
+            for (char *s = strtok(optarg, ","); s && npct < MAX_QUERIES; s = strtok(NULL, ",")) {
+                pct[npct] = atof(s);
+                if (pct[npct] < 0 || pct[npct] > 100) { fprintf(stderr, "bad percentile '%s'\n", s); return 1; }
+                npct++;
+            }
+        } else if (opt == 'k') {
+            topk = (size_t)strtoull(optarg, NULL, 10);
+        } else if (opt == 't') {
+            threads = atoi(optarg);
+        } else if (opt == 'r') {
+            reps = atoi(optarg);
+        } else {
+            fprintf(stderr, "Usage: %s [-q 50,99,99.9] [-k 1000] [-t threads] [-r reps] <dataset>\n", argv[0]);
+            return 1;
+        }
+    }
+    if (argc - optind != 1 || threads < 1 || reps < 1) {
+        fprintf(stderr, "Usage: %s [-q 50,99,99.9] [-k 1000] [-t threads] [-r reps] <dataset>\n", argv[0]);
+        return 1;
+    }
+#ifdef _OPENMP
+    omp_set_num_threads(threads);
+#endif
+
+    radix_dataset ds;
+    if (radix_dataset_open(&ds, argv[optind], RADIX_BIN_PRIVATE, threads) != 0) { perror(argv[optind]); return 1; }
+    size_t n = ds.stats.n;
+    if (n == 0) { fprintf(stderr, "%s: no values\n", argv[optind]); radix_dataset_close(&ds); return 1; }
+    if (topk > n) topk = n;
+
+    radix_ctx_config cfg;
+    radix_ctx_config_init(&cfg);
+    cfg.threads = threads;
+    radix_ctx *ctx = radix_ctx_create(&cfg);
+    int32_t *sorted = malloc(n * sizeof(int32_t));
+    int32_t *out = malloc((topk ? topk : 1) * sizeof(int32_t));
+    if (!ctx || !sorted || !out) { fprintf(stderr, "out of memory\n"); return 1; }
+
+    // Reference: what the jobs did before - sort a copy, then read the ranks
+    double sort_t[reps];
+    for (int r = 0; r < reps; r++) {
+        double t0 = radix_now();
+        memcpy(sorted, ds.data, n * sizeof(int32_t));
+        radix_ctx_sort(ctx, sorted, n, RADIX_I32, 11);
+        sort_t[r] = radix_now() - t0;
+    }
+    radix_time_stats sort_s;
+    radix_time_stats_compute(sort_t, reps, &sort_s);
+    printf("Dataset: %s (%zu values, %d threads)\n", argv[optind], n, threads);
+    printf("  copy + pthreads sort: %.6f s\n", sort_s.median);
+
+    // The answers are checked against qsort, not against the radix sort timed above
+    int bad = 0;
+    int32_t *ref = malloc(n * sizeof(int32_t));
+    if (!ref) { fprintf(stderr, "out of memory\n"); return 1; }
+    memcpy(ref, ds.data, n * sizeof(int32_t));
+    radix_check_qsort(ref, n, RADIX_I32);
+    if (memcmp(ref, sorted, n * sizeof(int32_t)) != 0) bad++;
+    free(sorted);
+    sorted = ref;
+    query q = { ds.data, n, ctx, 0, 0, out };
+    for (int i = 0; i < npct; i++) {
+        // Nearest rank: the ceil(p% of n)-th smallest
+        size_t rank = (size_t)ceil(pct[i] / 100.0 * (double)n);
+        q.k = rank ? rank - 1 : 0;
+        printf("  p%-6g = %-11d", pct[i], (int)sorted[q.k]);
+        for (int e = 0; e < engines(); e++) {
+            double t = time_query(run_select, e, &q, reps);
+            if (t < 0 || out[0] != sorted[q.k]) bad++;
+            printf("  %s %.6f s", eng_name[e], t < 0 ? 0 : t);
+        }
+        printf("\n");
+    }
+
+    q.k = topk;
+    for (int largest = 0; largest <= 1 && topk > 0; largest++) {
+        q.largest = largest;
+        printf("  %s %-8zu", largest ? "top   " : "bottom", topk);
+        for (int e = 0; e < engines(); e++) {
+            double t = time_query(run_topk, e, &q, reps);
+            for (size_t i = 0; i < topk; i++)
+                if (out[i] != sorted[largest ? n - 1 - i : i]) { bad++; break; }
+            printf("  %s %.6f s", eng_name[e], t < 0 ? 0 : t);
+            if (t < 0) bad++;
+        }
+        printf("\n");
+    }
+
+    free(sorted);
+    free(out);
+    radix_ctx_destroy(ctx);
+    radix_dataset_close(&ds);
+    if (bad) { fprintf(stderr, "%d results disagree with qsort\n", bad); return 1; }
+    return 0;
+}
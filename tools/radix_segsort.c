@@ -0,0 +1,156 @@
+// radix_segsort.c - many small independent arrays sorted in one call, in segments per second
+// Build: gcc -O2 -fopenmp tools/radix_segsort.c common/radix_core.c common/radix_ctx.c common/radix_barrier.c
+//            common/radix_topo.c common/radix_msd.c common/radix_segments.c common/radix_omp.c
+//            common/radix_io.c common/radix_bin.c common/radix_report.c common/radix_check.c -o radix_segsort -lpthread
+//        (without -fopenmp and common/radix_omp.c the omp row is left out)
+// Usage: ./radix_segsort [-n 100000] [-s 20-2000] [-t 4] [-b 8] [-r 5] [dataset]
+//        Segment lengths are drawn evenly from -s. With a dataset its values are cut into such
+//        segments (as many as fit); without one, -n segments of random ints are generated.
+//        Every engine's result is compared with qsort of each segment (common/radix_check.h).
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#ifdef _OPENMP
+#include <omp.h>
+#include "../common/radix_omp.h"
+#endif
+#include "../common/radix_check.h"
+#include "../common/radix_core.h"
+#include "../common/radix_ctx.h"
+#include "../common/radix_io.h"
+#include "../common/radix_report.h"
+
+enum { ENG_CALLS, ENG_SEQ, ENG_PTHREADS, ENG_OMP, ENGINES };
+static const char *eng_name[ENGINES] = { "one call each", "seq", "pthreads", "omp" };
+
+static uint64_t rng_state = 0x9E3779B97F4A7C15ull;   // fixed seed: the same segments every run
+static uint64_t rng(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return rng_state;
+}
+
+static int run(int eng, radix_ctx *ctx, int32_t *a, const size_t *off, size_t segs, int bits) {
+    if (eng == ENG_CALLS) {          // what the callers did before: radix_sort per array
+        for (size_t i = 0; i < segs; i++)
+            if (radix_sort(a + off[i], off[i + 1] - off[i], RADIX_I32, bits) != 0) return -1;
+        return 0;
+    }
+    if (eng == ENG_PTHREADS) return radix_ctx_sort_segments(ctx, a, off, segs, RADIX_I32, bits);
+#ifdef _OPENMP
+    if (eng == ENG_OMP) return radix_omp_sort_segments(a, off, segs, RADIX_I32, bits);
+#endif
+    return radix_sort_segments(a, off, segs, RADIX_I32, bits);
+}
+
+int main(int argc, char *argv[]) {
+    size_t segs = 100000, min_len = 20, max_len = 2000;
+    int threads = 4, bits = 8, reps = 5;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "n:s:t:b:r:")) != -1) {
+        if (opt == 'n') {
+            segs = (size_t)strtoull(optarg, NULL, 10);
+        } else if (opt == 's') {
+            if (sscanf(optarg, "%zu-%zu", &min_len, &max_len) != 2 || min_len > max_len) {
+                fprintf(stderr, "bad segment lengths '%s' (want min-max)\n", optarg);
+                return 1;
+            }
+        } else if (opt == 't') {
+            threads = atoi(optarg);
+        } else if (opt == 'b') {
+            bits = atoi(optarg);
+        } else if (opt == 'r') {
+            reps = atoi(optarg);
+        } else {
+            fprintf(stderr, "Usage: %s [-n segments] [-s min-max] [-t threads] [-b 0|8|11|16] [-r reps] [dataset]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (argc - optind > 1 || threads < 1 || reps < 1) {
+        fprintf(stderr, "Usage: %s [-n segments] [-s min-max] [-t threads] [-b 0|8|11|16] [-r reps] [dataset]\n", argv[0]);
+        return 1;
+    }
+#ifdef _OPENMP
+    omp_set_num_threads(threads);
+#endif
+
+    // Segment lengths, then the values: the dataset's, or random ones
+    radix_dataset ds;
+    size_t avail = SIZE_MAX;
+    const char *name = "random";
+    if (optind < argc) {
+        name = argv[optind];
+        if (radix_dataset_open(&ds, name, RADIX_BIN_PRIVATE, threads) != 0) { perror(name); return 1; }
+        avail = ds.stats.n;
+        segs = SIZE_MAX;
+    }
+    size_t cap = 1024, n = 0;
+    size_t *off = malloc(cap * sizeof(size_t));
+    off[0] = 0;
+    size_t count = 0;
+    while (count < segs && off) {
+        size_t len = min_len + (size_t)(rng() % (max_len - min_len + 1));
+        if (n + len > avail) break;
+        if (count + 2 > cap && !(off = realloc(off, (cap *= 2) * sizeof(size_t)))) break;
+        n += len;
+        off[++count] = n;
+    }
+    segs = count;
+    int32_t *src  = malloc((n ? n : 1) * sizeof(int32_t));
+    int32_t *ref  = malloc((n ? n : 1) * sizeof(int32_t));
+    int32_t *work = malloc((n ? n : 1) * sizeof(int32_t));
+    radix_ctx_config cfg;
+    radix_ctx_config_init(&cfg);
+    cfg.threads = threads;
+    radix_ctx *ctx = radix_ctx_create(&cfg);
+    if (!off || !src || !ref || !work || !ctx) { fprintf(stderr, "out of memory\n"); return 1; }
+    if (avail != SIZE_MAX) {
+        memcpy(src, ds.data, n * sizeof(int32_t));
+        radix_dataset_close(&ds);
+    } else {
+        for (size_t i = 0; i < n; i++) src[i] = (int32_t)rng();
+    }
+
+    printf("Dataset: %s (%zu segments of %zu-%zu values, %zu values, %d threads, %d-bit digits)\n",
+           name, segs, min_len, max_len, n, threads, bits);
+    int engines = ENGINES;
+#ifndef _OPENMP
+    engines = ENG_OMP;
+#endif
+    double base = 0;
+    int bad = 0;
+    double t[reps];
+    for (int e = 0; e < engines; e++) {
+        for (int r = 0; r < reps; r++) {
+            memcpy(work, src, n * sizeof(int32_t));
+            double t0 = radix_now();
+            if (run(e, ctx, work, off, segs, bits) != 0) { fprintf(stderr, "%s failed\n", eng_name[e]); return 1; }
+            t[r] = radix_now() - t0;
+        }
+        if (e == ENG_CALLS) memcpy(ref, work, n * sizeof(int32_t));
+        else if (memcmp(ref, work, n * sizeof(int32_t)) != 0) bad++;
+        radix_time_stats s;
+        radix_time_stats_compute(t, reps, &s);
+        if (e == ENG_CALLS) base = s.median;
+        printf("  %-14s %.6f s  %12.0f segments/s  %8.1f M values/s  x%.2f\n", eng_name[e], s.median,
+               s.median > 0 ? (double)segs / s.median : 0, s.median > 0 ? (double)n / s.median / 1e6 : 0,
+               s.median > 0 ? base / s.median : 0);
+    }
+
+    // Reference: every segment of the input sorted by qsort
+    memcpy(work, src, n * sizeof(int32_t));
+    for (size_t i = 0; i < segs; i++)
+        radix_check_qsort(work + off[i], off[i + 1] - off[i], RADIX_I32);
+    if (memcmp(ref, work, n * sizeof(int32_t)) != 0) bad++;
+
+    free(off);
+    free(src);
+    free(ref);
+    free(work);
+    radix_ctx_destroy(ctx);
+    if (bad) { fprintf(stderr, "segments differ from qsort or engines disagree\n"); return 1; }
+    return 0;
+}
@@ -0,0 +1,111 @@
+// radix_stream.c - sorts decimal int32 text from a file or stdin into a file or stdout, reading,
+// sorting and writing at the same time (common/radix_stream.h)
+// Build: gcc -O2 tools/radix_stream.c common/radix_stream.c common/radix_core.c common/radix_ctx.c
+//            common/radix_barrier.c common/radix_topo.c common/radix_msd.c common/radix_segments.c
+//            common/radix_io.c common/radix_bin.c common/radix_check.c -o radix_stream -lpthread
+// Usage: ./radix_stream [-t 4] [-b 11] [-B 8M] [-f text|bin] [-o output] [input]
+//        Without input the values come from stdin, without -o the result goes to stdout.
+//        Timings go to stderr. With an input file and -o, the output is read back and
+//        compared with a qsort of the input (common/radix_check.h).
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "../common/radix_check.h"
+#include "../common/radix_io.h"
+#include "../common/radix_stream.h"
+
+// "4096", "64K", "256M", "2G" -> bytes (0 on a malformed value)
+static size_t parse_size(const char *s) {
+    char *end;
+    unsigned long long v = strtoull(s, &end, 10);
+    if (end == s) return 0;
+    if (*end == 'K' || *end == 'k') { v <<= 10; end++; }
+    else if (*end == 'M' || *end == 'm') { v <<= 20; end++; }
+    else if (*end == 'G' || *end == 'g') { v <<= 30; end++; }
+    return *end ? 0 : (size_t)v;
+}
+
+// Loads both files and compares them with radix_check_sorted. 0 if the output is the input
+// sorted, 1 if not, -1 if a file could not be read or there is no memory for the check.
+static int check_output(const char *in_path, const char *out_path, int threads) {
+    radix_dataset in, out;
+    if (radix_dataset_open(&in, in_path, RADIX_BIN_PRIVATE, threads) != 0) { perror(in_path); return -1; }
+    if (radix_dataset_open(&out, out_path, RADIX_BIN_PRIVATE, threads) != 0) {
+        perror(out_path);
+        radix_dataset_close(&in);
+        return -1;
+    }
+    int differ = out.stats.n != in.stats.n ? 1 : radix_check_sorted(in.data, out.data, in.stats.n, RADIX_I32);
+    if (differ < 0) perror("check");
+    radix_dataset_close(&out);
+    radix_dataset_close(&in);
+    return differ;
+}
+
+int main(int argc, char *argv[]) {
+    radix_stream_config cfg;
+    radix_stream_config_init(&cfg);
+    const char *out_path = NULL;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "t:b:B:f:o:")) != -1) {
+        if (opt == 't') {
+            cfg.threads = atoi(optarg);
+        } else if (opt == 'b') {
+            cfg.bits = atoi(optarg);
+        } else if (opt == 'B') {
+            cfg.block_bytes = parse_size(optarg);
+            if (cfg.block_bytes == 0) { fprintf(stderr, "bad block size '%s'\n", optarg); return 1; }
+        } else if (opt == 'f') {
+            if (strcmp(optarg, "text") == 0)     cfg.out_format = RADIX_STREAM_TEXT;
+            else if (strcmp(optarg, "bin") == 0) cfg.out_format = RADIX_STREAM_BIN;
+            else { fprintf(stderr, "bad output format '%s' (want text or bin)\n", optarg); return 1; }
+        } else if (opt == 'o') {
+            out_path = optarg;
+        } else {
+            fprintf(stderr, "Usage: %s [-t threads] [-b 0|8|11|16] [-B block] [-f text|bin] [-o output] [input]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (argc - optind > 1 || cfg.threads < 1) {
+        fprintf(stderr, "Usage: %s [-t threads] [-b 0|8|11|16] [-B block] [-f text|bin] [-o output] [input]\n", argv[0]);
+        return 1;
+    }
+
+    int in_fd = 0, out_fd = 1;
+    const char *in_path = NULL;
+    if (optind < argc && strcmp(argv[optind], "-") != 0) {
+        in_path = argv[optind];
+        in_fd = open(argv[optind], O_RDONLY);
+        if (in_fd < 0) { perror(argv[optind]); return 1; }
+    }
+    if (out_path && strcmp(out_path, "-") != 0) {
+        out_fd = open(out_path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (out_fd < 0) { perror(out_path); return 1; }
+    }
+
+    radix_stream_stats st;
+    if (radix_stream_sort(in_fd, out_fd, &cfg, &st) != 0) { perror("radix_stream_sort"); return 1; }
+    if (out_fd != 1 && close(out_fd) != 0) { perror(out_path); return 1; }
+    if (in_fd != 0) close(in_fd);
+
+    // read / write: time the I/O threads spent in the system calls; the closer the total
+    // gets to their sum, the less of the sort is left outside the I/O
+    fprintf(stderr, "Sorted %zu values (%zu blocks, %zu bytes in, %zu bytes out, %d threads)\n",
+            st.count, st.blocks, st.in_bytes, st.out_bytes, cfg.threads);
+    fprintf(stderr, "  input  %.6f s   partition %.6f s   output %.6f s   total %.6f s\n",
+            st.input_secs, st.partition_secs, st.output_secs, st.total_secs);
+    fprintf(stderr, "  read   %.6f s   write     %.6f s   I/O share %.0f%%\n", st.read_secs, st.write_secs,
+            st.total_secs > 0 ? 100.0 * (st.read_secs + st.write_secs) / st.total_secs : 0);
+
+    // A pipe cannot be read a second time, so only file to file runs are checked
+    if (in_path && out_fd != 1) {
+        int r = check_output(in_path, out_path, cfg.threads);
+        if (r < 0) return 1;
+        if (r) { fprintf(stderr, "%s: output differs from qsort of the input\n", out_path); return 1; }
+        fprintf(stderr, "  output matches qsort of the input\n");
+    }
+    return 0;
+}
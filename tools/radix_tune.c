@@ -0,0 +1,206 @@
+// radix_tune.c - calibrates the engines on this machine and writes a tuning profile (common/radix_tune.h)
+// Build: gcc -O2 -fopenmp tools/radix_tune.c common/radix_tune.c common/radix_report.c common/radix_core.c
+//            common/radix_ctx.c common/radix_barrier.c common/radix_topo.c common/radix_omp.c
+//            -o radix_tune -lpthread
+//        (without -fopenmp and common/radix_omp.c the omp backend is not calibrated)
+// Usage: ./radix_tune [-o radix_tune.profile] [-n 4M] [-r 3] [-t max_threads]
+//
+// 1. Thread count: the pool with 11-bit digits on the largest size, full-range keys, for
+//    2, 4, 8, ... threads up to the usable CPUs (-t); the fastest one is kept.
+// 2. For every size class (256, 1K, 4K, ... up to -n) and key range (8, 16, 24, 32 bits):
+//    seq, pthreads and omp with 8, 11 and 16-bit digits; the fastest median is the entry.
+// 3. seq_cutoff: the largest size up to which the sequential core won every smaller class
+//    on full-range keys.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#ifdef _OPENMP
+#include <omp.h>
+#include "../common/radix_omp.h"
+#endif
+#include "../common/radix_core.h"
+#include "../common/radix_ctx.h"
+#include "../common/radix_report.h"
+#include "../common/radix_topo.h"
+#include "../common/radix_tune.h"
+
+#define MAX_SIZES 16
+
+static const int RANGES[] = { 8, 16, 24, 32 };
+static const int BITS[]   = { 8, 11, 16 };
+#define NRANGES ((int)(sizeof(RANGES) / sizeof(RANGES[0])))
+#define NBITS   ((int)(sizeof(BITS) / sizeof(BITS[0])))
+
+typedef struct {
+    int reps;
+    int threads;
+    radix_ctx *ctx;          // pool with seq_cutoff 0, so small sizes really run on it
+    int32_t *src, *work, *scratch;
+} tune_state;
+
+// "4096", "64K", "4M" -> count (0 on a malformed value)
+static size_t parse_count(const char *s) {
+    char *end;
+    unsigned long long v = strtoull(s, &end, 10);
+    if (end == s) return 0;
+    if (*end == 'K' || *end == 'k') { v <<= 10; end++; }
+    else if (*end == 'M' || *end == 'm') { v <<= 20; end++; }
+    return *end ? 0 : (size_t)v;
+}
+
+// n values spanning the low 'range' bits (non-negative, so the keys differ in exactly those bits)
+static void fill(int32_t *a, size_t n, int range) {
+    uint64_t x = 0x9E3779B97F4A7C15ull ^ (uint64_t)range;
+    uint32_t mask = range >= 32 ? 0xFFFFFFFFu : (1u << range) - 1;
+    for (size_t i = 0; i < n; i++) {
+        x ^= x << 13; x ^= x >> 7; x ^= x << 17;
+        a[i] = (int32_t)((uint32_t)x & mask);
+    }
+}
+
+static int run_one(tune_state *s, radix_tune_backend backend, size_t n, int bits) {
+    switch (backend) {
+    case RADIX_TUNE_SEQ:      return radix_sort_scratch(s->work, s->scratch, n, RADIX_I32, bits);
+    case RADIX_TUNE_PTHREADS: return radix_ctx_sort(s->ctx, s->work, n, RADIX_I32, bits);
+#ifdef _OPENMP
+    case RADIX_TUNE_OMP:      return radix_omp_sort_scratch(s->work, s->scratch, n, RADIX_I32, bits);
+#endif
+    default:                  return -1;
+    }
+}
+
+// Median seconds per sort of src[0, n). Small sizes repeat the sort inside one sample
+// (each on a fresh copy, the copies not timed) so a sample is not just timer noise.
+static double measure(tune_state *s, radix_tune_backend backend, size_t n, int bits) {
+    int inner = n >= 65536 ? 1 : (int)(65536 / n);
+    double t[s->reps];
+    for (int r = -1; r < s->reps; r++) {         // r = -1: warmup
+        double sum = 0;
+        for (int k = 0; k < inner; k++) {
+            memcpy(s->work, s->src, n * sizeof(int32_t));
+            double t0 = radix_now();
+            if (run_one(s, backend, n, bits) != 0) return -1;
+            sum += radix_now() - t0;
+        }
+        if (r >= 0) t[r] = sum / inner;
+    }
+    for (size_t i = 1; i < n; i++)
+        if (s->work[i - 1] > s->work[i]) return -1;
+    radix_time_stats st;
+    radix_time_stats_compute(t, s->reps, &st);
+    return st.median;
+}
+
+static int make_ctx(tune_state *s, int threads) {
+    radix_ctx_config cfg;
+    radix_ctx_config_init(&cfg);
+    cfg.threads = threads;
+    cfg.seq_cutoff = 0;
+    if (s->ctx) radix_ctx_destroy(s->ctx);
+    s->ctx = radix_ctx_create(&cfg);
+    s->threads = threads;
+#ifdef _OPENMP
+    omp_set_num_threads(threads);
+#endif
+    return s->ctx ? 0 : -1;
+}
+
+int main(int argc, char *argv[]) {
+    const char *out_path = RADIX_TUNE_DEFAULT_PATH;
+    size_t max_n = (size_t)4 << 20;
+    int reps = 3, max_threads = radix_topo_cpus();
+
+    int opt;
+    while ((opt = getopt(argc, argv, "o:n:r:t:")) != -1) {
+        if (opt == 'o')      out_path = optarg;
+        else if (opt == 'n') max_n = parse_count(optarg);
+        else if (opt == 'r') reps = atoi(optarg);
+        else if (opt == 't') max_threads = atoi(optarg);
+        else {
+            fprintf(stderr, "Usage: %s [-o %s] [-n 4M] [-r 3] [-t max_threads]\n", argv[0], RADIX_TUNE_DEFAULT_PATH);
+            return 1;
+        }
+    }
+    if (max_n < 256 || reps < 1 || max_threads < 1) {
+        fprintf(stderr, "need -n >= 256, -r >= 1 and -t >= 1\n");
+        return 1;
+    }
+
+    size_t sizes[MAX_SIZES];
+    int nsizes = 0;
+    for (size_t n = 256; n <= max_n && nsizes < MAX_SIZES; n *= 4) sizes[nsizes++] = n;
+    max_n = sizes[nsizes - 1];
+
+    tune_state s = { reps, 1, NULL, malloc(max_n * sizeof(int32_t)), malloc(max_n * sizeof(int32_t)),
+                     malloc(max_n * sizeof(int32_t)) };
+    if (!s.src || !s.work || !s.scratch) { perror("malloc"); return 1; }
+
+    radix_tune_profile p;
+    memset(&p, 0, sizeof(p));
+    p.cpus = radix_topo_cpus();
+
+    // 1. Thread count
+    int best_threads = 1;
+    if (max_threads > 1) {
+        int cand[32], ncand = 0;
+        for (int t = 2; t < max_threads && ncand < 31; t *= 2) cand[ncand++] = t;
+        cand[ncand++] = max_threads;
+        double best = 0;
+        fill(s.src, max_n, 32);
+        for (int c = 0; c < ncand; c++) {
+            if (make_ctx(&s, cand[c]) != 0) break;
+            double secs = measure(&s, RADIX_TUNE_PTHREADS, max_n, 11);
+            printf("threads %-3d n=%zu: %.6f s\n", cand[c], max_n, secs);
+            if (secs >= 0 && (best == 0 || secs < best)) { best = secs; best_threads = cand[c]; }
+        }
+    }
+    if (make_ctx(&s, best_threads) != 0) { fprintf(stderr, "radix_ctx_create failed\n"); return 1; }
+    p.threads = best_threads;
+    printf("threads: %d (of %d CPUs)%s\n", best_threads, p.cpus,
+           best_threads == 1 ? " - parallel backends not calibrated" : "");
+
+    // 2. Entries
+    radix_tune_backend backends[3];
+    int nbackends = 0;
+    backends[nbackends++] = RADIX_TUNE_SEQ;
+    if (best_threads > 1) {
+        backends[nbackends++] = RADIX_TUNE_PTHREADS;
+#ifdef _OPENMP
+        backends[nbackends++] = RADIX_TUNE_OMP;
+#endif
+    }
+    int seq_run = 1;
+    for (int i = 0; i < nsizes; i++) {
+        for (int r = 0; r < NRANGES; r++) {
+            radix_tune_entry *e = &p.entry[p.count++];
+            e->max_n = sizes[i];
+            e->range_bits = RANGES[r];
+            e->secs = 0;
+            fill(s.src, sizes[i], RANGES[r]);
+            for (int b = 0; b < nbackends; b++)
+                for (int k = 0; k < NBITS; k++) {
+                    double secs = measure(&s, backends[b], sizes[i], BITS[k]);
+                    if (secs < 0) {
+                        fprintf(stderr, "%s with %d-bit digits failed\n", radix_tune_backend_name(backends[b]), BITS[k]);
+                        return 1;
+                    }
+                    if (e->secs == 0 || secs < e->secs) { e->secs = secs; e->backend = backends[b]; e->bits = BITS[k]; }
+                }
+            printf("n=%-9zu range %2d bits: %-8s %2d-bit digits  %.6f s\n", e->max_n, e->range_bits,
+                   radix_tune_backend_name(e->backend), e->bits, e->secs);
+            // 3. Cutoff follows the full-range winners
+            if (RANGES[r] == 32 && seq_run) {
+                if (e->backend == RADIX_TUNE_SEQ) p.seq_cutoff = sizes[i];
+                else seq_run = 0;
+            }
+        }
+    }
+    printf("seq_cutoff: %zu\n", p.seq_cutoff);
+
+    radix_ctx_destroy(s.ctx);
+    free(s.src); free(s.work); free(s.scratch);
+    if (radix_tune_save(out_path, &p) != 0) { perror(out_path); return 1; }
+    printf("profile written to %s\n", out_path);
+    return 0;
+}
@@ -0,0 +1,32 @@
+// txt2bin.c - converts a whitespace-separated integer dataset to the binary format (common/radix_bin.h)
+// Build: gcc -O2 tools/txt2bin.c common/radix_io.c common/radix_bin.c -o txt2bin -lpthread
+// Usage: ./txt2bin input_mixed_1000000.txt input_mixed_1000000.bin
+#include <stdio.h>
+#include <stdlib.h>
+#include "../common/radix_io.h"
+#include "../common/radix_bin.h"
+
+int main(int argc, char *argv[]) {
+    if (argc != 3) {
+        fprintf(stderr, "Usage: %s <input.txt> <output.bin>\n", argv[0]);
+        return 1;
+    }
+
+    radix_load_stats st;
+    int32_t *arr = radix_load_i32(argv[1], 0, &st);
+    if (!arr) { perror(argv[1]); return 1; }
+
+    // Raw bits of the bounds, zero-extended as the header expects
+    uint64_t minmax[2] = { (uint32_t)st.min, (uint32_t)st.max };
+    if (radix_bin_write(argv[2], RADIX_I32, arr, st.n, st.n ? minmax : NULL) != 0) {
+        perror(argv[2]);
+        free(arr);
+        return 1;
+    }
+
+    printf("%s: %zu integers", argv[2], st.n);
+    if (st.n) printf(", min %d, max %d", st.min, st.max);
+    printf("\n");
+    free(arr);
+    return 0;
+}